@@ -0,0 +1,119 @@
+/**
+ * @file crc.c
+ * @brief Implementação por tabela dos CRCs do SHT4x e do MS5637
+ *
+ * As duas rotinas seguem o laço bit a bit dos datasheets: deslocamento à
+ * esquerda com o polinômio aplicado quando o bit mais alto sai em 1. Como a
+ * operação é linear, oito passos equivalem a R' = (R << 8) ^ T[bits altos de R],
+ * e quatro passos a R' = (R << 4) ^ T[nibble alto de R]; as tabelas abaixo são
+ * esses passos pré-calculados.
+ */
+
+#include "crc.h"
+
+#if !CRC_NIBBLE_TABLES
+
+// crc8_table[i] = 8 passos do CRC-8/0x31 a partir de i
+static const uint8_t crc8_table[256] = {
+    0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97, 0xB9, 0x88, 0xDB, 0xEA,
+    0x7D, 0x4C, 0x1F, 0x2E, 0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4,
+    0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F, 0x5C, 0x6D, 0x86, 0xB7, 0xE4, 0xD5,
+    0x42, 0x73, 0x20, 0x11, 0x3F, 0x0E, 0x5D, 0x6C, 0xFB, 0xCA, 0x99, 0xA8,
+    0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52, 0x7C, 0x4D, 0x1E, 0x2F,
+    0xB8, 0x89, 0xDA, 0xEB, 0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA,
+    0x84, 0xB5, 0xE6, 0xD7, 0x40, 0x71, 0x22, 0x13, 0x7E, 0x4F, 0x1C, 0x2D,
+    0xBA, 0x8B, 0xD8, 0xE9, 0xC7, 0xF6, 0xA5, 0x94, 0x03, 0x32, 0x61, 0x50,
+    0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C, 0x02, 0x33, 0x60, 0x51,
+    0xC6, 0xF7, 0xA4, 0x95, 0xF8, 0xC9, 0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F,
+    0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6, 0x7A, 0x4B, 0x18, 0x29,
+    0xBE, 0x8F, 0xDC, 0xED, 0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54,
+    0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC, 0x9F, 0xAE, 0x80, 0xB1, 0xE2, 0xD3,
+    0x44, 0x75, 0x26, 0x17, 0xFC, 0xCD, 0x9E, 0xAF, 0x38, 0x09, 0x5A, 0x6B,
+    0x45, 0x74, 0x27, 0x16, 0x81, 0xB0, 0xE3, 0xD2, 0xBF, 0x8E, 0xDD, 0xEC,
+    0x7B, 0x4A, 0x19, 0x28, 0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3, 0xA0, 0x91,
+    0x47, 0x76, 0x25, 0x14, 0x83, 0xB2, 0xE1, 0xD0, 0xFE, 0xCF, 0x9C, 0xAD,
+    0x3A, 0x0B, 0x58, 0x69, 0x04, 0x35, 0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93,
+    0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A, 0xC1, 0xF0, 0xA3, 0x92,
+    0x05, 0x34, 0x67, 0x56, 0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF,
+    0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24, 0x15, 0x3B, 0x0A, 0x59, 0x68,
+    0xFF, 0xCE, 0x9D, 0xAC,
+};
+
+// crc4_table[i] = 8 passos do registrador de 16 bits do CRC-4 (0x3000) a partir
+// de i << 8. O polinômio só tem bits em 12..13, então o resultado só ocupa os
+// bits 12..15 e a tabela guarda apenas esse nibble
+static const uint8_t crc4_table[256] = {
+    0x0, 0x3, 0x6, 0x5, 0xC, 0xF, 0xA, 0x9, 0xB, 0x8, 0xD, 0xE, 0x7, 0x4, 0x1, 0x2,
+    0x5, 0x6, 0x3, 0x0, 0x9, 0xA, 0xF, 0xC, 0xE, 0xD, 0x8, 0xB, 0x2, 0x1, 0x4, 0x7,
+    0xA, 0x9, 0xC, 0xF, 0x6, 0x5, 0x0, 0x3, 0x1, 0x2, 0x7, 0x4, 0xD, 0xE, 0xB, 0x8,
+    0xF, 0xC, 0x9, 0xA, 0x3, 0x0, 0x5, 0x6, 0x4, 0x7, 0x2, 0x1, 0x8, 0xB, 0xE, 0xD,
+    0x7, 0x4, 0x1, 0x2, 0xB, 0x8, 0xD, 0xE, 0xC, 0xF, 0xA, 0x9, 0x0, 0x3, 0x6, 0x5,
+    0x2, 0x1, 0x4, 0x7, 0xE, 0xD, 0x8, 0xB, 0x9, 0xA, 0xF, 0xC, 0x5, 0x6, 0x3, 0x0,
+    0xD, 0xE, 0xB, 0x8, 0x1, 0x2, 0x7, 0x4, 0x6, 0x5, 0x0, 0x3, 0xA, 0x9, 0xC, 0xF,
+    0x8, 0xB, 0xE, 0xD, 0x4, 0x7, 0x2, 0x1, 0x3, 0x0, 0x5, 0x6, 0xF, 0xC, 0x9, 0xA,
+    0xE, 0xD, 0x8, 0xB, 0x2, 0x1, 0x4, 0x7, 0x5, 0x6, 0x3, 0x0, 0x9, 0xA, 0xF, 0xC,
+    0xB, 0x8, 0xD, 0xE, 0x7, 0x4, 0x1, 0x2, 0x0, 0x3, 0x6, 0x5, 0xC, 0xF, 0xA, 0x9,
+    0x4, 0x7, 0x2, 0x1, 0x8, 0xB, 0xE, 0xD, 0xF, 0xC, 0x9, 0xA, 0x3, 0x0, 0x5, 0x6,
+    0x1, 0x2, 0x7, 0x4, 0xD, 0xE, 0xB, 0x8, 0xA, 0x9, 0xC, 0xF, 0x6, 0x5, 0x0, 0x3,
+    0x9, 0xA, 0xF, 0xC, 0x5, 0x6, 0x3, 0x0, 0x2, 0x1, 0x4, 0x7, 0xE, 0xD, 0x8, 0xB,
+    0xC, 0xF, 0xA, 0x9, 0x0, 0x3, 0x6, 0x5, 0x7, 0x4, 0x1, 0x2, 0xB, 0x8, 0xD, 0xE,
+    0x3, 0x0, 0x5, 0x6, 0xF, 0xC, 0x9, 0xA, 0x8, 0xB, 0xE, 0xD, 0x4, 0x7, 0x2, 0x1,
+    0x6, 0x5, 0x0, 0x3, 0xA, 0x9, 0xC, 0xF, 0xD, 0xE, 0xB, 0x8, 0x1, 0x2, 0x7, 0x4,
+};
+
+#else
+
+// crc8_table[i] = 4 passos do CRC-8/0x31 a partir de i << 4
+static const uint8_t crc8_table[16] = {
+    0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97,
+    0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E,
+};
+
+// crc4_table[i] = 4 passos do registrador de 16 bits do CRC-4 (0x3000) a partir
+// de i << 12, também guardando só o nibble alto
+static const uint8_t crc4_table[16] = {
+    0x0, 0x3, 0x6, 0x5, 0xC, 0xF, 0xA, 0x9, 0xB, 0x8, 0xD, 0xE, 0x7, 0x4, 0x1, 0x2,
+};
+
+#endif
+
+// CRC-8 Sensirion de um buffer
+uint8_t crc8_sensirion(const uint8_t *data, size_t len) {
+    uint8_t crc = CRC8_SENSIRION_INIT;
+    for (size_t i = 0; i < len; i++) {
+#if !CRC_NIBBLE_TABLES
+        crc = crc8_table[crc ^ data[i]];
+#else
+        crc ^= data[i];
+        crc = (uint8_t)(crc << 4) ^ crc8_table[crc >> 4];
+        crc = (uint8_t)(crc << 4) ^ crc8_table[crc >> 4];
+#endif
+    }
+    return crc;
+}
+
+// Um byte no registrador do CRC-4: o byte entra nos 8 bits baixos (AN520)
+static inline uint16_t crc4_byte(uint16_t rem, uint8_t byte) {
+    rem ^= byte;
+#if !CRC_NIBBLE_TABLES
+    return (uint16_t)(rem << 8) ^ (uint16_t)(crc4_table[rem >> 8] << 12);
+#else
+    rem = (uint16_t)(rem << 4) ^ (uint16_t)(crc4_table[rem >> 12] << 12);
+    return (uint16_t)(rem << 4) ^ (uint16_t)(crc4_table[rem >> 12] << 12);
+#endif
+}
+
+// CRC-4 da PROM do MS5637, sem alterar o array de entrada
+uint8_t crc4_ms5637(const uint16_t prom[8]) {
+    uint16_t rem = 0;
+    for (int i = 0; i < 8; i++) {
+        uint16_t word = prom[i];
+        if (i == 0)
+            word &= 0x0FFF; // o próprio CRC fica fora do cálculo
+        else if (i == 7)
+            word = 0;       // palavra reservada entra como zero
+        rem = crc4_byte(rem, word >> 8);
+        rem = crc4_byte(rem, word & 0xFF);
+    }
+    return (rem >> 12) & 0xF;
+}
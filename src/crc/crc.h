@@ -0,0 +1,46 @@
+/**
+ * @file crc.h
+ * @brief CRCs dos sensores da placa, por tabela e sem alterar os dados de entrada
+ *
+ * - CRC-8 Sensirion (SHT4x): polinômio 0x31, valor inicial 0xFF, sem reflexão
+ *   nem XOR final, aplicado a cada palavra de 2 bytes das respostas.
+ * - CRC-4 da PROM do MS5637 (AN520): 4 bits altos da PROM[0], calculado sobre
+ *   as 8 palavras com PROM[0] & 0x0FFF e PROM[7] = 0.
+ *
+ * Por padrão são usadas tabelas de 256 entradas (256 B de flash cada), com um
+ * acesso por byte. Com CRC_NIBBLE_TABLES = 1 usam-se tabelas de 16 entradas
+ * (16 B cada), com dois acessos por byte.
+ */
+
+#ifndef CRC_H
+#define CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef CRC_NIBBLE_TABLES
+#define CRC_NIBBLE_TABLES 0 ///< 1 = tabelas de 16 entradas (menos flash, ~2x mais lento)
+#endif
+
+#define CRC8_SENSIRION_INIT 0xFF ///< Valor inicial do CRC-8 do SHT4x
+
+/**
+ * @brief CRC-8 Sensirion (polinômio 0x31, inicial 0xFF) de um buffer
+ * @param data Bytes a verificar
+ * @param len Quantidade de bytes
+ * @return CRC de 8 bits
+ */
+uint8_t crc8_sensirion(const uint8_t *data, size_t len);
+
+/**
+ * @brief CRC-4 dos coeficientes da PROM do MS5637
+ *
+ * Não modifica prom: a máscara de PROM[0] e o zero de PROM[7] são aplicados
+ * apenas no cálculo.
+ *
+ * @param prom As 8 palavras lidas da PROM (endereços 0xA0 a 0xAE)
+ * @return CRC de 4 bits, a comparar com prom[0] >> 12
+ */
+uint8_t crc4_ms5637(const uint16_t prom[8]);
+
+#endif // CRC_H
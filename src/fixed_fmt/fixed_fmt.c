@@ -0,0 +1,92 @@
+/**
+ * @file fixed_fmt.c
+ * @brief Implementação da formatação em ponto fixo
+ *
+ * Este arquivo contém a implementação das funções declaradas em fixed_fmt.h
+ */
+
+#include "fixed_fmt.h"
+#include <stdbool.h>
+
+// Potências de 10 usadas para reescalar o valor
+static const uint32_t pow10_table[FIXED_FMT_MAX_SCALE + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+};
+
+size_t fixed_fmt(char *buf, size_t size, int32_t value, uint8_t scale, uint8_t decimals,
+                 uint8_t width, const char *suffix)
+{
+    char digits[24]; // Dígitos em ordem inversa
+    uint8_t ndigits = 0;
+
+    if (size == 0)
+        return 0;
+    buf[0] = '\0';
+    if (scale > FIXED_FMT_MAX_SCALE || decimals > FIXED_FMT_MAX_SCALE)
+        return 0;
+
+    bool negative = value < 0;
+    uint32_t mag = negative ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+
+    // Arredonda (meio para longe do zero) quando há menos casas que a escala
+    uint8_t shown = decimals;
+    if (decimals < scale)
+    {
+        uint32_t div = pow10_table[scale - decimals];
+        mag = mag / div + ((mag % div) >= (div + 1) / 2 ? 1 : 0);
+    }
+    else
+    {
+        shown = scale;
+    }
+
+    // Parte fracionária + inteira, ao menos um dígito antes da vírgula
+    do
+    {
+        digits[ndigits++] = (char)('0' + mag % 10);
+        mag /= 10;
+    } while (mag || ndigits <= shown);
+
+    if (negative)
+    {
+        // "-0.00" não faz sentido: descarta o sinal se tudo arredondou para zero
+        bool all_zero = true;
+        for (uint8_t i = 0; i < ndigits; i++)
+            all_zero &= digits[i] == '0';
+        if (all_zero)
+            negative = false;
+    }
+
+    uint8_t zeros = decimals - shown; // Zeros extras quando decimals > scale
+    size_t number_len = ndigits + negative + (decimals ? 1 : 0) + zeros;
+    size_t pad = width > number_len ? width - number_len : 0;
+    size_t suffix_len = 0;
+    if (suffix)
+        while (suffix[suffix_len])
+            suffix_len++;
+
+    size_t total = pad + number_len + suffix_len;
+    if (total + 1 > size)
+        return 0;
+
+    char *out = buf;
+    while (pad--)
+        *out++ = ' ';
+    if (negative)
+        *out++ = '-';
+    while (ndigits > shown)
+        *out++ = digits[--ndigits];
+    if (decimals)
+    {
+        *out++ = '.';
+        while (ndigits)
+            *out++ = digits[--ndigits];
+        while (zeros--)
+            *out++ = '0';
+    }
+    for (size_t i = 0; i < suffix_len; i++)
+        *out++ = suffix[i];
+    *out = '\0';
+
+    return total;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file fixed_fmt.h
+ * @brief Formatação de valores em ponto fixo sem printf de float nem alocação
+ *
+ * Os drivers entregam grandezas já escaladas (centésimos de °C, Pa, centésimos
+ * de %UR, centímetros). Estas funções convertem esses inteiros diretamente em
+ * texto decimal, evitando a maquinaria de printf com float do newlib/pico_printf.
+ */
+
+#ifndef FIXED_FMT_H
+#define FIXED_FMT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FIXED_FMT_MAX_SCALE 9 ///< Maior número de casas decimais implícitas suportado
+
+/**
+ * @brief Formata um inteiro em ponto fixo como texto decimal
+ *
+ * Exemplo: value = -1234, scale = 2, decimals = 1, width = 7, suffix = " C"
+ * produz "  -12.3 C".
+ *
+ * @param buf Destino do texto (sempre terminado em '\0' se size > 0)
+ * @param size Tamanho do destino em bytes
+ * @param value Valor escalado por 10^scale (ex.: 2534 com scale 2 = 25.34)
+ * @param scale Casas decimais implícitas em value (0 a FIXED_FMT_MAX_SCALE)
+ * @param decimals Casas decimais exibidas; menos que scale arredonda, mais completa com zeros
+ * @param width Largura mínima do número, alinhado à direita com espaços (0 = sem preenchimento)
+ * @param suffix Texto acrescentado após o número (pode ser NULL)
+ * @return Número de caracteres escritos (sem o '\0'), ou 0 se não couber em buf
+ */
+size_t fixed_fmt(char *buf, size_t size, int32_t value, uint8_t scale, uint8_t decimals,
+                 uint8_t width, const char *suffix);
+
+#endif // FIXED_FMT_H
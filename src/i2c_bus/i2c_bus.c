@@ -0,0 +1,364 @@
+/**
+ * @file i2c_bus.c
+ * @brief Implementação do gerenciador do barramento I2C compartilhado
+ *
+ * O motor da fila roda na IRQ do I2C. Transações de bytes alimentam a FIFO
+ * de TX a cada TX_EMPTY (escritas e comandos de leitura) e esvaziam a de RX a
+ * cada RX_FULL; sequências de palavras vão por um canal DMA. O fim é o
+ * STOP_DET com tudo enviado e recebido, e um TX_ABRT conclui com falha. Em
+ * ambos os casos o motor já inicia a próxima transação da fila. A fila, a
+ * montagem das palavras, a condição de fim, o prazo e a liberação ficam em
+ * i2c_bus_core.c, também compilado na simulação.
+ *
+ * O prazo de cada transação é um alarme do timer; se ele dispara antes do
+ * fim, a transação é concluída com falha na hora e o motor para. A liberação
+ * do barramento (pulsos de SCL com espera ativa, até ~11 ms) e a
+ * reinicialização do controlador rodam em primeiro plano, em i2c_bus_service(),
+ * e só então a fila continua. Sem alarme livre a transação nem começa.
+ */
+
+#include "i2c_bus.h"
+#include "i2c_bus_core.h"
+#include "i2c_bus_profile.h"
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+#define I2C_BUS_TX_REFILL  4 // TX_EMPTY com até 4 palavras ainda na FIFO
+
+static bool bus_initialized = false;
+static uint32_t bus_hz = 0;   // clock programado no controlador
+static uint8_t bus_tar = 0xFF; // endereço programado no controlador
+static int bus_dma_chan = -1; // reservado na primeira sequência por DMA
+static alarm_id_t bus_alarm = 0; // prazo da transação ativa (0 = nenhum)
+static volatile bool bus_recovery_pending = false; // prazo vencido: fila parada até i2c_bus_service()
+#if I2C_BUS_PROFILE
+static uint32_t bus_started_us = 0; // início da transação ativa, para o perfil
+#endif
+static i2c_bus_stats_t bus_stats;
+
+static i2c_txn_t *volatile active = NULL;
+static i2c_bus_cursor_t cursor; // progresso da transação de bytes ativa
+
+static void bus_irq_handler(void);
+
+// Liberação do barramento (i2c_bus_clear) e contagem
+static void bus_clear(void) {
+    i2c_bus_clear();
+    bus_stats.recoveries++;
+}
+
+// (Re)inicializa controlador e pinos; i2c_init também reseta o bloco
+static void bus_setup(void) {
+    bus_hz = I2C_BUS_INIT_HZ;
+    bus_tar = 0xFF;
+    i2c_init(I2C_BUS_INST, bus_hz);
+    gpio_set_function(I2C_BUS_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(I2C_BUS_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(I2C_BUS_SDA);
+    gpio_pull_up(I2C_BUS_SCL);
+
+    i2c_hw_t *hw = i2c_get_hw(I2C_BUS_INST);
+    hw->intr_mask = 0;
+    hw->rx_tl = 0; // RX_FULL a partir de um byte
+    hw->tx_tl = I2C_BUS_TX_REFILL;
+}
+
+// Inicializa o barramento uma única vez
+void i2c_bus_init(void) {
+    if (bus_initialized)
+        return;
+    // Um escravo pode ter ficado no meio de uma leitura num reset do RP2040
+    gpio_init(I2C_BUS_SDA);
+    gpio_pull_up(I2C_BUS_SDA);
+    busy_wait_us_32(I2C_BUS_CLEAR_HALF_US);
+    if (!gpio_get(I2C_BUS_SDA))
+        bus_clear();
+
+    bus_setup();
+    uint irq_num = I2C0_IRQ + i2c_get_index(I2C_BUS_INST);
+    irq_set_exclusive_handler(irq_num, bus_irq_handler);
+    irq_set_enabled(irq_num, true);
+    bus_initialized = true;
+}
+
+// Preenche um descritor de dispositivo
+void i2c_bus_device_init(i2c_bus_device_t *dev, uint8_t address, uint32_t max_hz) {
+    dev->address = address;
+    dev->max_hz = max_hz;
+    dev->timeout_us = I2C_BUS_DEFAULT_TIMEOUT_US;
+}
+
+uint32_t i2c_bus_clock_hz(void) {
+    return bus_hz;
+}
+
+// Reprograma clock e endereço só quando mudam (o controlador está ocioso
+// entre transações; i2c_set_baudrate o desabilita por alguns ciclos)
+static void bus_select(i2c_hw_t *hw, const i2c_bus_device_t *dev) {
+    if (dev->max_hz != bus_hz) {
+        i2c_set_baudrate(I2C_BUS_INST, dev->max_hz);
+        bus_hz = dev->max_hz;
+    }
+    if (dev->address != bus_tar) {
+        hw->enable = 0;
+        hw->tar = dev->address;
+        hw->enable = 1;
+        bus_tar = dev->address;
+    }
+}
+
+// Coloca na FIFO de TX o que couber da transação de bytes ativa: escrita,
+// depois comandos de leitura (sem ultrapassar o espaço livre da FIFO de RX)
+static void bus_fill(i2c_hw_t *hw, const i2c_txn_t *txn) {
+    uint16_t word;
+    while (hw->txflr < I2C_BUS_FIFO_DEPTH && i2c_bus_next_word(&cursor, txn, &word))
+        hw->data_cmd = word;
+
+    // Sem nada a enviar, TX_EMPTY ficaria disparando: só fica ligado com pendências
+    if (i2c_bus_words_pending(&cursor, txn))
+        hw->intr_mask |= I2C_IC_INTR_MASK_M_TX_EMPTY_BITS;
+    else
+        hw->intr_mask &= ~I2C_IC_INTR_MASK_M_TX_EMPTY_BITS;
+}
+
+static void bus_drain_rx(i2c_hw_t *hw, i2c_txn_t *txn) {
+    while (hw->rxflr && cursor.rx_pos < txn->rx_len)
+        txn->rx[cursor.rx_pos++] = (uint8_t)hw->data_cmd;
+}
+
+static int64_t bus_timeout(alarm_id_t id, void *user_data);
+
+// Inicia a próxima transação se o barramento estiver livre (interrupções desabilitadas)
+static void bus_kick(void) {
+    i2c_txn_t *txn;
+    i2c_hw_t *hw = i2c_get_hw(I2C_BUS_INST);
+    for (;;) {
+        // Com uma liberação pendente o controlador está parado: a fila espera
+        if (active || bus_recovery_pending)
+            return;
+        txn = i2c_bus_queue_pop();
+        if (!txn)
+            return;
+
+        active = txn;
+        txn->state = I2C_TXN_ACTIVE;
+#if I2C_BUS_PROFILE
+        bus_started_us = time_us_32();
+#endif
+        bus_select(hw, txn->dev);
+        (void)hw->clr_stop_det;
+        (void)hw->clr_tx_abrt;
+        bus_alarm = add_alarm_in_us(i2c_bus_txn_budget_us(txn, bus_hz), bus_timeout, NULL, true);
+        if (bus_alarm > 0)
+            break;
+
+        // Sem alarme livre não há como garantir o fim: falha sem ir ao barramento
+        bus_alarm = 0;
+        bus_stats.timeouts++;
+        txn->state = I2C_TXN_FAILED;
+        active = NULL;
+#if I2C_BUS_PROFILE
+        i2c_bus_profile_record(txn, false, 0);
+#endif
+        if (txn->callback)
+            txn->callback(txn, false); // pode enviar (e iniciar) novas transações
+    }
+
+    if (txn->words) {
+        if (bus_dma_chan < 0)
+            bus_dma_chan = dma_claim_unused_channel(true);
+        // IC_DATA_CMD leva o STOP no bit 9: o DMA precisa escrever palavras de 16 bits
+        dma_channel_config cfg = dma_channel_get_default_config(bus_dma_chan);
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+        channel_config_set_read_increment(&cfg, true);
+        channel_config_set_write_increment(&cfg, false);
+        channel_config_set_dreq(&cfg, i2c_get_dreq(I2C_BUS_INST, true));
+        hw->dma_tdlr = 8;
+        hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS;
+        hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+        dma_channel_configure(bus_dma_chan, &cfg, &hw->data_cmd, txn->words,
+                              txn->word_count, true);
+    } else {
+        cursor = (i2c_bus_cursor_t){0};
+        hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS |
+                        I2C_IC_INTR_MASK_M_RX_FULL_BITS;
+        bus_fill(hw, txn);
+    }
+}
+
+// Conclui a transação ativa, notifica e segue com a fila (na IRQ)
+static void bus_finish(i2c_hw_t *hw, bool ok) {
+    i2c_txn_t *txn = active;
+    hw->intr_mask = 0;
+    hw->dma_cr = 0;
+    if (bus_alarm) {
+        cancel_alarm(bus_alarm);
+        bus_alarm = 0;
+    }
+    txn->state = ok ? I2C_TXN_DONE : I2C_TXN_FAILED;
+    active = NULL;
+#if I2C_BUS_PROFILE
+    i2c_bus_profile_record(txn, ok, time_us_32() - bus_started_us);
+#endif
+    if (txn->callback)
+        txn->callback(txn, ok); // pode enviar novas transações
+    bus_kick();
+}
+
+static void bus_irq_handler(void) {
+    i2c_txn_t *txn = active;
+    i2c_hw_t *hw = i2c_get_hw(I2C_BUS_INST);
+    if (!txn) {
+        hw->intr_mask = 0;
+        return;
+    }
+    uint32_t stat = hw->intr_stat;
+
+    if (stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        if (txn->words)
+            dma_channel_abort(bus_dma_chan);
+        (void)hw->clr_tx_abrt; // também libera a FIFO de TX
+        (void)hw->clr_stop_det;
+        while (hw->rxflr)
+            (void)hw->data_cmd;
+        bus_stats.aborts++;
+        bus_finish(hw, false);
+        return;
+    }
+
+    if (txn->words) {
+        // Cada transação da sequência termina com STOP: ver i2c_bus_words_done()
+        if (stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+            (void)hw->clr_stop_det;
+            if (i2c_bus_words_done(dma_channel_is_busy(bus_dma_chan), hw->txflr,
+                                   hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS))
+                bus_finish(hw, true);
+        }
+        return;
+    }
+
+    bus_drain_rx(hw, txn);
+    if (stat & (I2C_IC_INTR_STAT_R_TX_EMPTY_BITS | I2C_IC_INTR_STAT_R_RX_FULL_BITS))
+        bus_fill(hw, txn);
+    if (stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+        (void)hw->clr_stop_det;
+        // Sem repeated start a escrita termina com um STOP intermediário
+        bus_drain_rx(hw, txn);
+        if (i2c_bus_bytes_done(&cursor, txn) && hw->txflr == 0)
+            bus_finish(hw, true);
+    }
+}
+
+/*
+ * Prazo vencido (IRQ do timer): o controlador ou um escravo travou no meio da
+ * transação. Aqui só se desliga o controlador e conclui com falha; a
+ * liberação espera ativamente e fica para i2c_bus_service(), fora da IRQ
+ */
+static int64_t bus_timeout(alarm_id_t id, void *user_data) {
+    (void)user_data;
+    uint32_t irq_state = save_and_disable_interrupts();
+    // Um alarme cancelado tarde demais não pode atingir a transação seguinte
+    if (active && id == bus_alarm) {
+        bus_alarm = 0;
+        bus_stats.timeouts++;
+        i2c_hw_t *hw = i2c_get_hw(I2C_BUS_INST);
+        hw->intr_mask = 0;
+        hw->dma_cr = 0;
+        if (active->words)
+            dma_channel_abort(bus_dma_chan);
+        hw->enable = 0;
+        bus_recovery_pending = true;
+        bus_finish(hw, false); // não inicia a próxima: a liberação está pendente
+        __sev(); // acorda quem espera em WFE para atender a liberação
+    }
+    restore_interrupts(irq_state);
+    return 0; // não repete
+}
+
+// Enfileira uma transação e inicia o motor se estiver parado
+bool i2c_bus_submit(i2c_txn_t *txn) {
+    if (!txn->dev || txn->prio >= I2C_BUS_PRIO_COUNT)
+        return false;
+    if (txn->words ? txn->word_count == 0
+                   : (txn->tx_len == 0 && txn->rx_len == 0))
+        return false;
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (txn->state == I2C_TXN_QUEUED || txn->state == I2C_TXN_ACTIVE) {
+        restore_interrupts(irq_state);
+        return false;
+    }
+    txn->state = I2C_TXN_QUEUED;
+    i2c_bus_queue_push(txn);
+    bus_kick();
+    restore_interrupts(irq_state);
+    return true;
+}
+
+// Libera o barramento após um prazo vencido e retoma a fila (primeiro plano)
+void i2c_bus_service(void) {
+    if (!bus_recovery_pending)
+        return;
+    // Parado (active == NULL, IRQ do I2C mascarada): pulsos com interrupções ligadas
+    bus_clear();
+    bus_setup();
+    uint32_t irq_state = save_and_disable_interrupts();
+    bus_recovery_pending = false;
+    bus_kick();
+    restore_interrupts(irq_state);
+}
+
+bool i2c_bus_service_pending(void) {
+    return bus_recovery_pending;
+}
+
+// Enfileira e espera; o tempo de espera é o das transações à frente na fila.
+// Uma liberação pendente é atendida aqui mesmo, senão a fila não andaria
+int i2c_bus_transfer(i2c_txn_t *txn) {
+    i2c_bus_init();
+    if (!i2c_bus_submit(txn))
+        return PICO_ERROR_GENERIC;
+    while (!i2c_bus_txn_finished(txn)) {
+        i2c_bus_service();
+        tight_loop_contents();
+    }
+    if (txn->state == I2C_TXN_FAILED)
+        return PICO_ERROR_GENERIC;
+    return txn->rx_len ? txn->rx_len : txn->tx_len;
+}
+
+int i2c_bus_write(const i2c_bus_device_t *dev, const uint8_t *src, size_t len) {
+    i2c_txn_t txn = {
+        .dev = dev, .tx = src, .tx_len = (uint16_t)len, .prio = I2C_BUS_PRIO_NORMAL,
+    };
+    return i2c_bus_transfer(&txn);
+}
+
+int i2c_bus_read(const i2c_bus_device_t *dev, uint8_t *dst, size_t len) {
+    i2c_txn_t txn = {
+        .dev = dev, .rx = dst, .rx_len = (uint16_t)len, .prio = I2C_BUS_PRIO_NORMAL,
+    };
+    return i2c_bus_transfer(&txn);
+}
+
+int i2c_bus_write_read(const i2c_bus_device_t *dev, const uint8_t *src, size_t src_len,
+                       uint8_t *dst, size_t dst_len) {
+    i2c_txn_t txn = {
+        .dev = dev, .tx = src, .tx_len = (uint16_t)src_len,
+        .rx = dst, .rx_len = (uint16_t)dst_len,
+        .restart = true, .prio = I2C_BUS_PRIO_NORMAL,
+    };
+    return i2c_bus_transfer(&txn);
+}
+
+void i2c_bus_get_stats(i2c_bus_stats_t *stats) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    *stats = bus_stats;
+    restore_interrupts(irq_state);
+}
+
+bool i2c_bus_busy(void) {
+    return active || !i2c_bus_queue_empty();
+}
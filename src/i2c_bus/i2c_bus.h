@@ -0,0 +1,231 @@
+/**
+ * @file i2c_bus.h
+ * @brief Gerenciador do barramento I2C compartilhado da placa
+ *
+ * Display, sensores e expansor dividem o mesmo i2c0 (SDA 4 / SCL 5). Este
+ * módulo é o único dono da instância: inicializa o barramento uma vez e, a
+ * cada transação, ajusta o clock para o máximo suportado pelo dispositivo
+ * endereçado (só reprograma quando o valor muda). Assim a velocidade do
+ * barramento não depende mais da ordem de inicialização dos drivers.
+ *
+ * Todo acesso passa por uma fila de transações executada pela IRQ do I2C
+ * (bytes pela FIFO, sequências longas por DMA). Os drivers enviam descritores
+ * com i2c_bus_submit() e seguem trabalhando; as chamadas síncronas
+ * (i2c_bus_write() etc.) enfileiram e aguardam. A cada transação concluída o
+ * motor escolhe a próxima pela prioridade, então a leitura de um botão passa
+ * à frente de um quadro do display já enfileirado.
+ *
+ * Cada transação tem um prazo: o tempo de barramento dos seus bytes no clock
+ * atual (com folga) mais o `timeout_us` do dispositivo. Se o prazo vence, a
+ * transação é concluída com falha e a fila para até i2c_bus_service(), em
+ * primeiro plano, aplicar a recuperação padrão (até 9 pulsos de SCL com o
+ * pino em GPIO até o escravo soltar o SDA, seguidos de um STOP) e
+ * reinicializar o controlador. i2c_bus_transfer() chama i2c_bus_service()
+ * enquanto espera; quem só usa transações assíncronas deve chamá-la no laço
+ * principal. Um dispositivo travado custa no máximo um prazo por transação.
+ * Se não houver alarme livre para o prazo, a transação falha sem ir ao
+ * barramento.
+ */
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hardware/i2c.h"
+
+// --- CONFIGURAÇÕES DE HARDWARE ---
+#define I2C_BUS_INST     i2c0
+#define I2C_BUS_SDA      4
+#define I2C_BUS_SCL      5
+#define I2C_BUS_INIT_HZ  100000 ///< Clock até o primeiro dispositivo ser acessado
+
+/// Folga padrão por transação além do tempo de barramento (clock stretching, latência de IRQ)
+#ifndef I2C_BUS_DEFAULT_TIMEOUT_US
+#define I2C_BUS_DEFAULT_TIMEOUT_US 2000
+#endif
+
+// Clocks máximos usuais
+#define I2C_BUS_STANDARD_HZ  100000  ///< Standard-mode
+#define I2C_BUS_FAST_HZ      400000  ///< Fast-mode
+#define I2C_BUS_FAST_PLUS_HZ 1000000 ///< Fast-mode Plus
+
+/**
+ * @brief Dispositivo no barramento: endereço e maior clock que ele suporta
+ *
+ * Pode ser declarado estático com I2C_BUS_DEVICE() ou preenchido em tempo de
+ * execução com i2c_bus_device_init().
+ */
+typedef struct {
+    uint8_t address;     ///< Endereço de 7 bits
+    uint32_t max_hz;     ///< Maior clock de SCL aceito pelo dispositivo
+    uint32_t timeout_us; ///< Folga do prazo de cada transação, além do tempo de barramento
+} i2c_bus_device_t;
+
+#define I2C_BUS_DEVICE(addr, hz) \
+    { .address = (addr), .max_hz = (hz), .timeout_us = I2C_BUS_DEFAULT_TIMEOUT_US }
+
+/**
+ * @brief Prioridade de uma transação na fila
+ *
+ * Transações de mesma prioridade saem na ordem de envio. Uma transação em
+ * andamento nunca é interrompida: divida transferências longas em várias.
+ */
+typedef enum {
+    I2C_BUS_PRIO_HIGH = 0, ///< Entradas do usuário (botões)
+    I2C_BUS_PRIO_NORMAL,   ///< Sensores, LEDs e chamadas síncronas
+    I2C_BUS_PRIO_BULK,     ///< Transferências longas (framebuffer)
+    I2C_BUS_PRIO_COUNT
+} i2c_bus_prio_t;
+
+/**
+ * @brief Estado de um descritor
+ */
+typedef enum {
+    I2C_TXN_IDLE = 0, ///< Nunca enviado
+    I2C_TXN_QUEUED,   ///< Na fila
+    I2C_TXN_ACTIVE,   ///< No barramento
+    I2C_TXN_DONE,     ///< Concluído com sucesso
+    I2C_TXN_FAILED    ///< Abortado (NACK, perda de arbitragem) ou prazo vencido
+} i2c_txn_state_t;
+
+typedef struct i2c_txn i2c_txn_t;
+
+/**
+ * @brief Callback de fim de transação
+ *
+ * Executado na IRQ do I2C: deve ser curto e não pode usar as chamadas
+ * síncronas, mas pode enviar novas transações com i2c_bus_submit().
+ */
+typedef void (*i2c_txn_cb_t)(i2c_txn_t *txn, bool ok);
+
+/**
+ * @brief Descritor de uma transação
+ *
+ * A memória do descritor e dos buffers pertence a quem envia e precisa
+ * continuar válida até a conclusão. Uma transação é uma escrita de `tx_len`
+ * bytes seguida de uma leitura de `rx_len` bytes (qualquer um dos dois pode
+ * ser zero), ou então uma sequência pronta de palavras de IC_DATA_CMD em
+ * `words`, enviada por DMA (pode conter várias transações com STOP, para o
+ * mesmo endereço).
+ */
+struct i2c_txn {
+    const i2c_bus_device_t *dev; ///< Dispositivo endereçado
+    const uint8_t *tx;           ///< Bytes a escrever
+    uint16_t tx_len;
+    uint8_t *rx;                 ///< Destino da leitura
+    uint16_t rx_len;
+    const uint16_t *words;       ///< Sequência de IC_DATA_CMD (substitui tx/rx se não nula)
+    uint16_t word_count;
+    bool restart;                ///< Repeated start entre escrita e leitura (senão STOP + START)
+    i2c_bus_prio_t prio;
+    i2c_txn_cb_t callback;       ///< Opcional, chamado ao concluir
+    void *user;                  ///< Livre para quem envia
+
+    // Uso interno da fila
+    volatile i2c_txn_state_t state;
+    i2c_txn_t *next;
+};
+
+/**
+ * @brief Contadores de falhas do barramento
+ */
+typedef struct {
+    uint32_t aborts;     ///< Transações abortadas pelo controlador (NACK etc.)
+    uint32_t timeouts;   ///< Transações com prazo vencido
+    uint32_t recoveries; ///< Sequências de liberação (9 pulsos de SCL + STOP) executadas
+} i2c_bus_stats_t;
+
+/**
+ * @brief Inicializa o barramento (pinos, pull-ups, controlador e IRQ)
+ *
+ * Pode ser chamada por cada driver: só a primeira chamada tem efeito. Se o
+ * SDA já estiver preso em nível baixo (ex.: reset no meio de uma leitura),
+ * executa a sequência de liberação antes.
+ */
+void i2c_bus_init(void);
+
+/**
+ * @brief Preenche um descritor de dispositivo (folga padrão de prazo)
+ */
+void i2c_bus_device_init(i2c_bus_device_t *dev, uint8_t address, uint32_t max_hz);
+
+/**
+ * @brief Clock de SCL programado no momento (Hz)
+ */
+uint32_t i2c_bus_clock_hz(void);
+
+/**
+ * @brief Enfileira uma transação e retorna sem esperar
+ *
+ * Pode ser chamada no laço principal, em callbacks de transação e em outras
+ * IRQs.
+ *
+ * @return false se o descritor já está na fila/em andamento ou é inválido
+ */
+bool i2c_bus_submit(i2c_txn_t *txn);
+
+/**
+ * @brief Indica se a transação terminou (com sucesso ou não)
+ */
+static inline bool i2c_bus_txn_finished(const i2c_txn_t *txn) {
+    return txn->state == I2C_TXN_DONE || txn->state == I2C_TXN_FAILED;
+}
+
+/**
+ * @brief Enfileira e aguarda a conclusão (não usar em IRQ)
+ *
+ * A espera é limitada pelos prazos da transação e das que estão à frente.
+ *
+ * @return Bytes lidos (ou escritos, se não houver leitura) ou PICO_ERROR_GENERIC
+ */
+int i2c_bus_transfer(i2c_txn_t *txn);
+
+/**
+ * @brief Escrita síncrona com prioridade normal
+ *
+ * @return Bytes escritos ou PICO_ERROR_GENERIC
+ */
+int i2c_bus_write(const i2c_bus_device_t *dev, const uint8_t *src, size_t len);
+
+/**
+ * @brief Leitura síncrona com prioridade normal
+ *
+ * @return Bytes lidos ou PICO_ERROR_GENERIC
+ */
+int i2c_bus_read(const i2c_bus_device_t *dev, uint8_t *dst, size_t len);
+
+/**
+ * @brief Escrita seguida de leitura com repeated start (ex.: ponteiro de registrador)
+ *
+ * @return Bytes lidos ou PICO_ERROR_GENERIC
+ */
+int i2c_bus_write_read(const i2c_bus_device_t *dev, const uint8_t *src, size_t src_len,
+                       uint8_t *dst, size_t dst_len);
+
+/**
+ * @brief Executa a liberação do barramento pendente após um prazo vencido
+ *
+ * Roda em primeiro plano (não usar em IRQ): a sequência de pulsos espera
+ * ativamente até ~11 ms. Sem liberação pendente não faz nada. Depois dela a
+ * fila volta a andar.
+ */
+void i2c_bus_service(void);
+
+/**
+ * @brief Indica se há uma liberação esperando por i2c_bus_service()
+ */
+bool i2c_bus_service_pending(void);
+
+/**
+ * @brief Indica se há transação em andamento ou na fila
+ */
+bool i2c_bus_busy(void);
+
+/**
+ * @brief Copia os contadores de falhas
+ */
+void i2c_bus_get_stats(i2c_bus_stats_t *stats);
+
+#endif // I2C_BUS_H
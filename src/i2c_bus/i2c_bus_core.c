@@ -0,0 +1,111 @@
+/**
+ * @file i2c_bus_core.c
+ * @brief Fila, montagem de palavras, prazo e liberação do barramento I2C
+ */
+
+#include "i2c_bus_core.h"
+#include "pico/stdlib.h"
+
+// Lista ligada pelos próprios descritores, uma por prioridade
+static i2c_txn_t *queue_head[I2C_BUS_PRIO_COUNT];
+static i2c_txn_t *queue_tail[I2C_BUS_PRIO_COUNT];
+
+void i2c_bus_queue_push(i2c_txn_t *txn) {
+    txn->next = NULL;
+    if (queue_tail[txn->prio])
+        queue_tail[txn->prio]->next = txn;
+    else
+        queue_head[txn->prio] = txn;
+    queue_tail[txn->prio] = txn;
+}
+
+i2c_txn_t *i2c_bus_queue_pop(void) {
+    for (int p = 0; p < I2C_BUS_PRIO_COUNT; p++) {
+        i2c_txn_t *txn = queue_head[p];
+        if (txn) {
+            queue_head[p] = txn->next;
+            if (!queue_head[p])
+                queue_tail[p] = NULL;
+            txn->next = NULL;
+            return txn;
+        }
+    }
+    return NULL;
+}
+
+bool i2c_bus_queue_empty(void) {
+    for (int p = 0; p < I2C_BUS_PRIO_COUNT; p++)
+        if (queue_head[p])
+            return false;
+    return true;
+}
+
+bool i2c_bus_next_word(i2c_bus_cursor_t *cur, const i2c_txn_t *txn, uint16_t *word) {
+    if (cur->tx_pos < txn->tx_len) {
+        uint16_t w = txn->tx[cur->tx_pos];
+        if (++cur->tx_pos == txn->tx_len && (txn->rx_len == 0 || !txn->restart))
+            w |= I2C_IC_DATA_CMD_STOP_BITS;
+        *word = w;
+        return true;
+    }
+    if (cur->rd_cmds < txn->rx_len &&
+        (uint16_t)(cur->rd_cmds - cur->rx_pos) < I2C_BUS_FIFO_DEPTH) {
+        uint16_t w = I2C_IC_DATA_CMD_CMD_BITS;
+        if (cur->rd_cmds == 0 && txn->tx_len > 0 && txn->restart)
+            w |= I2C_IC_DATA_CMD_RESTART_BITS;
+        if (++cur->rd_cmds == txn->rx_len)
+            w |= I2C_IC_DATA_CMD_STOP_BITS;
+        *word = w;
+        return true;
+    }
+    return false;
+}
+
+uint32_t i2c_bus_txn_budget_us(const i2c_txn_t *txn, uint32_t bus_hz) {
+    uint32_t bytes = txn->words ? txn->word_count : (uint32_t)txn->tx_len + txn->rx_len + 2;
+    uint32_t bus_us = (bytes * 9u * 1000u) / (bus_hz / 1000u);
+    return 2u * bus_us + txn->dev->timeout_us;
+}
+
+// Linhas em dreno aberto via GPIO: nível baixo é saída em 0, alto é soltar
+// a linha para o pull-up
+static void line_release(uint gpio) {
+    gpio_set_dir(gpio, GPIO_IN);
+}
+
+static void line_low(uint gpio) {
+    gpio_put(gpio, 0);
+    gpio_set_dir(gpio, GPIO_OUT);
+}
+
+// Solta o SCL e espera ele subir (um escravo pode estar estendendo o clock)
+static void scl_release(void) {
+    line_release(I2C_BUS_SCL);
+    for (uint32_t t = 0; t < I2C_BUS_CLEAR_STRETCH_US && !gpio_get(I2C_BUS_SCL); t++)
+        busy_wait_us_32(1);
+    busy_wait_us_32(I2C_BUS_CLEAR_HALF_US);
+}
+
+void i2c_bus_clear(void) {
+    gpio_init(I2C_BUS_SDA);
+    gpio_init(I2C_BUS_SCL);
+    gpio_pull_up(I2C_BUS_SDA);
+    gpio_pull_up(I2C_BUS_SCL);
+    line_release(I2C_BUS_SDA);
+    scl_release();
+
+    for (int i = 0; i < 9 && !gpio_get(I2C_BUS_SDA); i++) {
+        line_low(I2C_BUS_SCL);
+        busy_wait_us_32(I2C_BUS_CLEAR_HALF_US);
+        scl_release();
+    }
+
+    // STOP: SDA sobe com SCL alto
+    line_low(I2C_BUS_SCL);
+    busy_wait_us_32(I2C_BUS_CLEAR_HALF_US);
+    line_low(I2C_BUS_SDA);
+    busy_wait_us_32(I2C_BUS_CLEAR_HALF_US);
+    scl_release();
+    line_release(I2C_BUS_SDA);
+    busy_wait_us_32(I2C_BUS_CLEAR_HALF_US);
+}
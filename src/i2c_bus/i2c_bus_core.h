@@ -0,0 +1,118 @@
+/**
+ * @file i2c_bus_core.h
+ * @brief Partes do motor do barramento I2C que não dependem do controlador
+ *
+ * Fila por prioridade, montagem das palavras de IC_DATA_CMD de uma transação
+ * de bytes, a condição de fim de uma sequência por DMA, o prazo de cada
+ * transação e a liberação do barramento por GPIO. O motor do firmware
+ * (i2c_bus.c) as usa na IRQ do I2C e em i2c_bus_service(); a simulação
+ * (sim_i2c_bus.c) executa as mesmas palavras contra os modelos dos chips e a
+ * mesma liberação sobre os pinos simulados, então os testes de host cobrem a
+ * fila, os bits de STOP/RESTART, o prazo e a recuperação que vão para o RP2040.
+ *
+ * Uso interno do motor: os drivers só incluem i2c_bus.h. Nada aqui é
+ * reentrante; quem chama garante a exclusão (interrupções desabilitadas).
+ */
+
+#ifndef I2C_BUS_CORE_H
+#define I2C_BUS_CORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "i2c_bus.h"
+
+#define I2C_BUS_FIFO_DEPTH 16 ///< Profundidade das FIFOs de TX e RX do controlador
+#define I2C_BUS_CLEAR_HALF_US 5       ///< Meio período dos pulsos de liberação (100 kHz)
+#define I2C_BUS_CLEAR_STRETCH_US 1000 ///< Espera máxima pelo SCL subir em cada pulso
+
+/**
+ * @brief Coloca a transação no fim da fila da sua prioridade
+ */
+void i2c_bus_queue_push(i2c_txn_t *txn);
+
+/**
+ * @brief Retira a próxima transação (maior prioridade, depois ordem de envio)
+ *
+ * @return NULL com a fila vazia
+ */
+i2c_txn_t *i2c_bus_queue_pop(void);
+
+/**
+ * @brief Indica se não há nenhuma transação na fila
+ */
+bool i2c_bus_queue_empty(void);
+
+/**
+ * @brief Progresso de uma transação de bytes
+ *
+ * Zerado no início da transação. `rx_pos` avança por quem esvazia a FIFO de
+ * RX; os outros dois, por i2c_bus_next_word().
+ */
+typedef struct {
+    uint16_t tx_pos;  ///< Bytes de escrita já na FIFO
+    uint16_t rd_cmds; ///< Comandos de leitura já na FIFO
+    uint16_t rx_pos;  ///< Bytes já lidos
+} i2c_bus_cursor_t;
+
+/**
+ * @brief Próxima palavra de IC_DATA_CMD da transação
+ *
+ * Escrita primeiro, depois os comandos de leitura. O último byte escrito leva
+ * STOP quando não há leitura ou ela vem sem repeated start; o primeiro
+ * comando de leitura leva RESTART quando há escrita antes e `restart` está
+ * ligado; o último comando leva STOP. Nunca deixa mais de
+ * I2C_BUS_FIFO_DEPTH leituras sem ler, para a FIFO de RX não transbordar.
+ *
+ * @return false se não há palavra a enviar agora (acabou ou espera a FIFO de RX)
+ */
+bool i2c_bus_next_word(i2c_bus_cursor_t *cur, const i2c_txn_t *txn, uint16_t *word);
+
+/**
+ * @brief Indica se ainda há palavras da transação a enviar
+ */
+static inline bool i2c_bus_words_pending(const i2c_bus_cursor_t *cur, const i2c_txn_t *txn) {
+    return cur->tx_pos < txn->tx_len || cur->rd_cmds < txn->rx_len;
+}
+
+/**
+ * @brief Indica se tudo foi escrito e lido
+ */
+static inline bool i2c_bus_bytes_done(const i2c_bus_cursor_t *cur, const i2c_txn_t *txn) {
+    return cur->tx_pos == txn->tx_len && cur->rx_pos == txn->rx_len;
+}
+
+/**
+ * @brief Fim de uma sequência por DMA, avaliado a cada STOP_DET
+ *
+ * Cada transação da sequência termina com STOP. Acabou quando o DMA entregou
+ * tudo, a FIFO de TX esvaziou e o mestre voltou ao repouso: uma IRQ atrasada
+ * de um STOP intermediário pode ver a FIFO vazia com o último byte ainda
+ * saindo (MST_ACTIVITY = 1), e o STOP final gera outra IRQ.
+ *
+ * @param dma_busy      Canal DMA ainda transferindo
+ * @param txflr         Palavras na FIFO de TX
+ * @param master_active Bit MST_ACTIVITY de IC_STATUS
+ */
+static inline bool i2c_bus_words_done(bool dma_busy, uint32_t txflr, bool master_active) {
+    return !dma_busy && txflr == 0 && !master_active;
+}
+
+/**
+ * @brief Prazo de uma transação no clock `bus_hz`
+ *
+ * Tempo de barramento (9 bits por byte, mais endereço e margem) dobrado, mais
+ * a folga `timeout_us` do dispositivo.
+ */
+uint32_t i2c_bus_txn_budget_us(const i2c_txn_t *txn, uint32_t bus_hz);
+
+/**
+ * @brief Sequência de liberação do barramento (UM10204, 3.1.16)
+ *
+ * Com os pinos em GPIO, até 9 pulsos de SCL fazem o escravo que segura o SDA
+ * terminar o byte em andamento e soltar a linha; em seguida um STOP devolve
+ * todos ao estado ocioso. Espera ativamente (até ~11 ms com clock
+ * stretching); os pinos ficam em GPIO, soltos.
+ */
+void i2c_bus_clear(void);
+
+#endif // I2C_BUS_CORE_H
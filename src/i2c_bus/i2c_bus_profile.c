@@ -0,0 +1,101 @@
+/**
+ * @file i2c_bus_profile.c
+ * @brief Tabela de contadores por endereço e relatório do perfil do I2C
+ *
+ * A tabela é pequena e percorrida linearmente: a placa tem quatro
+ * dispositivos, e o registro roda na IRQ a cada transação.
+ */
+
+#include "i2c_bus_profile.h"
+
+#if I2C_BUS_PROFILE
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "fixed_fmt.h"
+
+#define OTHER_ADDRESS 0xFF
+
+static i2c_bus_profile_entry_t entries[I2C_BUS_PROFILE_SLOTS];
+static size_t entries_used = 0;
+static uint64_t window_start_us = 0;
+
+// Entrada do endereço; a última vaga fica para os endereços excedentes
+// (com a tabela cheia, todo endereço novo cai nela)
+static i2c_bus_profile_entry_t *entry_for(uint8_t address) {
+    for (size_t i = 0; i < entries_used; i++)
+        if (entries[i].address == address)
+            return &entries[i];
+    if (entries_used >= I2C_BUS_PROFILE_SLOTS - 1 && address != OTHER_ADDRESS)
+        return entry_for(OTHER_ADDRESS);
+    i2c_bus_profile_entry_t *e = &entries[entries_used++];
+    *e = (i2c_bus_profile_entry_t){.address = address};
+    return e;
+}
+
+void i2c_bus_profile_record(const i2c_txn_t *txn, bool ok, uint32_t elapsed_us) {
+    i2c_bus_profile_entry_t *e = entry_for(txn->dev->address);
+    e->transactions++;
+    e->busy_us += elapsed_us;
+    if (elapsed_us > e->max_us)
+        e->max_us = elapsed_us;
+    if (!ok) {
+        e->errors++;
+        return;
+    }
+    // Sequências de IC_DATA_CMD só escrevem (uma palavra por byte)
+    e->bytes_tx += txn->words ? txn->word_count : txn->tx_len;
+    e->bytes_rx += txn->words ? 0 : txn->rx_len;
+}
+
+// Cópia sob interrupções desabilitadas: o motor atualiza a tabela na IRQ
+size_t i2c_bus_profile_snapshot(i2c_bus_profile_entry_t *out, size_t max, uint64_t *window_us) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    size_t n = entries_used < max ? entries_used : max;
+    for (size_t i = 0; i < n; i++)
+        out[i] = entries[i];
+    if (window_us)
+        *window_us = time_us_64() - window_start_us;
+    restore_interrupts(irq_state);
+    return n;
+}
+
+void i2c_bus_profile_reset(void) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    entries_used = 0;
+    window_start_us = time_us_64();
+    restore_interrupts(irq_state);
+}
+
+void i2c_bus_profile_report(void) {
+    i2c_bus_profile_entry_t snap[I2C_BUS_PROFILE_SLOTS];
+    uint64_t window_us;
+    size_t n = i2c_bus_profile_snapshot(snap, I2C_BUS_PROFILE_SLOTS, &window_us);
+    char busy[12], share[12];
+
+    printf("[I2C] perfil em %lu ms\n", (unsigned long)(window_us / 1000));
+    printf("[I2C] end   trans  erros   escritos    lidos  ocupado(ms)  max(us)  uso(%%)\n");
+    uint64_t total_us = 0;
+    for (size_t i = 0; i < n; i++) {
+        const i2c_bus_profile_entry_t *e = &snap[i];
+        total_us += e->busy_us;
+        // Ocupação em centésimos de %, formatada sem float
+        int32_t share_centi = window_us ? (int32_t)(e->busy_us * 10000 / window_us) : 0;
+        fixed_fmt(busy, sizeof(busy), (int32_t)(e->busy_us / 10), 2, 2, 11, NULL);
+        fixed_fmt(share, sizeof(share), share_centi, 2, 2, 6, NULL);
+        if (e->address == OTHER_ADDRESS)
+            printf("[I2C] outros");
+        else
+            printf("[I2C] 0x%02X ", e->address);
+        printf(" %6lu %6lu %10lu %8lu %s %8lu  %s\n",
+               (unsigned long)e->transactions, (unsigned long)e->errors,
+               (unsigned long)e->bytes_tx, (unsigned long)e->bytes_rx,
+               busy, (unsigned long)e->max_us, share);
+    }
+    int32_t total_centi = window_us ? (int32_t)(total_us * 10000 / window_us) : 0;
+    fixed_fmt(share, sizeof(share), total_centi, 2, 2, 0, NULL);
+    printf("[I2C] barramento ocupado %s%% do tempo\n", share);
+}
+
+#endif // I2C_BUS_PROFILE
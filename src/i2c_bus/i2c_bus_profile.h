@@ -0,0 +1,91 @@
+/**
+ * @file i2c_bus_profile.h
+ * @brief Perfil de tráfego do barramento I2C por dispositivo
+ *
+ * O motor do barramento registra cada transação concluída (ou falha) na
+ * entrada do endereço: contagem, erros, bytes escritos e lidos, tempo de
+ * barramento acumulado e a transação mais longa. O relatório sai pela serial
+ * com i2c_bus_profile_report(), junto da ocupação do barramento desde o último
+ * i2c_bus_profile_reset().
+ *
+ * Desligado por padrão: com I2C_BUS_PROFILE = 0 as funções viram inline
+ * vazias e o motor não mede nada, então nenhum código ou RAM fica no
+ * firmware. Para ligar, defina I2C_BUS_PROFILE=1 no target_compile_definitions.
+ */
+
+#ifndef I2C_BUS_PROFILE_H
+#define I2C_BUS_PROFILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "i2c_bus.h"
+
+#ifndef I2C_BUS_PROFILE
+#define I2C_BUS_PROFILE 0
+#endif
+
+/// Endereços distintos acompanhados (os demais somam na entrada 0xFF)
+#define I2C_BUS_PROFILE_SLOTS 8
+
+/**
+ * @brief Contadores de um endereço
+ */
+typedef struct {
+    uint8_t address;       ///< Endereço de 7 bits (0xFF = demais endereços)
+    uint32_t transactions; ///< Transações executadas, com ou sem sucesso
+    uint32_t errors;       ///< NACKs, abortos e prazos vencidos
+    uint32_t bytes_tx;     ///< Bytes escritos em transações concluídas
+    uint32_t bytes_rx;     ///< Bytes lidos em transações concluídas
+    uint64_t busy_us;      ///< Tempo de barramento acumulado
+    uint32_t max_us;       ///< Transação mais longa
+} i2c_bus_profile_entry_t;
+
+#if I2C_BUS_PROFILE
+
+/**
+ * @brief Registra uma transação (chamado pelo motor, em contexto de IRQ)
+ *
+ * @param txn Transação que terminou
+ * @param ok false se falhou
+ * @param elapsed_us Tempo entre o início no barramento e a conclusão
+ */
+void i2c_bus_profile_record(const i2c_txn_t *txn, bool ok, uint32_t elapsed_us);
+
+/**
+ * @brief Copia as entradas em uso, ordenadas pela primeira transação
+ *
+ * @param out Destino
+ * @param max Capacidade de out
+ * @param window_us Se não for NULL, recebe o tempo desde o último reset
+ * @return Número de entradas copiadas
+ */
+size_t i2c_bus_profile_snapshot(i2c_bus_profile_entry_t *out, size_t max, uint64_t *window_us);
+
+/**
+ * @brief Zera os contadores e reinicia a janela de ocupação
+ */
+void i2c_bus_profile_reset(void);
+
+/**
+ * @brief Imprime o relatório por dispositivo na saída padrão (USB serial)
+ */
+void i2c_bus_profile_report(void);
+
+#else
+
+static inline void i2c_bus_profile_record(const i2c_txn_t *txn, bool ok, uint32_t elapsed_us) {
+    (void)txn; (void)ok; (void)elapsed_us;
+}
+static inline size_t i2c_bus_profile_snapshot(i2c_bus_profile_entry_t *out, size_t max,
+                                              uint64_t *window_us) {
+    (void)out; (void)max;
+    if (window_us) *window_us = 0;
+    return 0;
+}
+static inline void i2c_bus_profile_reset(void) {}
+static inline void i2c_bus_profile_report(void) {}
+
+#endif // I2C_BUS_PROFILE
+
+#endif // I2C_BUS_PROFILE_H
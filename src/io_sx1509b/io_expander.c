@@ -1,88 +1,555 @@
 #include "io_expander.h"
-#include "hardware/i2c.h"
+#include "i2c_bus.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
 #include "pico/stdlib.h"
 
 // Definições de hardware
-#define EXPANDER_I2C i2c0
 #define EXPANDER_ADDR 0x3E
+#define EXPANDER_I2C_MAX_HZ I2C_BUS_FAST_HZ
+
+// Expansor no barramento compartilhado
+static const i2c_bus_device_t expander_dev = I2C_BUS_DEVICE(EXPANDER_ADDR, EXPANDER_I2C_MAX_HZ);
 
 // Registradores do expansor
 typedef enum {
+    REG_INPUT_DISABLE_B = 0x00,
+    REG_PULL_UP_B = 0x06,
+    REG_OPEN_DRAIN_B = 0x0A,
     REG_DIR_B = 0x0E,
     REG_DIR_A = 0x0F,
     REG_DATA_B = 0x10,
-    REG_DATA_A = 0x11
+    REG_DATA_A = 0x11,
+    REG_INTERRUPT_MASK_A = 0x13,
+    REG_SENSE_LOW_A = 0x17,       // pinos 0-3 do banco A, 2 bits por pino
+    REG_INTERRUPT_SOURCE_A = 0x19,
+    REG_CLOCK = 0x1E,
+    REG_MISC = 0x1F,
+    REG_LED_DRIVER_ENABLE_B = 0x20,
+    REG_DEBOUNCE_CONFIG = 0x22,
+    REG_DEBOUNCE_ENABLE_A = 0x24
 } expander_reg_t;
 
+// Botões nos bits 0-2 do banco A
+#define BUTTON_MASK 0x07
+// RegSenseLowA: 11 = interrupção nas duas bordas, para os pinos 0-2
+#define SENSE_BOTH_EDGES_PINS_0_2 0x3F
+// RegClock: oscilador interno de 2 MHz (necessário para o debounce e os LEDs)
+#define CLOCK_INTERNAL_2MHZ 0x40
+// RegMisc: ClkX = fOSC / 2^(4-1) = 250 kHz para o driver de LED, modo linear
+#define MISC_LED_CLKX_250KHZ 0x40
+// RegMisc bit 0 = 1: NINT e RegInterruptSource só são limpos escrevendo na
+// fonte. Com 0 (reset) ler RegData já limpa a fonte, e a leitura do NINT
+// (RegData antes de RegInterruptSource) sempre encontraria a fonte zerada
+#define MISC_NINT_CLEAR_ON_WRITE 0x01
+#define MISC_VALUE (MISC_LED_CLKX_250KHZ | MISC_NINT_CLEAR_ON_WRITE)
+
+// Pinos dos LEDs RGB: banco A 5-7 (LED1), banco B 8-10 (LED2) e 13-15 (LED3)
+#define LED_PINS_A 0xE0
+#define LED_PINS_B 0xE7
+
+// Registradores por pino do driver de LED: TOn, IOn, Off e, nos pinos 4-7 e
+// 12-15, também TRise e TFall
+#define LED_REG_TON   0
+#define LED_REG_ION   1
+#define LED_REG_OFF   2
+#define LED_REG_TRISE 3
+#define LED_REG_TFALL 4
+#define LED_HAS_FADE(pin) (((pin) & 0x04) != 0)
+#define LED_REG_COUNT(pin) (LED_HAS_FADE(pin) ? 5 : 3)
+
+// Passos de tempo com ClkX = 250 kHz, em microssegundos: TOn/TOff valem
+// 64 * 255 / ClkX por código de 1-15 e 512 * 255 / ClkX de 16-31. TRise/TFall
+// dependem da excursão de intensidade: (IOn - 4 * IOff) * 255 / ClkX por código,
+// 16 vezes isso de 16-31
+#define LED_TIME_STEP_SHORT_US 65280u
+#define LED_TIME_STEP_LONG_US  522240u
+#define LED_FADE_STEP_US       1020u   // por unidade de intensidade
+
+// Bancos: os registradores do banco B ficam no endereço anterior ao do banco A,
+// então um par B/A pode ser escrito em uma única transação com auto-incremento
+#define BANK_B 0
+#define BANK_A 1
+#define PIN_BANK(pin) ((pin) < 8 ? BANK_A : BANK_B)
+
+// Cópia em RAM de DIR e DATA dos dois bancos. `shadow_*` é o valor desejado e
+// `chip_*` o último valor escrito (ou lido) no SX1509; só as diferenças vão ao barramento
+static uint8_t shadow_dir[2], shadow_data[2];
+static uint8_t chip_dir[2], chip_data[2];
+static bool shadow_loaded = false;
+
+// Cópia dos registradores do driver de LED de cada pino (valores de reset:
+// TOn 0, IOn 0xFF, Off 0, TRise 0, TFall 0), para só escrever o que muda
+static uint8_t led_shadow[16][5];
+static bool led_driver_enabled = false;
+
+// Fila de eventos dos botões: um produtor e um consumidor, sem travas. Só o
+// produtor escreve event_head e só o consumidor escreve event_tail
+static io_expander_event_t event_queue[IO_EXPANDER_EVENT_QUEUE_SIZE];
+static volatile uint8_t event_head = 0;
+static volatile uint8_t event_tail = 0;
+static uint32_t dropped_events = 0;
+
+// Atendimento do NINT pela fila do I2C, com prioridade alta: uma leitura de
+// DATA_B a INTERRUPT_SOURCE_A (0x10-0x19) e depois a limpeza da fonte. Exige
+// RegMisc bit 0 = 1, senão a leitura de RegData zera a fonte antes de ela ser lida
+#define NINT_READ_LEN (REG_INTERRUPT_SOURCE_A - REG_DATA_B + 1)
+static const uint8_t nint_read_reg = REG_DATA_B;
+static uint8_t nint_regs[NINT_READ_LEN];
+static uint8_t nint_clear[2] = {REG_INTERRUPT_SOURCE_A, 0};
+static i2c_txn_t nint_read_txn;
+static i2c_txn_t nint_clear_txn;
+
+// Leitura do NINT em andamento e instante da borda que a disparou
+static volatile bool nint_busy = false;
+// A limpeza da fonte falhou: o próximo atendimento só repete a limpeza. Reler
+// a fonte com os mesmos níveis viraria uma borda dupla falsa
+static volatile bool nint_clear_pending = false;
+static uint32_t nint_time_us = 0;
+static uint8_t last_buttons = 0;
 // Comunicação I2C
-static void write_expander_reg(uint8_t reg, uint8_t value) {
-    uint8_t buffer[2] = {reg, value};
-    i2c_write_blocking(EXPANDER_I2C, EXPANDER_ADDR, buffer, 2, false);
+// Escreve `len` registradores consecutivos a partir de `reg` (auto-incremento do SX1509)
+// Retorna false se a transação falhou (NACK ou prazo do barramento vencido)
+static bool write_expander_regs(uint8_t reg, const uint8_t *values, uint8_t len) {
+    uint8_t buffer[1 + 5];
+    buffer[0] = reg;
+    for (uint8_t i = 0; i < len; i++)
+        buffer[1 + i] = values[i];
+    return i2c_bus_write(&expander_dev, buffer, 1 + len) == 1 + len;
+}
+
+// Lê `len` registradores consecutivos a partir de `reg`
+static bool read_expander_regs(uint8_t reg, uint8_t *values, uint8_t len) {
+    return i2c_bus_write_read(&expander_dev, &reg, 1, values, len) == len;
 }
 
-static uint8_t read_expander_reg(uint8_t reg) {
-    uint8_t value;
-    i2c_write_blocking(EXPANDER_I2C, EXPANDER_ADDR, &reg, 1, true);
-    i2c_read_blocking(EXPANDER_I2C, EXPANDER_ADDR, &value, 1, false);
-    return value;
+static bool read_expander_reg(uint8_t reg, uint8_t *value) {
+    return read_expander_regs(reg, value, 1);
 }
 
-// Controle de pinos
+// Carrega a cópia em RAM uma única vez: DIR_B, DIR_A, DATA_B e DATA_A são
+// consecutivos e vêm em uma só leitura. Se a leitura falha, parte dos valores
+// de reset (0xFF) e marca o chip como divergente em tudo, para que o próximo
+// envio reescreva os dois bancos
+static void shadow_load(void) {
+    if (shadow_loaded)
+        return;
+    uint8_t regs[4];
+    if (read_expander_regs(REG_DIR_B, regs, 4)) {
+        chip_dir[BANK_B] = shadow_dir[BANK_B] = regs[0];
+        chip_dir[BANK_A] = shadow_dir[BANK_A] = regs[1];
+        chip_data[BANK_B] = shadow_data[BANK_B] = regs[2];
+        chip_data[BANK_A] = shadow_data[BANK_A] = regs[3];
+    } else {
+        for (uint8_t bank = 0; bank < 2; bank++) {
+            shadow_dir[bank] = shadow_data[bank] = 0xFF;
+            chip_dir[bank] = chip_data[bank] = 0x00;
+        }
+    }
+    shadow_loaded = true;
+}
+
+// Envia um par de registradores B/A que mudou: um banco em uma escrita simples,
+// os dois em uma escrita com auto-incremento a partir do registrador do banco B
+static void flush_pair(uint8_t reg_b, const uint8_t *shadow, uint8_t *chip) {
+    bool dirty_b = shadow[BANK_B] != chip[BANK_B];
+    bool dirty_a = shadow[BANK_A] != chip[BANK_A];
+
+    bool ok = true;
+    if (dirty_b && dirty_a)
+        ok = write_expander_regs(reg_b, shadow, 2);
+    else if (dirty_b)
+        ok = write_expander_regs(reg_b, &shadow[BANK_B], 1);
+    else if (dirty_a)
+        ok = write_expander_regs(reg_b + 1, &shadow[BANK_A], 1);
+
+    // Numa falha a cópia do chip fica como estava e o próximo envio tenta de novo
+    if (ok) {
+        chip[BANK_B] = shadow[BANK_B];
+        chip[BANK_A] = shadow[BANK_A];
+    }
+}
+
+// Controle de pinos (só na cópia em RAM; o envio é feito por flush_pair)
 static void set_pin_state(uint8_t pin, bool active) {
-    expander_reg_t reg = (pin < 8) ? REG_DATA_A : REG_DATA_B;
     uint8_t bit_mask = 1 << (pin % 8);
-    uint8_t current = read_expander_reg(reg);
 
     if (active) {
-        current &= ~bit_mask;  // Ativa com nível baixo
+        shadow_data[PIN_BANK(pin)] &= ~bit_mask;  // Ativa com nível baixo
     } else {
-        current |= bit_mask;   // Desativa com nível alto
+        shadow_data[PIN_BANK(pin)] |= bit_mask;   // Desativa com nível alto
     }
-    write_expander_reg(reg, current);
 }
 
 // Implementação das funções públicas
 void io_expander_init_buttons() {
-    uint8_t dir_a = read_expander_reg(REG_DIR_A);
-    dir_a |= 0x07;  // Configura bits 0-2 como entradas
-    write_expander_reg(REG_DIR_A, dir_a);
+    shadow_load();
+    shadow_dir[BANK_A] |= 0x07;  // Configura bits 0-2 como entradas
+    flush_pair(REG_DIR_B, shadow_dir, chip_dir);
 }
 
 void io_expander_init_leds() {
+    shadow_load();
     // LED1 (pinos 5-7)
-    uint8_t dir_a = read_expander_reg(REG_DIR_A);
-    dir_a &= ~0xE0;  // Configura como saída
+    shadow_dir[BANK_A] &= ~0xE0;  // Configura como saída
     
     // LED2 (pinos 8-10) e LED3 (pinos 13-15)
-    uint8_t dir_b = read_expander_reg(REG_DIR_B);
-    dir_b &= ~0x07;  // LED2
-    dir_b &= ~0xE0;  // LED3
+    shadow_dir[BANK_B] &= ~0x07;  // LED2
+    shadow_dir[BANK_B] &= ~0xE0;  // LED3
     
-    write_expander_reg(REG_DIR_A, dir_a);
-    write_expander_reg(REG_DIR_B, dir_b);
+    flush_pair(REG_DIR_B, shadow_dir, chip_dir);
+}
+
+// Enfileira um evento (lado produtor)
+static void push_event(uint8_t button, bool pressed, uint32_t time_us) {
+    uint8_t head = event_head;
+    if ((uint8_t)(head - event_tail) >= IO_EXPANDER_EVENT_QUEUE_SIZE) {
+        dropped_events++;
+        return;
+    }
+    io_expander_event_t *ev = &event_queue[head & (IO_EXPANDER_EVENT_QUEUE_SIZE - 1)];
+    ev->button = button;
+    ev->pressed = pressed;
+    ev->time_us = time_us;
+    __mem_fence_release(); // o evento fica visível antes do novo head
+    event_head = head + 1;
 }
 
+// Retira o evento mais antigo (lado consumidor)
+bool io_expander_pop_event(io_expander_event_t *event) {
+    uint8_t tail = event_tail;
+    if (tail == event_head)
+        return false;
+    __mem_fence_acquire();
+    *event = event_queue[tail & (IO_EXPANDER_EVENT_QUEUE_SIZE - 1)];
+    event_tail = tail + 1;
+    return true;
+}
+
+// Enfileira a leitura do NINT, ou só a limpeza pendente da fonte
+// (interrupções desabilitadas ou em IRQ)
+static void nint_start(void) {
+    nint_busy = true;
+    i2c_txn_t *txn = &nint_clear_txn;
+    if (!nint_clear_pending) {
+        nint_time_us = time_us_32();
+        txn = &nint_read_txn;
+    }
+    if (!i2c_bus_submit(txn))
+        nint_busy = false;
+}
+
+// IRQ do GPIO: enfileira a leitura com prioridade alta; ela passa à frente
+// de trechos do display e de transações de sensores ainda na fila
+static void nint_irq_callback(uint gpio, uint32_t events) {
+    if (gpio != IO_EXPANDER_NINT_GPIO || !(events & GPIO_IRQ_EDGE_FALL))
+        return;
+    if (!nint_busy)
+        nint_start();
+}
+
+// Fim da limpeza da fonte (IRQ do I2C). Uma borda nova entre a leitura e a
+// limpeza mantém o NINT baixo sem nova descida: atende de novo. Numa falha
+// a fonte continua com os bits já tratados e io_expander_service() repete
+// só a limpeza
+static void nint_clear_done(i2c_txn_t *txn, bool ok) {
+    (void)txn;
+    nint_busy = false;
+    nint_clear_pending = !ok;
+    if (ok && !gpio_get(IO_EXPANDER_NINT_GPIO))
+        nint_start();
+}
+
+// Fim da leitura (IRQ do I2C): enfileira uma borda por botão que mudou e
+// limpa a fonte de interrupção
+static void nint_read_done(i2c_txn_t *txn, bool ok) {
+    (void)txn;
+    if (!ok) {
+        nint_busy = false; // io_expander_service() tenta de novo
+        return;
+    }
+    uint8_t source = nint_regs[REG_INTERRUPT_SOURCE_A - REG_DATA_B] & BUTTON_MASK;
+    uint8_t buttons = nint_regs[REG_DATA_A - REG_DATA_B] & BUTTON_MASK;
+
+    // Uma borda dupla rápida aparece na fonte sem mudar o nível: vira
+    // pressionar + soltar (ou o contrário) no mesmo instante
+    for (uint8_t button = 0; button < 3; button++) {
+        uint8_t bit = 1 << button;
+        if (!(source & bit))
+            continue;
+        bool now = buttons & bit;
+        if (now == (bool)(last_buttons & bit))
+            push_event(button, !now, nint_time_us);
+        push_event(button, now, nint_time_us);
+    }
+    last_buttons = buttons;
+
+    nint_clear[1] = source;
+    if (!source || !i2c_bus_submit(&nint_clear_txn))
+        nint_busy = false;
+}
+
+void io_expander_init_button_irq(void) {
+    io_expander_init_buttons();
+
+    // Debounce no próprio SX1509: exige o oscilador interno ligado. A fonte
+    // de interrupção só é limpa por escrita (RegMisc bit 0)
+    uint8_t clock = CLOCK_INTERNAL_2MHZ;
+    uint8_t misc = MISC_VALUE;
+    uint8_t debounce = IO_EXPANDER_DEBOUNCE & 0x07;
+    uint8_t debounce_enable = BUTTON_MASK;
+    write_expander_regs(REG_CLOCK, &clock, 1);
+    write_expander_regs(REG_MISC, &misc, 1);
+    write_expander_regs(REG_DEBOUNCE_CONFIG, &debounce, 1);
+    write_expander_regs(REG_DEBOUNCE_ENABLE_A, &debounce_enable, 1);
+
+    // Interrupção nas duas bordas dos botões (máscara em 0 habilita)
+    uint8_t sense = SENSE_BOTH_EDGES_PINS_0_2;
+    uint8_t mask = (uint8_t)~BUTTON_MASK;
+    write_expander_regs(REG_SENSE_LOW_A, &sense, 1);
+    write_expander_regs(REG_INTERRUPT_MASK_A, &mask, 1);
+
+    // Estado inicial e fonte limpa, para o NINT começar em repouso
+    uint8_t data;
+    last_buttons = read_expander_reg(REG_DATA_A, &data) ? (data & BUTTON_MASK) : 0;
+    uint8_t clear = 0xFF;
+    write_expander_regs(REG_INTERRUPT_SOURCE_A, &clear, 1);
+
+    nint_read_txn = (i2c_txn_t){
+        .dev = &expander_dev,
+        .tx = &nint_read_reg, .tx_len = 1,
+        .rx = nint_regs, .rx_len = NINT_READ_LEN,
+        .restart = true,
+        .prio = I2C_BUS_PRIO_HIGH,
+        .callback = nint_read_done,
+    };
+    nint_clear_txn = (i2c_txn_t){
+        .dev = &expander_dev,
+        .tx = nint_clear, .tx_len = sizeof(nint_clear),
+        .prio = I2C_BUS_PRIO_HIGH,
+        .callback = nint_clear_done,
+    };
+
+    // NINT é open-drain: pull-up no RP2040 e IRQ na borda de descida
+    gpio_init(IO_EXPANDER_NINT_GPIO);
+    gpio_set_dir(IO_EXPANDER_NINT_GPIO, GPIO_IN);
+    gpio_pull_up(IO_EXPANDER_NINT_GPIO);
+    gpio_set_irq_enabled_with_callback(IO_EXPANDER_NINT_GPIO, GPIO_IRQ_EDGE_FALL, true,
+                                       &nint_irq_callback);
+}
+
+// Retoma o atendimento se uma leitura ou a limpeza falhou e o NINT continua
+// baixo (sem nova borda de descida a IRQ do GPIO não dispararia de novo)
+void io_expander_service(void) {
+    if (nint_busy || gpio_get(IO_EXPANDER_NINT_GPIO))
+        return;
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (!nint_busy)
+        nint_start();
+    restore_interrupts(irq_state);
+}
+
+bool io_expander_event_pending(void) {
+    return nint_busy || event_head != event_tail;
+}
+
+uint32_t io_expander_dropped_events(void) {
+    return dropped_events;
+}
+
+// Endereço do RegTOn de um pino; os blocos têm 3 ou 5 registradores
+static uint8_t led_base_reg(uint8_t pin) {
+    static const uint8_t group_base[4] = {0x29, 0x35, 0x49, 0x55};
+    uint8_t stride = LED_HAS_FADE(pin) ? 5 : 3;
+    return group_base[pin >> 2] + stride * (pin & 0x03);
+}
+
+// Converte um tempo em ms para o código de 5 bits, dados os passos curto (1-15)
+// e longo (16-31) do registrador. O código n vale n passos curtos ou n passos
+// longos, então entre 15 curtos e 16 longos há um buraco (ex.: ~0,98 s a
+// ~8,4 s em TOn): vale o extremo mais próximo
+static uint8_t led_code(uint16_t ms, uint32_t step_short_us, uint32_t step_long_us) {
+    if (ms == 0 || step_short_us == 0)
+        return 0;
+    uint32_t us = (uint32_t)ms * 1000u;
+
+    uint32_t short_code = (us + step_short_us / 2) / step_short_us;
+    if (short_code < 1) short_code = 1;
+    if (short_code > 15) short_code = 15;
+    uint32_t long_code = (us + step_long_us / 2) / step_long_us;
+    if (long_code < 16) long_code = 16;
+    if (long_code > 31) long_code = 31;
+
+    uint32_t short_us = short_code * step_short_us;
+    uint32_t long_us = long_code * step_long_us;
+    uint32_t short_err = us > short_us ? us - short_us : short_us - us;
+    uint32_t long_err = us > long_us ? us - long_us : long_us - us;
+    return (uint8_t)(short_err <= long_err ? short_code : long_code);
+}
+
+// Código de TOn/TOff
+static uint8_t led_time_code(uint16_t ms) {
+    return led_code(ms, LED_TIME_STEP_SHORT_US, LED_TIME_STEP_LONG_US);
+}
+
+// Código de TRise/TFall para uma excursão de intensidade
+static uint8_t led_fade_code(uint16_t ms, uint8_t on_intensity, uint8_t off_level) {
+    int32_t span = (int32_t)on_intensity - 4 * off_level;
+    if (span <= 0)
+        return 0;
+    uint32_t step = (uint32_t)span * LED_FADE_STEP_US;
+    return led_code(ms, step, 16u * step);
+}
+
+// Escreve o bloco de registradores de um pino, em uma transação com
+// auto-incremento e só se algo mudou
+static void led_write_pin(uint8_t pin, const uint8_t regs[5]) {
+    uint8_t count = LED_REG_COUNT(pin);
+    bool changed = false;
+    for (uint8_t i = 0; i < count; i++)
+        changed |= led_shadow[pin][i] != regs[i];
+    if (!changed)
+        return;
+    if (!write_expander_regs(led_base_reg(pin), regs, count))
+        return; // a cópia não muda: a próxima chamada reenvia
+    for (uint8_t i = 0; i < count; i++)
+        led_shadow[pin][i] = regs[i];
+}
+
+// Lê, altera e escreve um par de registradores B/A em duas transações no total
+// (sem a leitura não há como preservar os outros bits: não escreve)
+static bool update_pair(uint8_t reg_b, uint8_t set_b, uint8_t clear_b, uint8_t set_a, uint8_t clear_a) {
+    uint8_t regs[2];
+    if (!read_expander_regs(reg_b, regs, 2))
+        return false;
+    regs[0] = (regs[0] & ~clear_b) | set_b;
+    regs[1] = (regs[1] & ~clear_a) | set_a;
+    return write_expander_regs(reg_b, regs, 2);
+}
+
+// Sequência do datasheet: buffer de entrada desligado, sem pull-up, dreno
+// aberto, saída, oscilador, ClkX do driver e driver habilitado nos pinos
+void io_expander_init_led_driver(void) {
+    io_expander_init_leds();
+
+    update_pair(REG_INPUT_DISABLE_B, LED_PINS_B, 0, LED_PINS_A, 0);
+    update_pair(REG_PULL_UP_B, 0, LED_PINS_B, 0, LED_PINS_A);
+    update_pair(REG_OPEN_DRAIN_B, LED_PINS_B, 0, LED_PINS_A, 0);
+
+    uint8_t clock = CLOCK_INTERNAL_2MHZ;
+    uint8_t misc = MISC_VALUE;
+    write_expander_regs(REG_CLOCK, &clock, 1);
+    write_expander_regs(REG_MISC, &misc, 1);
+    bool enabled = update_pair(REG_LED_DRIVER_ENABLE_B, LED_PINS_B, 0, LED_PINS_A, 0);
+
+    // Registradores por pino no valor de reset
+    for (uint8_t pin = 0; pin < 16; pin++) {
+        led_shadow[pin][LED_REG_TON] = 0;
+        led_shadow[pin][LED_REG_ION] = 0xFF;
+        led_shadow[pin][LED_REG_OFF] = 0;
+        led_shadow[pin][LED_REG_TRISE] = 0;
+        led_shadow[pin][LED_REG_TFALL] = 0;
+    }
+    // Sem o driver os LEDs seguem funcionando só acesos/apagados
+    led_driver_enabled = enabled;
+}
+
+// Configura o bloco do pino e liga (nível baixo) ou desliga o pino na cópia de DATA
+static void led_apply(uint8_t pin, uint8_t on_intensity, uint8_t off_intensity, uint16_t on_ms,
+                      uint16_t off_ms, uint16_t rise_ms, uint16_t fall_ms) {
+    shadow_load();
+    if (led_driver_enabled) {
+        uint8_t off_level = off_intensity / 4;
+        if (off_level > 7) off_level = 7;
+        uint8_t regs[5];
+        regs[LED_REG_TON] = led_time_code(on_ms);
+        regs[LED_REG_ION] = on_intensity;
+        regs[LED_REG_OFF] = (uint8_t)(led_time_code(off_ms) << 3) | off_level;
+        regs[LED_REG_TRISE] = LED_HAS_FADE(pin) ? led_fade_code(rise_ms, on_intensity, off_level) : 0;
+        regs[LED_REG_TFALL] = LED_HAS_FADE(pin) ? led_fade_code(fall_ms, on_intensity, off_level) : 0;
+        led_write_pin(pin, regs);
+    }
+    // Sem o driver habilitado, qualquer intensidade acende o pino por inteiro
+    set_pin_state(pin, on_intensity != 0 || (led_driver_enabled && on_ms != 0));
+}
+
+void io_expander_led_set_intensity(uint8_t pin, uint8_t intensity) {
+    led_apply(pin, intensity, 0, 0, 0, 0, 0);
+    flush_pair(REG_DATA_B, shadow_data, chip_data);
+}
+
+void io_expander_led_blink(uint8_t pin, uint8_t on_intensity, uint8_t off_intensity,
+                           uint16_t on_ms, uint16_t off_ms) {
+    led_apply(pin, on_intensity, off_intensity, on_ms, off_ms, 0, 0);
+    flush_pair(REG_DATA_B, shadow_data, chip_data);
+}
+
+void io_expander_led_breathe(uint8_t pin, uint8_t on_intensity, uint8_t off_intensity,
+                             uint16_t on_ms, uint16_t off_ms, uint16_t rise_ms, uint16_t fall_ms) {
+    led_apply(pin, on_intensity, off_intensity, on_ms, off_ms, rise_ms, fall_ms);
+    flush_pair(REG_DATA_B, shadow_data, chip_data);
+}
+
+void set_rgb_led_pwm(rgb_led_t led, uint8_t r, uint8_t g, uint8_t b) {
+    led_apply(led, r, 0, 0, 0, 0, 0);
+    led_apply(led + 1, g, 0, 0, 0, 0, 0);
+    led_apply(led + 2, b, 0, 0, 0, 0, 0);
+    flush_pair(REG_DATA_B, shadow_data, chip_data);
+}
+
+// Aceso por inteiro ou apagado só pelo bit de DATA. O bloco do pino fica como
+// está (IOn 255 após a inicialização); só é reescrito para aceso fixo se uma
+// intensidade ou um padrão anterior o deixou em outro valor
+static void led_set_on_off(uint8_t pin, bool on) {
+    static const uint8_t steady_on[5] = {0, 0xFF, 0, 0, 0};
+    if (on && led_driver_enabled)
+        led_write_pin(pin, steady_on);
+    set_pin_state(pin, on);
+}
+
+// Uma troca de cor custa no máximo uma transação (nenhuma se a cor não mudou)
 void set_rgb_led(rgb_led_t led, bool r, bool g, bool b) {
     switch(led) {
         case RGB_LED_1:
-            set_pin_state(led, r);
-            set_pin_state(led + 1, g);
-            set_pin_state(led + 2, b);
-            break;
         case RGB_LED_2:
-            set_pin_state(led, r);
-            set_pin_state(led + 1, g);
-            set_pin_state(led + 2, b);
-            break;
         case RGB_LED_3:
-            set_pin_state(led, r);
-            set_pin_state(led + 1, g);
-            set_pin_state(led + 2, b);
+            shadow_load();
+            led_set_on_off(led, r);
+            led_set_on_off(led + 1, g);
+            led_set_on_off(led + 2, b);
+            flush_pair(REG_DATA_B, shadow_data, chip_data);
             break;
     }
 }
 
+// Descrição de um padrão para um canal: intensidades e tempos
+typedef struct {
+    uint8_t on_intensity, off_intensity;
+    uint16_t on_ms, off_ms, rise_ms, fall_ms;
+} led_pattern_channel_t;
+
+// Canais R, G e B de cada padrão
+static const led_pattern_channel_t led_patterns[][3] = {
+    [LED_PATTERN_OFF]      = {{0}, {0}, {0}},
+    [LED_PATTERN_SAMPLING] = {{0}, {96, 0, 500, 1000, 1000, 1000}, {0}},
+    [LED_PATTERN_ALARM]    = {{255, 0, 130, 130, 0, 0}, {0}, {0}},
+    [LED_PATTERN_FLUSHING] = {{0}, {0}, {160, 0, 260, 260, 0, 0}},
+};
+
+void set_rgb_led_pattern(rgb_led_t led, led_pattern_t pattern) {
+    if (pattern > LED_PATTERN_FLUSHING)
+        return;
+    for (uint8_t ch = 0; ch < 3; ch++) {
+        const led_pattern_channel_t *p = &led_patterns[pattern][ch];
+        led_apply(led + ch, p->on_intensity, p->off_intensity, p->on_ms, p->off_ms,
+                  p->rise_ms, p->fall_ms);
+    }
+    flush_pair(REG_DATA_B, shadow_data, chip_data);
+}
+
 uint8_t read_button_status() {
-    uint8_t data = read_expander_reg(REG_DATA_A);
+    uint8_t data;
+    if (!read_expander_reg(REG_DATA_A, &data))
+        return 0;        // Falha no barramento: nenhum botão pressionado
     return data & 0x07;  // Retorna apenas os bits dos botões
-}
\ No newline at end of file
+}
@@ -11,11 +11,81 @@ typedef enum {
     RGB_LED_3 = 13
 } rgb_led_t;
 
+// Pino do RP2040 ligado ao NINT (saída open-drain, ativa em nível baixo) do SX1509.
+// Na placa é o GPIO 6 (pinagem no README); o CMakeLists.txt define o valor e
+// este padrão só vale para builds que não o definem
+#ifndef IO_EXPANDER_NINT_GPIO
+#define IO_EXPANDER_NINT_GPIO 6
+#endif
+
+// Tempo de debounce do próprio SX1509 (RegDebounceConfig): 0 = 0,5 ms ... 7 = 64 ms,
+// dobrando a cada passo (oscilador interno de 2 MHz)
+#ifndef IO_EXPANDER_DEBOUNCE
+#define IO_EXPANDER_DEBOUNCE 5 // 16 ms
+#endif
+
+// Capacidade da fila de eventos dos botões (potência de 2)
+#define IO_EXPANDER_EVENT_QUEUE_SIZE 16
+
+// Evento de borda em um botão
+typedef struct {
+    uint8_t button;     // 0 a 2 (bit em read_button_status())
+    bool pressed;       // true na borda de subida (botão pressionado)
+    uint32_t time_us;   // instante da interrupção (time_us_32)
+} io_expander_event_t;
+
+// Padrões de status executados pelo driver de LED do SX1509 (sem tráfego contínuo)
+typedef enum {
+    LED_PATTERN_OFF = 0,
+    LED_PATTERN_SAMPLING,   // verde "respirando" devagar
+    LED_PATTERN_ALARM,      // vermelho piscando rápido
+    LED_PATTERN_FLUSHING    // azul piscando em ritmo médio
+} led_pattern_t;
+
 // Protótipos das funções
+// DIR e DATA ficam em cópia na RAM: só os bancos alterados são escritos,
+// e os dois bancos juntos vão em uma única transação
 void io_expander_init_buttons();
 void io_expander_init_leds();
 void set_rgb_led(rgb_led_t led, bool red, bool green, bool blue);
 
 uint8_t read_button_status();
 
+// --- BOTÕES POR INTERRUPÇÃO ---
+// Liga interrupção por borda, debounce no SX1509 e a IRQ do pino NINT
+void io_expander_init_button_irq(void);
+// O NINT é atendido nas interrupções: a IRQ do GPIO enfileira uma leitura de
+// prioridade alta na fila do I2C e o callback dela enfileira os eventos.
+// io_expander_service() só retoma o atendimento se uma leitura (ou a limpeza
+// da fonte) falhou com o NINT ainda baixo; com o NINT em repouso retorna sem
+// acessar o barramento
+void io_expander_service(void);
+// Indica se há leitura do NINT em andamento ou eventos na fila (não acessa o barramento)
+bool io_expander_event_pending(void);
+// Retira o evento mais antigo da fila; false se vazia
+bool io_expander_pop_event(io_expander_event_t *event);
+// Eventos descartados por fila cheia
+uint32_t io_expander_dropped_events(void);
+
+// --- DRIVER DE LED (PWM, PISCA E RESPIRAÇÃO) ---
+// Coloca os pinos dos três LEDs RGB no modo driver de LED do SX1509
+void io_expander_init_led_driver(void);
+// Intensidade fixa (0 a 255) de um pino; 0 apaga
+void io_expander_led_set_intensity(uint8_t pin, uint8_t intensity);
+// Pisca entre on_intensity por on_ms e off_intensity (0 a 28) por off_ms.
+// Tempos de ~65 ms a ~0,98 s em passos de ~65 ms e de ~8,4 s a ~16,2 s em
+// passos de ~0,52 s (limites do SX1509 com ClkX = 250 kHz). Cada tempo vai
+// para o passo mais próximo: entre ~0,98 s e ~8,4 s, para o mais próximo
+// desses dois extremos (até ~4,7 s fica em ~0,98 s)
+void io_expander_led_blink(uint8_t pin, uint8_t on_intensity, uint8_t off_intensity,
+                           uint16_t on_ms, uint16_t off_ms);
+// Pisca com subida e descida graduais; só nos pinos 4-7 e 12-15 (os demais
+// piscam sem rampa)
+void io_expander_led_breathe(uint8_t pin, uint8_t on_intensity, uint8_t off_intensity,
+                             uint16_t on_ms, uint16_t off_ms, uint16_t rise_ms, uint16_t fall_ms);
+// Cor com intensidade por canal (0 a 255)
+void set_rgb_led_pwm(rgb_led_t led, uint8_t r, uint8_t g, uint8_t b);
+// Padrão de status em um LED RGB; reaplicar o mesmo padrão não gera tráfego
+void set_rgb_led_pattern(rgb_led_t led, led_pattern_t pattern);
+
 #endif
\ No newline at end of file
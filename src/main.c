@@ -1,16 +1,19 @@
 #include <stdio.h>
-#include <math.h>
 #include "pico/stdlib.h"
-#include "hardware/i2c.h"
+#include "i2c_bus.h"
+#include "i2c_bus_profile.h"
 #include "ms5637.h"
+#include "ms5637_altitude.h"
+#include "ms5637_filter.h"
 #include "SHT4xl-PCEIoT-Board.h"
+#include "sht4x_heater.h"
 #include "ssd1306.h"
+#include "ssd1306_ui.h"
+#include "ssd1306_chart.h"
 #include "io_expander.h"
+#include "fixed_fmt.h"
 
-// Configurações I2C
-#define I2C_PORT i2c0
-#define I2C_SDA 4
-#define I2C_SCL 5
+// Endereço do display no barramento compartilhado (i2c_bus.h)
 #define SSD1306_ADDR 0x3C
 
 ssd1306_t display;
@@ -18,99 +21,184 @@ ssd1306_t display;
 // painel atual 
 static uint8_t current_panel = 1;
 
+// Modelos estáticos dos painéis (desenhados apenas ao trocar de painel)
+static const ssd1306_ui_static_t ms5637_template[] = {
+    {SSD1306_UI_TEXT, 30, 0, 0, "MS5637 02BA03"},
+    {SSD1306_UI_RULE, 0, 10, 128, NULL},
+    {SSD1306_UI_TEXT, 10, 15, 0, "Temperatura:"},
+    {SSD1306_UI_TEXT, 10, 27, 0, "Pressao:"},
+    {SSD1306_UI_TEXT, 10, 39, 0, "Altitude:"},
+    {SSD1306_UI_RULE, 0, 50, 128, NULL},
+    {SSD1306_UI_TEXT, 15, 55, 0, "Monitor Climatico 1"},
+};
+
+static const ssd1306_ui_static_t sht4x_template[] = {
+    {SSD1306_UI_TEXT, 30, 0, 0, "SHT4xl SENSOR"},
+    {SSD1306_UI_RULE, 0, 10, 128, NULL},
+    {SSD1306_UI_TEXT, 10, 15, 0, "Temperatura:"},
+    {SSD1306_UI_TEXT, 10, 27, 0, "Umidade:"},
+    {SSD1306_UI_RULE, 0, 50, 128, NULL},
+    {SSD1306_UI_TEXT, 15, 55, 0, "Monitor Climatico 2"},
+};
+
+static const ssd1306_ui_static_t trend_template[] = {
+    {SSD1306_UI_TEXT, 34, 0, 0, "TENDENCIAS"},
+    {SSD1306_UI_RULE, 0, 10, 128, NULL},
+    {SSD1306_UI_TEXT, 0, 20, 0, "hPa"},
+    {SSD1306_UI_TEXT, 0, 36, 0, "%UR"},
+    {SSD1306_UI_TEXT, 0, 52, 0, "m"},
+};
+
+// Campos de valor: 8 caracteres a partir de x = 80 ocupam até a borda do display
+static ssd1306_ui_field_t ms5637_fields[] = {
+    {80, 15, 8, ""}, // temperatura
+    {80, 27, 8, ""}, // pressão
+    {80, 39, 8, ""}, // altitude
+};
+
+static ssd1306_ui_field_t sht4x_fields[] = {
+    {80, 15, 8, ""}, // temperatura
+    {80, 27, 8, ""}, // umidade
+};
+
+static ssd1306_ui_panel_t ms5637_panel = {
+    ms5637_template, sizeof(ms5637_template) / sizeof(ms5637_template[0]),
+    ms5637_fields, sizeof(ms5637_fields) / sizeof(ms5637_fields[0]),
+};
+
+static ssd1306_ui_panel_t sht4x_panel = {
+    sht4x_template, sizeof(sht4x_template) / sizeof(sht4x_template[0]),
+    sht4x_fields, sizeof(sht4x_fields) / sizeof(sht4x_fields[0]),
+};
+
+static ssd1306_ui_panel_t trend_panel = {
+    trend_template, sizeof(trend_template) / sizeof(trend_template[0]),
+    NULL, 0,
+};
+
+// Históricos de pressão (Pa), umidade (centésimos de %UR) e altitude filtrada
+// pelo Kalman (cm), nas páginas 2-3, 4-5 e 6-7
+static ssd1306_chart_t pressure_chart;
+static ssd1306_chart_t humidity_chart;
+static ssd1306_chart_t altitude_chart;
+
+// Painel cujo modelo está no buffer (NULL após telas de erro/inicialização)
+static ssd1306_ui_panel_t *shown_panel = NULL;
+
 /**
- * @brief Calcula a altitude relativa, usando a fórmula barométrica 
- * @param pressure_hpa Pressão atual
- * @param baseline_hpa Pressão de referência
- * @return Altitude com base na posição inicial do sensor em metros
+ * @brief Garante que o modelo estático do painel está desenhado no buffer
+ * @param panel Painel a exibir
+ * @return true se o modelo acabou de ser (re)desenhado
  */
-static float calculate_altitude(float pressure_hpa, float baseline_hpa) {
-    return 44330.0f * (1.0f - powf(pressure_hpa / baseline_hpa, 1.0f / 5.255f));  
+static bool show_panel(ssd1306_t *disp, ssd1306_ui_panel_t *panel) {
+    if (shown_panel != panel) {
+        ssd1306_ui_panel_show(disp, panel);
+        shown_panel = panel;
+        return true;
+    }
+    return false;
+}
+
+// Erro de sensor nesta volta do laço (LED3 em alarme)
+static bool sensor_alarm = false;
+
+/**
+ * @brief Exibe uma mensagem de erro, descartando o painel atual
+ * @param msg Mensagem a exibir
+ */
+static void show_error(ssd1306_t *disp, const char *msg) {
+    sensor_alarm = true;
+    ssd1306_clear(disp);
+    ssd1306_draw_string(disp, 10, 20, msg);
+    ssd1306_display(disp);
+    shown_panel = NULL;
 }
 
 /****************************************************************************
  * @brief Painel demo de dados no display para o sensor MS5637_02BA03
- * @param temp Temperatura em °C
- * @param press Pressão em hPA / mbar
- * @param alt Altitude em metros
+ * @param temp_centi Temperatura em centésimos de °C
+ * @param press_pa Pressão em Pa (centésimos de hPA / mbar)
+ * @param alt_cm Altitude em centímetros
  */
-static void draw_ms5637_panel(ssd1306_t *disp, float temp, float press, float alt) {
+static void draw_ms5637_panel(ssd1306_t *disp, int32_t temp_centi, int32_t press_pa, int32_t alt_cm) {
     char buf[20];
-    ssd1306_clear(disp);
-    ssd1306_draw_string(disp, 30, 0, "MS5637 02BA03");
-    ssd1306_fill_rect(disp, 0, 10, 128, 1, true);
+    show_panel(disp, &ms5637_panel);
 
-    ssd1306_draw_string(disp, 10, 15, "Temperatura:");
-    snprintf(buf, sizeof(buf), "%.2f C", temp);
-    ssd1306_draw_string(disp, 80, 15, buf);
+    fixed_fmt(buf, sizeof(buf), temp_centi, 2, 2, 0, " C");
+    ssd1306_ui_field_set(disp, &ms5637_fields[0], buf);
 
-    ssd1306_draw_string(disp, 10, 27, "Pressao:");
-    snprintf(buf, sizeof(buf), "%.2f hPa", press);
-    ssd1306_draw_string(disp, 80, 27, buf);
+    fixed_fmt(buf, sizeof(buf), press_pa, 2, 2, 0, " hPa");
+    ssd1306_ui_field_set(disp, &ms5637_fields[1], buf);
 
-    ssd1306_draw_string(disp, 10, 39, "Altitude:");
-    snprintf(buf, sizeof(buf), "%.2f m", alt);
-    ssd1306_draw_string(disp, 80, 39, buf);
+    fixed_fmt(buf, sizeof(buf), alt_cm, 2, 2, 0, " m");
+    ssd1306_ui_field_set(disp, &ms5637_fields[2], buf);
 
-    ssd1306_fill_rect(disp, 0, 50, 128, 1, true);
-    ssd1306_draw_string(disp, 15, 55, "Monitor Climatico 1");
-    ssd1306_display(disp);
+    ssd1306_display_async(disp, NULL);
 }
 
 /*********************************************************
  * @brief Painel demo de dados no display para o sensor SHT4xl
- * @param temp Temperatura em °C
- * @param hum  Umidade relativa em %
+ * @param temp_centi Temperatura em centésimos de °C
+ * @param hum_centi  Umidade relativa em centésimos de %
  */
-static void draw_sht4x_panel(ssd1306_t *disp, float temp, float hum) {
+static void draw_sht4x_panel(ssd1306_t *disp, int32_t temp_centi, int32_t hum_centi) {
     char buf[20];
-    ssd1306_clear(disp);
-    ssd1306_draw_string(disp, 30, 0, "SHT4xl SENSOR");
-    ssd1306_fill_rect(disp, 0, 10, 128, 1, true);
+    show_panel(disp, &sht4x_panel);
 
-    ssd1306_draw_string(disp, 10, 15, "Temperatura:");
-    snprintf(buf, sizeof(buf), "%.2f C", temp);
-    ssd1306_draw_string(disp, 80, 15, buf);
+    fixed_fmt(buf, sizeof(buf), temp_centi, 2, 2, 0, " C");
+    ssd1306_ui_field_set(disp, &sht4x_fields[0], buf);
 
-    ssd1306_draw_string(disp, 10, 27, "Umidade:");
-    snprintf(buf, sizeof(buf), "%.2f %%", hum);
-    ssd1306_draw_string(disp, 80, 27, buf);
+    fixed_fmt(buf, sizeof(buf), hum_centi, 2, 2, 0, " %");
+    ssd1306_ui_field_set(disp, &sht4x_fields[1], buf);
 
-    ssd1306_fill_rect(disp, 0, 50, 128, 1, true);
-    ssd1306_draw_string(disp, 15, 55, "Monitor Climatico 2");
-    ssd1306_display(disp);
+    ssd1306_display_async(disp, NULL);
+}
+
+/*********************************************************
+ * @brief Painel de tendências: históricos de pressão, umidade e altitude
+ */
+static void draw_trend_panel(ssd1306_t *disp) {
+    if (show_panel(disp, &trend_panel)) {
+        ssd1306_chart_invalidate(&pressure_chart);
+        ssd1306_chart_invalidate(&humidity_chart);
+        ssd1306_chart_invalidate(&altitude_chart);
+    }
+    ssd1306_chart_draw(disp, &pressure_chart);
+    ssd1306_chart_draw(disp, &humidity_chart);
+    ssd1306_chart_draw(disp, &altitude_chart);
+    ssd1306_display_async(disp, NULL);
 }
 
 int main() {
     stdio_init_all();
 
-    // Inicializa I2C
-    i2c_init(I2C_PORT, 400 * 1000);
-    gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(I2C_SDA);
-    gpio_pull_up(I2C_SCL);
+    // Inicializa o barramento I2C compartilhado; o clock é ajustado por dispositivo
+    i2c_bus_init();
 
     // Inicializa display
-    ssd1306_init(&display, I2C_PORT, SSD1306_ADDR);
+    ssd1306_init(&display, SSD1306_ADDR);
     ssd1306_clear(&display);
     ssd1306_draw_string(&display, 10, 20, "Inicializando...");
     ssd1306_display(&display);
 
     // Expansão I/O SX1509B (botões e leds) ---
-    io_expander_init_buttons();
-    io_expander_init_leds();
+    io_expander_init_button_irq();
+    io_expander_init_led_driver();
     
     // Inicia com o LED1 (RGB) indicando o painel MS5637
     set_rgb_led(RGB_LED_1, false, true, false); // r,g,b -> 0,1,0 => verde
+    // LED3 mostra o status: respirando em verde amostrando, vermelho piscando em erro.
+    // Os padrões rodam no próprio SX1509, sem tráfego enquanto não mudam
+    set_rgb_led_pattern(RGB_LED_3, LED_PATTERN_SAMPLING);
 
     // --- Sensores ---
 
     // Inicializa sensor ms5637
     ms5637_init();        
-    // Inicializa sensor SHT4x:
-    // Reset para validar comunicação (I2C já inicializado acima). melhoria futura: modificar a biblioteca para que sht4x_init() já teste a comunicação e retorne true se o sensor estiver respondendo, sem precisar chamar reset() no main.c, como foi feito com o ms5637_init().
-    if (!sht4x_reset()) {
+    // Só-pressão entre leituras de temperatura: D2 a cada 8 medições ou 2 s
+    ms5637_set_temperature_cache(8, 2000);
+    // Inicializa sensor SHT4x (o reset valida a comunicação)
+    if (!sht4x_init()) {
         ssd1306_clear(&display);
         ssd1306_draw_string(&display, 6, 20, "Erro init SHT4x!");
         ssd1306_display(&display);
@@ -118,79 +206,180 @@ int main() {
     }
 
     // Captura pressão de referência (baseline para altitude atual do sensor)
-    float baseline = 0.0f;
-    float temp_ms = 0.0f, press_ms = 0.0f;
+    int32_t baseline_pa = 0;
+    int32_t temp_ms = 0, press_ms = 0; // centésimos de °C, Pa
     uint32_t attempts = 0;
-    while (baseline == 0.0f && attempts < 20) { // tenta por ~10s
-        if (ms5637_read_temperature_pressure(&temp_ms, &press_ms) == MS5637_STATUS_OK) {
-            baseline = press_ms;
+    while (baseline_pa == 0 && attempts < 20) { // tenta por ~10s
+        if (ms5637_read_temperature_pressure_centi(&temp_ms, &press_ms) == MS5637_STATUS_OK) {
+            baseline_pa = press_ms;
         }
         attempts++;
         sleep_ms(500);
     }
-    if (baseline == 0.0f) {
+    if (baseline_pa == 0) {
         // fallback para valor padrão (opcional)
-        baseline = 1013.25f; // pressão ao nível do mar em hPa universal
+        baseline_pa = 101325; // pressão ao nível do mar em Pa universal
     }
 
-    // Variáveis SHT4x
-    float temp_sht = 0.0f, hum_sht = 0.0f;
+    // Pressão em OSR 2048 (5 ms, ~2,8 Pa RMS) e temperatura em OSR 8192: o ruído
+    // extra da conversão rápida fica por conta dos filtros abaixo
+    ms5637_set_osr_split(MS5637_OSR_2048, MS5637_OSR_8192);
+    // Pressão exibida: média móvel com peso 1/4; altitude: Kalman com ~24 cm de
+    // ruído de medida e 1 m/s² de aceleração vertical, amostras a cada ~180 ms
+    ms5637_ema_t pressure_ema;
+    ms5637_ema_init(&pressure_ema, 2);
+    ms5637_kalman_t altitude_kf;
+    ms5637_kalman_init(&altitude_kf, 180, 24, 100);
+    uint32_t last_alt_ms = to_ms_since_boot(get_absolute_time());
+
+    // Gráficos de tendência: escala mínima de 0,5 hPa, 2 %UR e 1 m
+    ssd1306_chart_init(&pressure_chart, 24, 2, 104, 2, 50);
+    ssd1306_chart_init(&humidity_chart, 24, 4, 104, 2, 200);
+    ssd1306_chart_init(&altitude_chart, 24, 6, 104, 2, 100);
+
+    // MS5637 medido em segundo plano: cada volta do laço avança a conversão
+    // D2/D1 em andamento e já inicia a próxima, sem esperar pelo ADC
+    ms5637_measure_start();
 
-    // Para debouncing / edge detection do botão
-    uint8_t prev_buttons = 0;
-    const uint32_t debounce_ms = 200;
+    // SHT4x medido em segundo plano pelo agendador, que também cuida dos
+    // pulsos do aquecedor quando a umidade satura (centésimos de °C e de %UR)
+    const sht4x_heater_config_t heater_config = SHT4X_HEATER_CONFIG_DEFAULT;
+    sht4x_heater_init(&heater_config);
+    sht4x_sample_t sht = {0};
+
+    // Textos da saída serial
+    char t_str[16], p_str[16], a_str[16], v_str[16];
+
+    // Falhas do barramento já informadas na serial
+    i2c_bus_stats_t bus_reported = {0};
 
     // Loop principal
     while (true) {
-        // lê botões do expander
-        uint8_t buttons = read_button_status();
+        // Prazo vencido no I2C: a liberação do barramento roda aqui, fora da IRQ
+        i2c_bus_service();
+
+        // O quadro anterior segue na fila do I2C (prioridade baixa) durante o
+        // atraso do fim do loop; botões e sensores passam à frente entre um
+        // trecho e outro. O próximo quadro só é desenhado após o término
+        ssd1306_flush_wait(&display);
 
-        // Detecta borda de subida do botão 0 (bit0)
-        bool btn0_now = buttons & 0x01;  // Bit 0
-        bool btn0_prev = prev_buttons & 0x01;
-        if (btn0_now && !btn0_prev) {
+        // Botões: bordas já filtradas pelo debounce do SX1509, lidas pela fila
+        // do I2C a partir da IRQ do NINT; aqui só se retoma uma leitura que falhou
+        io_expander_service();
+        io_expander_event_t ev;
+        while (io_expander_pop_event(&ev)) {
+            // Só a borda de subida do botão 0 interessa
+            if (ev.button != 0 || !ev.pressed)
+                continue;
             // alterna painel
-            current_panel = (current_panel + 1) % 2;
+            current_panel = (current_panel + 1) % 3;
             // atualiza LED indicando painel atual:
             if (current_panel == 0) {
                 // MS5637 -> verde
                 set_rgb_led(RGB_LED_1, 0, 1, 0); 
-            } else {
+            } else if (current_panel == 1) {
                 // SHT4x -> azul
                 set_rgb_led(RGB_LED_1, 0, 0, 1); 
+            } else {
+                // Tendências -> vermelho
+                set_rgb_led(RGB_LED_1, 1, 0, 0);
             }
-            // debounce simples
-            sleep_ms(debounce_ms);
         }
-        prev_buttons = buttons;
+
+        // SHT4x: avança medições e pulsos do aquecedor sem bloquear; só
+        // amostras não afetadas pelo aquecedor entram no histórico
+        SHT4x_Status sht_status = sht4x_heater_poll(&sht);
+        bool sht_new = (sht_status == SHT4X_STATUS_OK);
+        bool sht_failed = (sht_status == SHT4X_STATUS_ERROR || sht_status == SHT4X_STATUS_CRC_ERROR);
+        if (sht_new) ssd1306_chart_push(&humidity_chart, sht.hum_centi);
+
+        // MS5637: BUSY enquanto D2/D1 convertem (só consulta o prazo, sem
+        // tráfego); com o resultado pronto, ou uma falha, a próxima começa já
+        ms5637_status_t ms_status = ms5637_measure_poll(&temp_ms, &press_ms);
+        if (ms_status != MS5637_STATUS_BUSY)
+            ms5637_measure_start();
+        bool ms_new = (ms_status == MS5637_STATUS_OK);
+        bool ms_failed = !ms_new && ms_status != MS5637_STATUS_BUSY;
+        int32_t press_f = 0, alt_cm = 0;
+        if (ms_new) {
+            uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+            ms5637_kalman_update(&altitude_kf, ms5637_altitude_cm(press_ms, baseline_pa),
+                                 now_ms - last_alt_ms);
+            last_alt_ms = now_ms;
+            press_f = ms5637_ema_update(&pressure_ema, press_ms);
+            alt_cm = ms5637_kalman_altitude_cm(&altitude_kf);
+            ssd1306_chart_push(&pressure_chart, press_f);
+            ssd1306_chart_push(&altitude_chart, alt_cm);
+        }
 
         // Atualiza e mostra na serial conforme current_panel
         if (current_panel == 0) {
             // MS5637
-            if (ms5637_read_temperature_pressure(&temp_ms, &press_ms) == MS5637_STATUS_OK) {
-                float alt = calculate_altitude(press_ms, baseline);
-                draw_ms5637_panel(&display, temp_ms, press_ms, alt);
-                printf("[MS5637] T: %.2f C | P: %.2f hPa | Alt: %.2f m\n",
-                       temp_ms, press_ms, alt);
-            } else {
-                ssd1306_clear(&display);
-                ssd1306_draw_string(&display, 10, 20, "Erro MS5637!");
-                ssd1306_display(&display);
+            if (ms_new) {
+                draw_ms5637_panel(&display, temp_ms, press_f, alt_cm);
+                fixed_fmt(t_str, sizeof(t_str), temp_ms, 2, 2, 6, NULL);
+                fixed_fmt(p_str, sizeof(p_str), press_f, 2, 2, 7, NULL);
+                fixed_fmt(a_str, sizeof(a_str), alt_cm, 2, 2, 7, NULL);
+                fixed_fmt(v_str, sizeof(v_str), ms5637_kalman_speed_cm_s(&altitude_kf), 2, 2, 5, NULL);
+                printf("[MS5637] T: %s C | P: %s hPa | Alt: %s m | Vz: %s m/s\n", t_str, p_str, a_str, v_str);
+            } else if (ms_failed) {
+                show_error(&display, "Erro MS5637!");
             }
-        } else {
+        } else if (current_panel == 1) {
             // SHT4x
-            if (sht4x_read_temp_hum(PRECISION_HIGH, &temp_sht, &hum_sht)) {
-                draw_sht4x_panel(&display, temp_sht, hum_sht);
-                printf("[SHT4x] T: %.2f C | U: %.2f %%\n", temp_sht, hum_sht);
+            if (sht_new) {
+                draw_sht4x_panel(&display, sht.temp_centi, sht.hum_centi);
+                fixed_fmt(t_str, sizeof(t_str), sht.temp_centi, 2, 2, 6, NULL);
+                fixed_fmt(p_str, sizeof(p_str), sht.hum_centi, 2, 2, 6, NULL);
+                printf("[SHT4x] T: %s C | U: %s %%\n", t_str, p_str);
+            } else if (sht_status == SHT4X_STATUS_HEATER_AFFECTED) {
+                printf("[SHT4x] aquecedor ativo, amostra descartada (pulsos: %lu)\n",
+                       (unsigned long)sht4x_heater_pulse_count());
+            } else if (sht_failed) {
+                show_error(&display, "Erro SHT4x!");
+            }
+        } else {
+            // Tendências: os históricos já foram alimentados acima, pelas
+            // medições de segundo plano dos dois sensores
+            if (!ms_failed || !sht_failed) {
+                draw_trend_panel(&display);
             } else {
-                ssd1306_clear(&display);
-                ssd1306_draw_string(&display, 10, 20, "Erro SHT4x!");
-                ssd1306_display(&display);
+                show_error(&display, "Erro sensores!");
             }
         }
 
-        // pequeno atraso para responsividade + economia de CPU
-        sleep_ms(150);
+        set_rgb_led_pattern(RGB_LED_3, sensor_alarm ? LED_PATTERN_ALARM : LED_PATTERN_SAMPLING);
+        sensor_alarm = false;
+
+        // Cada transação tem prazo: um dispositivo travado custa no máximo um
+        // prazo por acesso e aparece aqui em vez de congelar o laço
+        i2c_bus_stats_t bus_stats;
+        i2c_bus_get_stats(&bus_stats);
+        if (bus_stats.timeouts != bus_reported.timeouts ||
+            bus_stats.recoveries != bus_reported.recoveries) {
+            printf("[I2C] prazos vencidos: %lu | liberacoes do barramento: %lu | NACKs: %lu\n",
+                   (unsigned long)bus_stats.timeouts, (unsigned long)bus_stats.recoveries,
+                   (unsigned long)bus_stats.aborts);
+            bus_reported = bus_stats;
+        }
+
+#if I2C_BUS_PROFILE
+        // Perfil do I2C sob demanda pela serial: 'p' imprime, 'r' zera
+        int cmd = getchar_timeout_us(0);
+        if (cmd == 'p' || cmd == 'P') {
+            i2c_bus_profile_report();
+        } else if (cmd == 'r' || cmd == 'R') {
+            i2c_bus_profile_reset();
+            printf("[I2C] perfil zerado\n");
+        }
+#endif
+
+        // pequeno atraso para economia de CPU; um botão (NINT) acorda o laço
+        // antes do prazo, então a troca de painel não espera o atraso inteiro
+        absolute_time_t next_loop = make_timeout_time_ms(150);
+        while (!io_expander_event_pending() && !i2c_bus_service_pending() &&
+               !best_effort_wfe_or_timeout(next_loop))
+            tight_loop_contents();
     }
 
     return 0;
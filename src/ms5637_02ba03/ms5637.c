@@ -9,47 +9,50 @@
  */
 
 #include "ms5637.h"
+#include "crc.h"
+#include "i2c_bus.h"
 #include "pico/stdlib.h"
-#include <math.h>
 #include <stdio.h>
 
 // Buffer para armazenar os coeficientes da PROM do sensor
 static uint16_t prom[8]; // Inclui espaço para CRC, PROM de 0 a 7
 // O índice 0 é o CRC, os índices 1 a 6 são os coeficientes
 // O índice 7 é reservado para uso futuro ou pode ser usado para armazenar o CRC
-// Resolução atual do sensor, inicializada para a resolução mais alta
+// Resoluções atuais do sensor para pressão (D1) e temperatura (D2), inicializadas
+// para a resolução mais alta
 // MS5637_OSR_8192 é a resolução mais alta, que oferece a melhor precisão
 // A resolução afeta o tempo de conversão e a precisão dos dados lidos
 
-static ms5637_osr_t current_osr = MS5637_OSR_8192;
+// Resultado da última leitura da PROM; enquanto não for OK as medições
+// tentam ler de novo e devolvem o erro (coeficientes inválidos não são usados)
+static ms5637_status_t prom_status = MS5637_STATUS_ERROR;
+
+// Sensor no barramento compartilhado
+static const i2c_bus_device_t ms5637_dev = I2C_BUS_DEVICE(MS5637_ADDR, MS5637_I2C_FREQ);
+
+static ms5637_osr_t osr_d1 = MS5637_OSR_8192;
+static ms5637_osr_t osr_d2 = MS5637_OSR_8192;
 
 // Tabela de tempos de conversão em milissegundos para cada resolução
 // Esses valores são baseados na especificação do sensor MS5637
 static const uint8_t conversion_time_ms[] = {1, 2, 3, 5, 9, 17};
 
-// Função para calcular o CRC4 dos coeficientes da PROM
-// O CRC é usado para verificar a integridade dos dados lidos do sensor
-// A função percorre os coeficientes, aplica o algoritmo CRC4 e retorna o valor CRC
-// O CRC é calculado com base nos 16 bits de cada coeficiente, exceto o CRC em si
-// O CRC é armazenado no índice 0 do array prom, e os coeficientes são armazenados nos índices 1 a 6
-static uint8_t crc4(uint16_t *n_prom) {
-    uint16_t n_rem = 0x00;
-    n_prom[0] &= 0x0FFF;
-    n_prom[7] = 0;
-    for (int cnt = 0; cnt < 16; cnt++) {
-        if (cnt % 2 == 1)
-            n_rem ^= n_prom[cnt >> 1] & 0x00FF;
-        else
-            n_rem ^= n_prom[cnt >> 1] >> 8;
-        for (int n_bit = 8; n_bit > 0; n_bit--) {
-            if (n_rem & 0x8000)
-                n_rem = (n_rem << 1) ^ 0x3000;
-            else
-                n_rem <<= 1;
-        }
-    }
-    return (n_rem >> 12) & 0xF;
-}
+// Ruído RMS de pressão típico do datasheet para cada resolução, em milésimos de mbar
+// Usado pelo modo adaptativo para prever o ruído de uma resolução mais baixa
+static const uint8_t pressure_noise_umbar[] = {110, 62, 39, 28, 21, 16};
+
+// Estado do modo adaptativo de resolução (D1)
+#define ADAPTIVE_MIN_SAMPLES 16   // amostras na resolução atual antes de decidir
+#define ADAPTIVE_EWMA_SHIFT 3     // peso 1/8 da média móvel da variância
+
+static bool adaptive_enabled = false;
+static int64_t adaptive_target_var = 0;  // ruído alvo ao quadrado (Pa²)
+static ms5637_osr_t adaptive_max_osr = MS5637_OSR_8192; // maior OSR que cabe no período
+static int32_t adaptive_last_p = 0;
+// Média móvel de (P[n] - P[n-1])² em Pa², guardada multiplicada por
+// 2^ADAPTIVE_EWMA_SHIFT: sem a escala, o truncamento a prende em até 7 Pa²
+static int64_t adaptive_diff_acc = 0;
+static uint16_t adaptive_samples = 0;
 
 // Função para ler os coeficientes da PROM do sensor
 // Lê os coeficientes de 0 a 7 do sensor MS5637 via I2C
@@ -61,22 +64,21 @@ static ms5637_status_t read_prom(void) {
     for (int i = 0; i < 8; i++) {
         uint8_t cmd = MS5637_PROM_READ_BASE + (i * 2);
         uint8_t data[2];
-        if (i2c_write_blocking(MS5637_I2C, MS5637_ADDR, &cmd, 1, true) != 1)
-            return MS5637_STATUS_ERROR;
-        if (i2c_read_blocking(MS5637_I2C, MS5637_ADDR, data, 2, false) != 2)
+        if (i2c_bus_write_read(&ms5637_dev, &cmd, 1, data, 2) != 2)
             return MS5637_STATUS_ERROR;
         prom[i] = (data[0] << 8) | data[1];
     }
-    if (crc4(prom) != (prom[0] >> 12))
+    // O CRC-4 (crc.h) não altera prom, então prom[0] >> 12 ainda é o CRC gravado
+    if (crc4_ms5637(prom) != (prom[0] >> 12))
         return MS5637_STATUS_CRC_ERROR;
     return MS5637_STATUS_OK;
 }
 
 // Função para iniciar a conversão de temperatura ou pressão
 // Envia o comando de conversão apropriado para o sensor MS5637 
-// O comando é baseado na resolução atual (current_osr)
+// O comando já inclui a resolução escolhida
 static ms5637_status_t start_conversion(uint8_t cmd) {
-    return i2c_write_blocking(MS5637_I2C, MS5637_ADDR, &cmd, 1, false) == 1
+    return i2c_bus_write(&ms5637_dev, &cmd, 1) == 1
            ? MS5637_STATUS_OK
            : MS5637_STATUS_ERROR;
 }
@@ -89,9 +91,7 @@ static ms5637_status_t start_conversion(uint8_t cmd) {
 static ms5637_status_t read_adc(uint32_t *value) {
     uint8_t cmd = MS5637_READ_ADC_COMMAND;
     uint8_t data[3];
-    if (i2c_write_blocking(MS5637_I2C, MS5637_ADDR, &cmd, 1, true) != 1)
-        return MS5637_STATUS_ERROR;
-    if (i2c_read_blocking(MS5637_I2C, MS5637_ADDR, data, 3, false) != 3)
+    if (i2c_bus_write_read(&ms5637_dev, &cmd, 1, data, 3) != 3)
         return MS5637_STATUS_ERROR;
     *value = (data[0] << 16) | (data[1] << 8) | data[2];
     return MS5637_STATUS_OK;
@@ -103,71 +103,65 @@ static ms5637_status_t read_adc(uint32_t *value) {
 // Após o reset, é recomendado esperar um curto período antes de realizar novas leituras
 ms5637_status_t ms5637_reset(void) {
     uint8_t cmd = MS5637_RESET_COMMAND;
-    return i2c_write_blocking(MS5637_I2C, MS5637_ADDR, &cmd, 1, false) == 1
+    ms5637_invalidate_temperature_cache();
+    return i2c_bus_write(&ms5637_dev, &cmd, 1) == 1
            ? MS5637_STATUS_OK
            : MS5637_STATUS_ERROR;
 }
 
 // Função de inicialização do sensor MS5637
-// Configura o I2C, define os pinos SDA e SCL, e inicia a comunicação com o sensor
+// Garante o barramento I2C compartilhado (i2c_bus) e inicia a comunicação com o sensor
 // Lê os coeficientes da PROM e verifica o CRC 
 // Se a leitura for bem-sucedida, o sensor está pronto para uso
 void ms5637_init(void) {
-    i2c_init(MS5637_I2C, MS5637_I2C_FREQ);
-    gpio_set_function(MS5637_I2C_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(MS5637_I2C_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(MS5637_I2C_SDA);
-    gpio_pull_up(MS5637_I2C_SCL);
+    i2c_bus_init(); // sem efeito se o barramento já foi inicializado
 
     ms5637_reset();
     sleep_ms(20);
-    read_prom();
+    prom_status = read_prom();
 }
 
-// Função para ler a temperatura e pressão do sensor MS5637
-// Realiza a conversão de temperatura e pressão, calcula os valores finais
-// A função lê os valores ADC para temperatura (D2) e pressão (D1), calcula a temperatura em °C
-// e a pressão em mbar usando os coeficientes lidos da PROM
-// Retorna o status da operação, que pode ser OK, ERROR ou CRC_ERROR
-ms5637_status_t ms5637_read_temperature_pressure(float *temperature, float *pressure) {
-    uint32_t D1 = 0, D2 = 0;
+// Estado de compensação derivado da leitura de temperatura (D2)
+// TEMP em centésimos de °C; OFF e SENS já incluem as correções de segunda ordem
+typedef struct {
+    int32_t TEMP;
+    int64_t OFF;
+    int64_t SENS;
+} ms5637_comp_t;
+
+// Etapas da medição não bloqueante
+typedef enum {
+    MEAS_IDLE = 0, // nenhuma medição em andamento
+    MEAS_D2,       // aguardando a conversão de temperatura
+    MEAS_D1        // aguardando a conversão de pressão
+} meas_state_t;
+
+static meas_state_t meas_state = MEAS_IDLE;
+static bool conv_pending = false;            // conversão iniciada e ainda não lida
+static absolute_time_t conv_ready_at;        // instante em que a conversão termina
+
+// Cache da compensação de temperatura (modo só-pressão)
+// A temperatura varia bem mais devagar que a pressão: entre duas conversões D2
+// as medições fazem apenas D1 contra o último estado de compensação
+static ms5637_comp_t comp_cache;
+static bool comp_valid = false;
+static absolute_time_t comp_time;            // instante da última conversão D2
+static uint16_t temp_every_n = 0;            // D2 a cada N medições (0 = sempre)
+static uint32_t temp_max_age_ms = 0;         // idade máxima do cache (0 = sem limite)
+static uint16_t samples_since_temp = 0;      // medições feitas com o cache atual
+
+// Cálculo da temperatura e dos termos de compensação a partir de D2
+// A temperatura é calculada com base no valor D2 e nos coeficientes lidos da PROM
+// O cálculo leva em conta correções adicionais se a temperatura estiver abaixo de 2000
+// A fórmula é baseada na especificação do sensor MS5637
+static void compensate_temperature(uint32_t D2, ms5637_comp_t *comp) {
     int32_t dT, TEMP;
-    int64_t OFF, SENS, P;
+    int64_t OFF, SENS;
     int64_t T2 = 0, OFF2 = 0, SENS2 = 0;
 
-    // Conversão de temperatura
-    uint8_t cmd = MS5637_CONVERT_D2_BASE + (current_osr * 2);
-    if (start_conversion(cmd) != MS5637_STATUS_OK) return MS5637_STATUS_ERROR;
-    sleep_ms(conversion_time_ms[current_osr]);
-    if (read_adc(&D2) != MS5637_STATUS_OK) return MS5637_STATUS_ERROR;
-
-    // Conversão de pressão
-    // A pressão é lida após a temperatura para garantir que os dados estejam prontos
-    // A resolução atual (current_osr) é usada para determinar o comando de conversão 
-    cmd = MS5637_CONVERT_D1_BASE + (current_osr * 2);
-    if (start_conversion(cmd) != MS5637_STATUS_OK) return MS5637_STATUS_ERROR;
-    sleep_ms(conversion_time_ms[current_osr]);
-    if (read_adc(&D1) != MS5637_STATUS_OK) return MS5637_STATUS_ERROR;
-
-    // Cálculo da temperatura e pressão
-    // A temperatura é calculada com base no valor D2 e nos coeficientes lidos da PROM
-    // A pressão é calculada com base no valor D1, na temperatura e nos coeficientes
-    // O cálculo leva em conta correções adicionais se a temperatura estiver abaixo de 2000         
-    // A fórmula é baseada na especificação do sensor MS5637
-    // A temperatura é retornada em °C e a pressão em mbar
-
-
-    // A temperatura é calculada a partir do valor D2 e dos coeficientes da PROM
     // A fórmula é TEMP = 2000 + (dT * prom[6])
     // onde dT é a diferença entre D2 e o coeficiente prom[5] ajustado
     // A temperatura é retornada em centésimos de grau Celsius (2000 corresponde a 20.00 °C)
-    // A pressão é calculada a partir do valor D1, da temperatura e dos coeficientes da PROM
-    // A fórmula é P = ((D1 * SENS) >> 21 - OFF) >> 15
-    // onde SENS e OFF são calculados a partir dos coeficientes e da temperatura
-    // A pressão é retornada em mbar (hectopascals)
-    // Cálculo de dT e TEMP
-    // dT é a diferença entre D2 e o coeficiente prom[5] ajusted
-    // TEMP é a temperatura calculada em centésimos de grau Celsius
     dT = D2 - ((int32_t)prom[5] << 8);
     TEMP = 2000 + ((int64_t)dT * prom[6]) / 8388608;
 
@@ -175,7 +169,6 @@ ms5637_status_t ms5637_read_temperature_pressure(float *temperature, float *pres
     OFF = ((int64_t)prom[2] << 17) + ((int64_t)prom[4] * dT) / 64;
     SENS = ((int64_t)prom[1] << 16) + ((int64_t)prom[3] * dT) / 128;
 
-
     // Se a temperatura for inferior a 2000 °C, aplica correções adicionais
     if (TEMP < 2000) {
         T2 = ((int64_t)dT * dT) >> 31;
@@ -187,16 +180,259 @@ ms5637_status_t ms5637_read_temperature_pressure(float *temperature, float *pres
         }
     }
 
-    TEMP -= T2;
-    OFF -= OFF2;
-    SENS -= SENS2;
+    comp->TEMP = TEMP - T2;
+    comp->OFF = OFF - OFF2;
+    comp->SENS = SENS - SENS2;
+}
 
-    // Cálculo final da pressão em centésimos de mbar
-    P = (((D1 * SENS) >> 21) - OFF) >> 15;
+// Cálculo final da pressão em centésimos de mbar (Pa) a partir de D1
+// A fórmula é P = ((D1 * SENS) >> 21 - OFF) >> 15
+static int32_t compensate_pressure(uint32_t D1, const ms5637_comp_t *comp) {
+    return (int32_t)(((((int64_t)D1 * comp->SENS) >> 21) - comp->OFF) >> 15);
+}
 
-    // A temperatura é convertida de centésimos de grau Celsius para graus Celsius
-    *temperature = TEMP / 100.0f;
-    *pressure = P / 100.0f;
+// Indica se a próxima medição precisa de uma nova conversão D2
+static bool temperature_due(void) {
+    if (!comp_valid || temp_every_n == 0 || samples_since_temp >= temp_every_n)
+        return true;
+    return temp_max_age_ms != 0 &&
+           absolute_time_diff_us(comp_time, get_absolute_time()) >= (int64_t)temp_max_age_ms * 1000;
+}
 
+// Inicia a conversão D1 (pressão) ou D2 (temperatura) na resolução configurada
+// e registra o instante em que o resultado estará disponível
+ms5637_status_t ms5637_start_conversion(ms5637_conv_t conv) {
+    bool pressure = (conv == MS5637_CONV_PRESSURE);
+    ms5637_osr_t osr = pressure ? osr_d1 : osr_d2;
+    uint8_t base = pressure ? MS5637_CONVERT_D1_BASE : MS5637_CONVERT_D2_BASE;
+    if (start_conversion(base + (osr * 2)) != MS5637_STATUS_OK) {
+        conv_pending = false;
+        return MS5637_STATUS_ERROR;
+    }
+    conv_ready_at = make_timeout_time_ms(conversion_time_ms[osr]);
+    conv_pending = true;
+    return MS5637_STATUS_OK;
+}
+
+// Indica se a conversão iniciada já terminou (não acessa o barramento)
+bool ms5637_conversion_ready(void) {
+    return conv_pending && time_reached(conv_ready_at);
+}
+
+// Instante em que a conversão em andamento termina
+absolute_time_t ms5637_conversion_ready_at(void) {
+    return conv_ready_at;
+}
+
+// Lê o resultado da conversão; BUSY se ela ainda não terminou
+ms5637_status_t ms5637_fetch_adc(uint32_t *raw) {
+    if (!conv_pending)
+        return MS5637_STATUS_ERROR;
+    if (!time_reached(conv_ready_at))
+        return MS5637_STATUS_BUSY;
+    conv_pending = false;
+    return read_adc(raw);
+}
+
+// Reinicia a estatística do modo adaptativo (troca de resolução)
+static void adaptive_reset(void) {
+    adaptive_diff_acc = 0;
+    adaptive_samples = 0;
+}
+
+// Atualiza a estimativa de ruído com uma nova pressão e ajusta a resolução D1
+// Para ruído branco, a variância da diferença entre amostras vizinhas é 2σ²,
+// então σ² ≈ média((P[n] - P[n-1])²) / 2. Movimento real também entra na
+// estimativa, o que só leva a resoluções mais altas (lado seguro)
+static void adaptive_update(int32_t pressure_pa) {
+    if (adaptive_samples > 0) {
+        int64_t diff = (int64_t)pressure_pa - adaptive_last_p;
+        if (adaptive_samples == 1)
+            adaptive_diff_acc = (diff * diff) << ADAPTIVE_EWMA_SHIFT;
+        else
+            adaptive_diff_acc += diff * diff - (adaptive_diff_acc >> ADAPTIVE_EWMA_SHIFT);
+    }
+    adaptive_last_p = pressure_pa;
+    if (++adaptive_samples < ADAPTIVE_MIN_SAMPLES)
+        return;
+
+    int64_t var = (adaptive_diff_acc >> ADAPTIVE_EWMA_SHIFT) / 2;
+    if (var > adaptive_target_var && osr_d1 < adaptive_max_osr) {
+        osr_d1++;
+        adaptive_reset();
+    } else if (osr_d1 > MS5637_OSR_256) {
+        // Ruído previsto na resolução abaixo, escalado pela razão do datasheet,
+        // com 20% de margem para não oscilar entre duas resoluções
+        int64_t ratio_num = pressure_noise_umbar[osr_d1 - 1];
+        int64_t ratio_den = pressure_noise_umbar[osr_d1];
+        int64_t predicted = var * ratio_num * ratio_num / (ratio_den * ratio_den);
+        if (predicted * 5 < adaptive_target_var * 4) {
+            osr_d1--;
+            adaptive_reset();
+        }
+    }
+}
+
+// Define a mesma resolução para pressão e temperatura
+ms5637_status_t ms5637_set_osr(ms5637_osr_t osr) {
+    return ms5637_set_osr_split(osr, osr);
+}
+
+// Define resoluções independentes para pressão (D1) e temperatura (D2)
+// Desliga o modo adaptativo, que passaria a sobrescrever a escolha
+ms5637_status_t ms5637_set_osr_split(ms5637_osr_t d1_osr, ms5637_osr_t d2_osr) {
+    if (d1_osr > MS5637_OSR_8192 || d2_osr > MS5637_OSR_8192)
+        return MS5637_STATUS_ERROR;
+    osr_d1 = d1_osr;
+    osr_d2 = d2_osr;
+    adaptive_enabled = false;
+    return MS5637_STATUS_OK;
+}
+
+// Resolução em uso para a conversão indicada
+ms5637_osr_t ms5637_get_osr(ms5637_conv_t conv) {
+    return (conv == MS5637_CONV_PRESSURE) ? osr_d1 : osr_d2;
+}
+
+// Tempo de conversão em ms para uma resolução
+uint8_t ms5637_get_conversion_time_ms(ms5637_osr_t osr) {
+    return osr <= MS5637_OSR_8192 ? conversion_time_ms[osr] : 0;
+}
+
+// Liga o modo adaptativo: escolhe a menor resolução D1 cujo ruído medido fique
+// abaixo de target_noise_pa (RMS), limitada à maior resolução em que D2 + D1
+// cabem em sample_period_ms. A resolução D2 continua a definida pelo usuário
+ms5637_status_t ms5637_set_adaptive_osr(int32_t target_noise_pa, uint32_t sample_period_ms) {
+    if (target_noise_pa <= 0)
+        return MS5637_STATUS_ERROR;
+
+    ms5637_osr_t max_osr = MS5637_OSR_256;
+    for (int osr = MS5637_OSR_8192; osr >= MS5637_OSR_256; osr--) {
+        if ((uint32_t)conversion_time_ms[osr] + conversion_time_ms[osr_d2] <= sample_period_ms) {
+            max_osr = (ms5637_osr_t)osr;
+            break;
+        }
+    }
+
+    adaptive_max_osr = max_osr;
+    adaptive_target_var = (int64_t)target_noise_pa * target_noise_pa;
+    if (osr_d1 > max_osr)
+        osr_d1 = max_osr;
+    adaptive_reset();
+    adaptive_enabled = true;
+    return MS5637_STATUS_OK;
+}
+
+// Desliga o modo adaptativo mantendo a resolução atual
+void ms5637_disable_adaptive_osr(void) {
+    adaptive_enabled = false;
+}
+
+// Compensa um par D1/D2 com os coeficientes da PROM
+void ms5637_compensate(uint32_t D1, uint32_t D2, int32_t *temperature_centi, int32_t *pressure_pa) {
+    ms5637_comp_t comp;
+    compensate_temperature(D2, &comp);
+    *temperature_centi = comp.TEMP;
+    *pressure_pa = compensate_pressure(D1, &comp);
+}
+
+// Liga o modo só-pressão: a temperatura (D2) e os termos dT, OFF e SENS são
+// refeitos a cada every_n medições ou quando o cache passa de max_age_ms
+// (0 desliga esse limite). every_n = 0 volta a medir D2 em toda leitura
+void ms5637_set_temperature_cache(uint16_t every_n, uint32_t max_age_ms) {
+    temp_every_n = every_n;
+    temp_max_age_ms = max_age_ms;
+}
+
+// Força uma nova conversão D2 na próxima medição
+void ms5637_invalidate_temperature_cache(void) {
+    comp_valid = false;
+}
+
+// Inicia uma medição sem bloquear: D2 seguida de D1, ou só D1 quando a
+// compensação em cache ainda vale
+ms5637_status_t ms5637_measure_start(void) {
+    if (prom_status != MS5637_STATUS_OK && (prom_status = read_prom()) != MS5637_STATUS_OK) {
+        meas_state = MEAS_IDLE;
+        return prom_status;
+    }
+    bool need_temp = temperature_due();
+    ms5637_status_t status = ms5637_start_conversion(need_temp ? MS5637_CONV_TEMPERATURE
+                                                               : MS5637_CONV_PRESSURE);
+    if (status != MS5637_STATUS_OK)
+        meas_state = MEAS_IDLE;
+    else
+        meas_state = need_temp ? MEAS_D2 : MEAS_D1;
+    return status;
+}
+
+// Avança a medição iniciada por ms5637_measure_start()
+// Retorna BUSY enquanto alguma conversão estiver em andamento e OK com o resultado pronto
+ms5637_status_t ms5637_measure_poll(int32_t *temperature_centi, int32_t *pressure_pa) {
+    uint32_t raw;
+
+    switch (meas_state) {
+        case MEAS_D2:
+            if (!ms5637_conversion_ready())
+                return MS5637_STATUS_BUSY;
+            // Temperatura lida: a pressão é convertida em seguida
+            if (ms5637_fetch_adc(&raw) != MS5637_STATUS_OK ||
+                ms5637_start_conversion(MS5637_CONV_PRESSURE) != MS5637_STATUS_OK) {
+                meas_state = MEAS_IDLE;
+                return MS5637_STATUS_ERROR;
+            }
+            compensate_temperature(raw, &comp_cache);
+            comp_time = get_absolute_time();
+            comp_valid = true;
+            samples_since_temp = 0;
+            meas_state = MEAS_D1;
+            return MS5637_STATUS_BUSY;
+
+        case MEAS_D1:
+            if (!ms5637_conversion_ready())
+                return MS5637_STATUS_BUSY;
+            meas_state = MEAS_IDLE;
+            if (ms5637_fetch_adc(&raw) != MS5637_STATUS_OK)
+                return MS5637_STATUS_ERROR;
+            *temperature_centi = comp_cache.TEMP;
+            *pressure_pa = compensate_pressure(raw, &comp_cache);
+            samples_since_temp++;
+            if (adaptive_enabled)
+                adaptive_update(*pressure_pa);
+            return MS5637_STATUS_OK;
+
+        default:
+            return MS5637_STATUS_ERROR; // nenhuma medição em andamento
+    }
+}
+
+// Aguarda (dormindo até cada prazo de conversão) a medição em andamento
+ms5637_status_t ms5637_measure_wait(int32_t *temperature_centi, int32_t *pressure_pa) {
+    ms5637_status_t status;
+    while ((status = ms5637_measure_poll(temperature_centi, pressure_pa)) == MS5637_STATUS_BUSY)
+        sleep_until(conv_ready_at);
+    return status;
+}
+
+// Função para ler a temperatura e pressão do sensor MS5637
+// Versão bloqueante sobre a medição não bloqueante: inicia e aguarda D2 e D1
+// Retorna a temperatura em centésimos de °C e a pressão em centésimos de mbar (Pa)
+ms5637_status_t ms5637_read_temperature_pressure_centi(int32_t *temperature_centi, int32_t *pressure_pa) {
+    ms5637_status_t status = ms5637_measure_start();
+    if (status != MS5637_STATUS_OK)
+        return status;
+    return ms5637_measure_wait(temperature_centi, pressure_pa);
+}
+
+// Versão em ponto flutuante: temperatura em °C e pressão em mbar
+ms5637_status_t ms5637_read_temperature_pressure(float *temperature, float *pressure) {
+    int32_t temp_centi, press_pa;
+    ms5637_status_t status = ms5637_read_temperature_pressure_centi(&temp_centi, &press_pa);
+    if (status != MS5637_STATUS_OK)
+        return status;
+
+    // A temperatura é convertida de centésimos de grau Celsius para graus Celsius
+    *temperature = temp_centi / 100.0f;
+    *pressure = press_pa / 100.0f;
     return MS5637_STATUS_OK;
 }
@@ -3,13 +3,11 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include "hardware/i2c.h"
+#include "pico/time.h"
 
 // --- CONFIGURAÇÕES DE HARDWARE ---
-#define MS5637_I2C        i2c0
-#define MS5637_I2C_SDA    4
-#define MS5637_I2C_SCL    5
-#define MS5637_I2C_FREQ   400000 // 400kHz
+// O barramento (i2c0, SDA 4 / SCL 5) é do gerenciador i2c_bus.h
+#define MS5637_I2C_FREQ   400000 // 400kHz, clock máximo do sensor
 
 // --- ENDEREÇO I2C DO SENSOR ---
 #define MS5637_ADDR       0x76
@@ -39,12 +37,45 @@ typedef enum {
 typedef enum {
     MS5637_STATUS_OK = 0,
     MS5637_STATUS_ERROR,
-    MS5637_STATUS_CRC_ERROR
+    MS5637_STATUS_CRC_ERROR,
+    MS5637_STATUS_BUSY // conversão ainda em andamento (API não bloqueante)
 } ms5637_status_t;
 
+// --- CONVERSÕES ---
+typedef enum {
+    MS5637_CONV_PRESSURE = 0, // D1
+    MS5637_CONV_TEMPERATURE   // D2
+} ms5637_conv_t;
+
 // --- INTERFACE ---
 void ms5637_init(void);
 ms5637_status_t ms5637_reset(void);
 ms5637_status_t ms5637_read_temperature_pressure(float *temperature, float *pressure);
+// Mesma leitura em inteiros: temperatura em centésimos de °C e pressão em Pa (centésimos de mbar)
+ms5637_status_t ms5637_read_temperature_pressure_centi(int32_t *temperature_centi, int32_t *pressure_pa);
+
+// --- INTERFACE NÃO BLOQUEANTE ---
+// Conversões isoladas: inicia D1/D2, consulta o prazo e busca o resultado
+ms5637_status_t ms5637_start_conversion(ms5637_conv_t conv);
+bool ms5637_conversion_ready(void);
+absolute_time_t ms5637_conversion_ready_at(void);
+ms5637_status_t ms5637_fetch_adc(uint32_t *raw);
+void ms5637_compensate(uint32_t D1, uint32_t D2, int32_t *temperature_centi, int32_t *pressure_pa);
+// Máquina de estados D2 -> D1 -> compensação; poll retorna BUSY até o resultado ficar pronto
+ms5637_status_t ms5637_measure_start(void);
+ms5637_status_t ms5637_measure_poll(int32_t *temperature_centi, int32_t *pressure_pa);
+ms5637_status_t ms5637_measure_wait(int32_t *temperature_centi, int32_t *pressure_pa);
+// Modo só-pressão: D2 (temperatura) a cada every_n medições ou max_age_ms; no intervalo só D1
+void ms5637_set_temperature_cache(uint16_t every_n, uint32_t max_age_ms);
+void ms5637_invalidate_temperature_cache(void);
+
+// --- RESOLUÇÃO (OSR) ---
+ms5637_status_t ms5637_set_osr(ms5637_osr_t osr);
+ms5637_status_t ms5637_set_osr_split(ms5637_osr_t d1_osr, ms5637_osr_t d2_osr);
+ms5637_osr_t ms5637_get_osr(ms5637_conv_t conv);
+uint8_t ms5637_get_conversion_time_ms(ms5637_osr_t osr);
+// Modo adaptativo: menor OSR de pressão que atinge o ruído alvo (Pa RMS) no período de amostragem
+ms5637_status_t ms5637_set_adaptive_osr(int32_t target_noise_pa, uint32_t sample_period_ms);
+void ms5637_disable_adaptive_osr(void);
 
 #endif // MS5637_H
\ No newline at end of file
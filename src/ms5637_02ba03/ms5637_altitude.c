@@ -0,0 +1,90 @@
+/**
+ * @file ms5637_altitude.c
+ * @brief Altitude relativa em ponto fixo a partir da pressão do MS5637.
+ *
+ * O RP2040 não tem FPU: powf() com expoente 1/5.255 custa milhares de ciclos
+ * por amostra. Aqui a fórmula barométrica é tabelada em função da razão P/P0
+ * e interpolada linearmente, só com aritmética inteira.
+ *
+ * Erro em relação à fórmula exata (double), na faixa da tabela:
+ *   - interpolação: |f''| * passo² / 8, no máximo ~1,2 cm em P/P0 = 0,5
+ *     (~5,5 km de subida) e ~0,3 cm perto de P/P0 = 1;
+ *   - arredondamento das entradas e da razão em Q24: menos de 1 cm.
+ * Pior caso medido (P0 de 950 a 1030 hPa, P em passos de 3 Pa): 1,9 cm, e
+ * 1,3 cm entre -1 km e +1 km. Contra o calculate_altitude() com powf() em
+ * float (que erra até 0,4 cm) a diferença máxima é 2,1 cm, bem abaixo do
+ * ruído do sensor em OSR 8192 (~13 cm). src/sim/tests/bench_altitude.c
+ * confere esses limites.
+ */
+
+#include "ms5637_altitude.h"
+
+// Passo da tabela: 1/512 de razão, ou seja 2^15 em Q24 (321 entradas, ~1,3 KB de flash)
+#define LUT_STEP_SHIFT 15
+#define LUT_SIZE 321
+
+// altitude_lut_cm[i] = 4433000 * (1 - (0.5 + i/512)^(1/5.255)), arredondado
+static const int32_t altitude_lut_cm[LUT_SIZE] = {
+    547801, 544918, 542043, 539178, 536322, 533474, 530635, 527805,
+    524984, 522171, 519367, 516572, 513785, 511006, 508236, 505474,
+    502720, 499974, 497237, 494507, 491786, 489073, 486367, 483670,
+    480980, 478298, 475624, 472957, 470298, 467646, 465003, 462366,
+    459737, 457115, 454501, 451894, 449294, 446702, 444116, 441538,
+    438967, 436403, 433845, 431295, 428752, 426215, 423685, 421162,
+    418646, 416137, 413634, 411138, 408648, 406165, 403688, 401218,
+    398754, 396297, 393846, 391401, 388963, 386530, 384104, 381685,
+    379271, 376863, 374462, 372066, 369677, 367293, 364916, 362544,
+    360178, 357818, 355464, 353115, 350773, 348436, 346104, 343779,
+    341459, 339144, 336835, 334532, 332234, 329942, 327655, 325373,
+    323097, 320826, 318560, 316300, 314045, 311795, 309551, 307312,
+    305077, 302848, 300624, 298406, 296192, 293983, 291779, 289580,
+    287387, 285198, 283014, 280835, 278660, 276491, 274326, 272166,
+    270011, 267861, 265715, 263574, 261438, 259307, 257180, 255057,
+    252939, 250826, 248717, 246613, 244513, 242418, 240327, 238241,
+    236159, 234081, 232008, 229939, 227875, 225814, 223758, 221707,
+    219659, 217616, 215577, 213542, 211511, 209485, 207463, 205444,
+    203430, 201420, 199414, 197412, 195414, 193420, 191430, 189444,
+    187461, 185483, 183509, 181539, 179572, 177609, 175651, 173696,
+    171745, 169797, 167854, 165914, 163978, 162045, 160117, 158192,
+    156270, 154353, 152439, 150529, 148622, 146719, 144819, 142923,
+    141031, 139142, 137257, 135375, 133497, 131622, 129751, 127883,
+    126018, 124157, 122300, 120445, 118595, 116747, 114903, 113062,
+    111225, 109391, 107560, 105733, 103908, 102087, 100270, 98455,
+    96644, 94836, 93031, 91230, 89431, 87636, 85844, 84055,
+    82269, 80486, 78706, 76930, 75156, 73386, 71619, 69854,
+    68093, 66335, 64579, 62827, 61078, 59332, 57588, 55848,
+    54110, 52376, 50644, 48915, 47190, 45467, 43747, 42029,
+    40315, 38604, 36895, 35189, 33486, 31786, 30088, 28394,
+    26702, 25013, 23326, 21643, 19962, 18283, 16608, 14935,
+    13265, 11598, 9933, 8271, 6611, 4955, 3300, 1649,
+    0, -1646, -3290, -4931, -6570, -8206, -9839, -11470,
+    -13098, -14724, -16347, -17968, -19586, -21202, -22815, -24426,
+    -26034, -27640, -29244, -30845, -32443, -34039, -35633, -37224,
+    -38813, -40399, -41983, -43565, -45144, -46721, -48296, -49868,
+    -51438, -53005, -54570, -56133, -57694, -59252, -60808, -62362,
+    -63913, -65462, -67009, -68554, -70096, -71636, -73174, -74710,
+    -76243, -77774, -79303, -80830, -82355, -83877, -85397, -86915,
+    -88431, -89945, -91456, -92966, -94473, -95978, -97481, -98982,
+    -100481,
+};
+
+// Altitude relativa em centímetros
+// A razão P/P0 é calculada em Q24 (1 LSB ≈ 0,05 cm perto do nível de referência);
+// os bits altos da parte acima de 0,5 indexam a tabela e os 15 baixos interpolam
+int32_t ms5637_altitude_cm(int32_t pressure_pa, int32_t baseline_pa) {
+    if (pressure_pa <= 0 || baseline_pa <= 0)
+        return 0;
+
+    uint64_t ratio = ((uint64_t)pressure_pa << 24) / (uint32_t)baseline_pa;
+    if (ratio <= MS5637_ALTITUDE_RATIO_MIN_Q24)
+        return altitude_lut_cm[0];
+    if (ratio >= MS5637_ALTITUDE_RATIO_MAX_Q24)
+        return altitude_lut_cm[LUT_SIZE - 1];
+
+    uint32_t offset = (uint32_t)ratio - MS5637_ALTITUDE_RATIO_MIN_Q24;
+    uint32_t i = offset >> LUT_STEP_SHIFT;
+    int32_t frac = offset & ((1u << LUT_STEP_SHIFT) - 1);
+    // Diferença entre entradas vizinhas < 3000 cm: o produto cabe em 32 bits
+    int32_t delta = altitude_lut_cm[i + 1] - altitude_lut_cm[i];
+    return altitude_lut_cm[i] + ((delta * frac + (1 << (LUT_STEP_SHIFT - 1))) >> LUT_STEP_SHIFT);
+}
@@ -0,0 +1,16 @@
+#ifndef MS5637_ALTITUDE_H
+#define MS5637_ALTITUDE_H
+
+#include <stdint.h>
+
+// --- ALTITUDE EM PONTO FIXO ---
+// Faixa coberta pela tabela: razão P/P0 de 0,5 a 1,125 (~ +5,5 km a -1 km)
+#define MS5637_ALTITUDE_RATIO_MIN_Q24  (1UL << 23)             // 0,5
+#define MS5637_ALTITUDE_RATIO_MAX_Q24  ((1UL << 24) + (1UL << 21)) // 1,125
+
+// Altitude relativa em centímetros pela fórmula barométrica
+// h = 44330 m * (1 - (P/P0)^(1/5.255)), sem ponto flutuante.
+// Fora da faixa da tabela o resultado é saturado nos extremos
+int32_t ms5637_altitude_cm(int32_t pressure_pa, int32_t baseline_pa);
+
+#endif // MS5637_ALTITUDE_H
@@ -0,0 +1,150 @@
+/**
+ * @file ms5637_filter.c
+ * @brief Filtros de ruído e estimador de altitude para as amostras do MS5637.
+ *
+ * Ficam entre o driver e o display: com eles é possível usar conversões de
+ * OSR baixo (rápidas e de menor consumo) e ainda assim mostrar leituras
+ * estáveis.
+ *
+ * O Kalman usa os ganhos de regime permanente do modelo de velocidade
+ * constante (filtro alfa-beta de Kalata). Para um período fixo a recursão da
+ * covariância converge sempre para os mesmos ganhos, então eles são
+ * calculados uma vez em ms5637_kalman_init() e cada amostra custa apenas
+ * algumas multiplicações inteiras.
+ */
+
+#include "ms5637_filter.h"
+
+// Inicializa a média móvel exponencial
+void ms5637_ema_init(ms5637_ema_t *ema, uint8_t shift) {
+    ema->state = 0;
+    ema->shift = shift > 16 ? 16 : shift;
+    ema->primed = false;
+}
+
+// Acrescenta uma amostra e devolve o valor filtrado (mesma unidade da amostra)
+// A primeira amostra inicializa o filtro, evitando a rampa a partir de zero.
+// O passo anda ao menos 1 LSB (truncado, pararia até 2^shift - 1 antes da
+// entrada) e a saída é arredondada, não truncada
+int32_t ms5637_ema_update(ms5637_ema_t *ema, int32_t sample) {
+    int32_t x = sample * 256;
+    if (!ema->primed) {
+        ema->state = x;
+        ema->primed = true;
+    } else {
+        int32_t step = (x - ema->state) / (1 << ema->shift);
+        if (step == 0 && x != ema->state)
+            step = x > ema->state ? 1 : -1;
+        ema->state += step;
+    }
+    return (ema->state + (ema->state >= 0 ? 128 : -128)) / 256;
+}
+
+// Raiz quadrada inteira (parte inteira de sqrt(x)), bit a bit
+static uint64_t isqrt64(uint64_t x) {
+    uint64_t root = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > x)
+        bit >>= 2;
+    while (bit) {
+        if (x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+// Faixas do índice de manobra: abaixo de 4 as contas vão em Q28 (alfa e beta
+// pequenos perdem dígitos em Q16); acima de 16384 alfa já arredonda para 1
+#define KALMAN_LAMBDA_FINE_Q16 (4ull << 16)
+#define KALMAN_LAMBDA_MAX_Q16  (16384ull << 16)
+#define KALMAN_FINE_SHIFT      28
+#define KALMAN_NOISE_MAX_CM    100000u
+
+// Ganhos alfa e beta com lambda em Q(shift); resultados na mesma escala.
+// Com u = sqrt(1 - alfa), lambda = 2(1 - u)² / u: u é a menor raiz de
+// 2u² - (4 + lambda)u + 2 = 0, escrita como 4 / ((4 + lambda) + sqrt(lambda² + 8 lambda))
+// para não perder dígitos na subtração; alfa = 1 - u² e beta = 2(1 - u)²
+static void kalman_gains(uint64_t lambda, unsigned shift, uint64_t *alpha, uint64_t *beta) {
+    uint64_t one = 1ull << shift;
+    uint64_t root = isqrt64(lambda * (lambda + 8u * one));
+    uint64_t den = 4u * one + lambda + root;
+    uint64_t u = ((4ull << (2 * shift)) + den / 2) / den;
+    if (u > one)
+        u = one;
+    *alpha = one - ((u * u + one / 2) >> shift);
+    *beta = (2u * (one - u) * (one - u) + one / 2) >> shift;
+}
+
+// Calcula os ganhos a partir do índice de manobra lambda = sigma_a * T² / sigma_z
+// (Kalata, 1984): alfa e beta equivalem ao ganho de Kalman em regime permanente.
+// Só inteiros de 64 bits: lambda = a * T_ms² * 2^q / (z * 10^6), com
+// 10^6 = 2^6 * 15625
+void ms5637_kalman_init(ms5637_kalman_t *kf, uint32_t period_ms,
+                        uint32_t meas_noise_cm, uint32_t accel_noise_cm_s2) {
+    uint64_t t_ms = period_ms ? period_ms : 1;
+    uint64_t noise = meas_noise_cm ? meas_noise_cm : 1;
+    if (noise > KALMAN_NOISE_MAX_CM)
+        noise = KALMAN_NOISE_MAX_CM;
+    uint64_t num = (uint64_t)accel_noise_cm_s2 * t_ms * t_ms;
+    uint64_t den = noise * 15625u;
+
+    uint64_t lambda = ((num << 10) + den / 2) / den; // Q16
+    unsigned shift = 16;
+    if (lambda > KALMAN_LAMBDA_MAX_Q16) {
+        lambda = KALMAN_LAMBDA_MAX_Q16;
+    } else if (lambda < KALMAN_LAMBDA_FINE_Q16) {
+        // Aqui num < 4 * z * 10^6 < 2^39: num << 22 ainda cabe em 64 bits
+        shift = KALMAN_FINE_SHIFT;
+        lambda = ((num << (KALMAN_FINE_SHIFT - 6)) + den / 2) / den;
+    }
+
+    uint64_t alpha, beta;
+    kalman_gains(lambda, shift, &alpha, &beta);
+
+    // Ganhos em Q16; o de velocidade é beta / T, em 1/s
+    unsigned down = shift - 16;
+    uint64_t round = down ? 1ull << (down - 1) : 0;
+    kf->k_alt = (int32_t)((alpha + round) >> down);
+    kf->k_vel = (int32_t)((((beta * 1000u + t_ms / 2) / t_ms) + round) >> down);
+    kf->period_ms = (uint32_t)t_ms;
+    ms5637_kalman_reset(kf);
+}
+
+// Descarta o estado: a próxima amostra reinicia a estimativa
+void ms5637_kalman_reset(ms5637_kalman_t *kf) {
+    kf->alt = 0;
+    kf->vel = 0;
+    kf->primed = false;
+}
+
+// Predição (altitude += velocidade * dt) seguida da correção pela inovação
+void ms5637_kalman_update(ms5637_kalman_t *kf, int32_t alt_cm, uint32_t dt_ms) {
+    int32_t z = alt_cm * 256;
+    if (!kf->primed || dt_ms > kf->period_ms * MS5637_KALMAN_MAX_GAP_PERIODS) {
+        // Primeira amostra ou lacuna longa (ex.: painel trocado): recomeça parado na medida
+        kf->alt = z;
+        kf->vel = 0;
+        kf->primed = true;
+        return;
+    }
+
+    kf->alt += (int32_t)(((int64_t)kf->vel * dt_ms) / 1000);
+    int32_t innovation = z - kf->alt;
+    kf->alt += (int32_t)(((int64_t)kf->k_alt * innovation) / 65536);
+    kf->vel += (int32_t)(((int64_t)kf->k_vel * innovation) / 65536);
+}
+
+// Altitude filtrada em centímetros
+int32_t ms5637_kalman_altitude_cm(const ms5637_kalman_t *kf) {
+    return kf->alt / 256;
+}
+
+// Velocidade vertical estimada em cm/s (positiva subindo)
+int32_t ms5637_kalman_speed_cm_s(const ms5637_kalman_t *kf) {
+    return kf->vel / 256;
+}
@@ -0,0 +1,44 @@
+#ifndef MS5637_FILTER_H
+#define MS5637_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// --- FILTROS DE AMOSTRAS DO BARÔMETRO ---
+// Memória e tempo constantes por amostra, só aritmética inteira no caminho de atualização
+
+// Lacuna (em períodos nominais) a partir da qual o Kalman é reiniciado na próxima amostra
+#define MS5637_KALMAN_MAX_GAP_PERIODS 8
+
+// Média móvel exponencial (IIR de 1ª ordem) com peso 1/2^shift para a nova amostra
+typedef struct {
+    int32_t state;   // valor filtrado em Q8 (unidade da amostra * 256)
+    uint8_t shift;   // 0 = sem filtro, 1 = 1/2, 2 = 1/4, ...
+    bool primed;     // false até a primeira amostra
+} ms5637_ema_t;
+
+void ms5637_ema_init(ms5637_ema_t *ema, uint8_t shift);
+int32_t ms5637_ema_update(ms5637_ema_t *ema, int32_t sample);
+
+// Kalman 1-D de altitude e velocidade vertical (modelo de velocidade constante
+// com aceleração como ruído), na forma de ganhos de regime permanente
+typedef struct {
+    int32_t alt;          // altitude estimada, cm em Q8
+    int32_t vel;          // velocidade vertical estimada, cm/s em Q8
+    int32_t k_alt;        // ganho de altitude (alfa), Q16
+    int32_t k_vel;        // ganho de velocidade (beta / T), Q16 em 1/s
+    uint32_t period_ms;   // período nominal de amostragem usado nos ganhos
+    bool primed;          // false até a primeira amostra
+} ms5637_kalman_t;
+
+// meas_noise_cm: ruído RMS da altitude medida; accel_noise_cm_s2: aceleração
+// vertical RMS esperada (quanto maior, mais rápido o filtro segue movimentos)
+void ms5637_kalman_init(ms5637_kalman_t *kf, uint32_t period_ms,
+                        uint32_t meas_noise_cm, uint32_t accel_noise_cm_s2);
+void ms5637_kalman_reset(ms5637_kalman_t *kf);
+// dt_ms: tempo desde a amostra anterior (a predição usa o intervalo real)
+void ms5637_kalman_update(ms5637_kalman_t *kf, int32_t alt_cm, uint32_t dt_ms);
+int32_t ms5637_kalman_altitude_cm(const ms5637_kalman_t *kf);
+int32_t ms5637_kalman_speed_cm_s(const ms5637_kalman_t *kf);
+
+#endif // MS5637_FILTER_H
@@ -1,12 +1,11 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
-#include "hardware/i2c.h"
 #include "SHT4xl-PCEIoT-Board.h"
+#include "crc.h"
+#include "i2c_bus.h"
 
-// Definições para a comunicação I2C
-#define I2C_PORT i2c0
-#define I2C_SDA 4  //8
-#define I2C_SCL 5  //9
+// Sensor no barramento compartilhado (o SHT4x aceita Fast-mode Plus)
+static const i2c_bus_device_t sht4x_dev = I2C_BUS_DEVICE(SHT4X_I2C_ADDRESS, SHT4X_I2C_MAX_HZ);
 
 // Comandos de Medição por Precisao
 #define CMD_MEASURE_HIGH_PREC     0xFD
@@ -29,42 +28,58 @@
 #define DELAY_HEATER_0_1S       110
 
 
-//Calcula o CRC-8 para um buffer de dados
-static uint8_t sht4x_crc8(const uint8_t *data, size_t len) {
-    uint8_t crc = 0xFF;
-    for (size_t i = 0; i < len; i++) {
-        crc ^= data[i];
-        for (uint8_t j = 0; j < 8; j++) {
-            crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : (crc << 1);
-        }
+// Estado da medição em andamento (API em duas fases)
+static bool meas_pending = false;          // comando enviado e resultado ainda não lido
+static absolute_time_t meas_ready_at;      // instante em que o resultado fica disponível
+
+//Envia o comando de medição e registra o prazo do datasheet, sem esperar
+static SHT4x_Status sht4x_start_cmd(uint8_t cmd, uint16_t delay_ms) {
+    if (i2c_bus_write(&sht4x_dev, &cmd, 1) != 1) {
+        meas_pending = false;
+        return SHT4X_STATUS_ERROR;
     }
-    return crc;
+    meas_ready_at = make_timeout_time_ms(delay_ms);
+    meas_pending = true;
+    return SHT4X_STATUS_OK;
 }
 
-//Funcao interna que executa o ciclo de medicao 
-
-static bool sht4x_perform_measurement(uint8_t cmd, uint16_t delay_ms, float *temperature, float *humidity) {
+//Le os 6 bytes do resultado e devolve os ticks brutos; NOT_READY antes do prazo
+static SHT4x_Status sht4x_fetch_raw(uint16_t *raw_temp, uint16_t *raw_humi) {
     uint8_t rx_buffer[6];
-    //Envia o comando de medição para o sensor
-    if (i2c_write_blocking(I2C_PORT, SHT4X_I2C_ADDRESS, &cmd, 1, false) != 1) {
-        return false;
+    if (!meas_pending) {
+        return SHT4X_STATUS_ERROR;
     }
-
-    //Aguarda o tempo necessário para a medição
-    sleep_ms(delay_ms);
+    if (!time_reached(meas_ready_at)) {
+        return SHT4X_STATUS_NOT_READY;
+    }
+    meas_pending = false;
     //Le os 6 bytes de resposta do sensor
-    if (i2c_read_blocking(I2C_PORT, SHT4X_I2C_ADDRESS, rx_buffer, 6, false) != 6) {
-        return false;
+    if (i2c_bus_read(&sht4x_dev, rx_buffer, 6) != 6) {
+        return SHT4X_STATUS_ERROR;
     }
 
     // Verifica se os dados estao iguais com o CRC 
-    if (sht4x_crc8(rx_buffer, 2) != rx_buffer[2] || sht4x_crc8(rx_buffer + 3, 2) != rx_buffer[5]) {
+    if (crc8_sensirion(rx_buffer, 2) != rx_buffer[2] || crc8_sensirion(rx_buffer + 3, 2) != rx_buffer[5]) {
+        return SHT4X_STATUS_CRC_ERROR;
+    }
+
+    *raw_temp = (rx_buffer[0] << 8) | rx_buffer[1];
+    *raw_humi = (rx_buffer[3] << 8) | rx_buffer[4];
+    return SHT4X_STATUS_OK;
+}
+
+//Funcao interna que executa o ciclo de medicao completo (bloqueante) e devolve os ticks brutos
+static bool sht4x_perform_measurement(uint8_t cmd, uint16_t delay_ms, uint16_t *raw_temp, uint16_t *raw_humi) {
+    if (sht4x_start_cmd(cmd, delay_ms) != SHT4X_STATUS_OK) {
         return false;
     }
+    //Aguarda o tempo necessário para a medição
+    sleep_until(meas_ready_at);
+    return sht4x_fetch_raw(raw_temp, raw_humi) == SHT4X_STATUS_OK;
+}
 
-    // Converte os valores brutos para as unidades corretas
-    uint16_t raw_temp = (rx_buffer[0] << 8) | rx_buffer[1];
-    uint16_t raw_humi = (rx_buffer[3] << 8) | rx_buffer[4];
+// Converte os valores brutos para °C e %UR
+static void sht4x_convert_float(uint16_t raw_temp, uint16_t raw_humi, float *temperature, float *humidity) {
     //Calculo presente no datasheet do sensor :)
     *temperature = -45.0f + 175.0f * (raw_temp / 65535.0f);
     *humidity    = -6.0f + 125.0f * (raw_humi / 65535.0f);
@@ -72,82 +87,173 @@ static bool sht4x_perform_measurement(uint8_t cmd, uint16_t delay_ms, float *tem
     // Garante que o valor da umidade permaneça no intervalo de 0 a 100%
     if (*humidity > 100.0f) *humidity = 100.0f;
     if (*humidity < 0.0f) *humidity = 0.0f;
+}
 
-    return true;
+// Converte os valores brutos para centésimos de °C e de %UR, só com inteiros
+static void sht4x_convert_centi(uint16_t raw_temp, uint16_t raw_humi, int32_t *temp_centi, int32_t *hum_centi) {
+    // Mesmas fórmulas do datasheet, escaladas por 100 e arredondadas
+    *temp_centi = -4500 + (int32_t)((17500u * raw_temp + 32767u) / 65535u);
+    *hum_centi  = -600 + (int32_t)((12500u * raw_humi + 32767u) / 65535u);
+
+    if (*hum_centi > 10000) *hum_centi = 10000;
+    if (*hum_centi < 0) *hum_centi = 0;
 }
+
+// Seleciona o comando e o tempo de medição para um nivel de precisao
+static bool sht4x_precision_cmd(SHT4x_Precision precision, uint8_t *cmd, uint16_t *delay_ms) {
+    switch (precision) {
+        case PRECISION_HIGH:
+            *cmd = CMD_MEASURE_HIGH_PREC;
+            *delay_ms = DELAY_HIGH_PREC_MS;
+            return true;
+        case PRECISION_MEDIUM:
+            *cmd = CMD_MEASURE_MEDIUM_PREC;
+            *delay_ms = DELAY_MEDIUM_PREC_MS;
+            return true;
+        case PRECISION_LOW:
+            *cmd = CMD_MEASURE_LOW_PREC;
+            *delay_ms = DELAY_LOW_PREC_MS;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Seleciona o comando e o tempo de aquecimento + medição para um modo do aquecedor
+static bool sht4x_heater_cmd(SHT4x_HeaterMode mode, uint8_t *cmd, uint16_t *delay_ms) {
+    switch (mode) {
+        case HEATER_HIGH_1S:
+            *cmd = CMD_HEATER_HIGH_1S;
+            *delay_ms = DELAY_HEATER_1S;
+            return true;
+        case HEATER_HIGH_0_1S:
+            *cmd = CMD_HEATER_HIGH_0_1S;
+            *delay_ms = DELAY_HEATER_0_1S;
+            return true;
+        case HEATER_MEDIUM_1S:
+            *cmd = CMD_HEATER_MEDIUM_1S;
+            *delay_ms = DELAY_HEATER_1S;
+            return true;
+        case HEATER_MEDIUM_0_1S:
+            *cmd = CMD_HEATER_MEDIUM_0_1S;
+            *delay_ms = DELAY_HEATER_0_1S;
+            return true;
+        case HEATER_LOW_1S:
+            *cmd = CMD_HEATER_LOW_1S;
+            *delay_ms = DELAY_HEATER_1S;
+            return true;
+        case HEATER_LOW_0_1S:
+            *cmd = CMD_HEATER_LOW_0_1S;
+            *delay_ms = DELAY_HEATER_0_1S;
+            return true;
+        default:
+            return false;
+    }
+}
+
 //incia o sensor
 bool sht4x_init(void) {
-    i2c_init(I2C_PORT, 100 * 1000);
-    gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(I2C_SDA);
-    gpio_pull_up(I2C_SCL);
+    i2c_bus_init(); // sem efeito se o barramento já foi inicializado
     return sht4x_reset();
 }
 //Reset
 bool sht4x_reset(void) {
     uint8_t cmd = CMD_RESET;
-    int result = i2c_write_blocking(I2C_PORT, SHT4X_I2C_ADDRESS, &cmd, 1, false);
+    int result = i2c_bus_write(&sht4x_dev, &cmd, 1);
     sleep_ms(2);
     return result == 1;
 }
-//Le a temp e a umidade usando um switch case
+//Le a temp e a umidade no nivel de precisao escolhido
 bool sht4x_read_temp_hum(SHT4x_Precision precision, float *temperature, float *humidity) {
     uint8_t cmd;
-    uint16_t delay_ms;
+    uint16_t delay_ms, raw_temp, raw_humi;
 
-    switch (precision) {
-        case PRECISION_HIGH:
-            cmd = CMD_MEASURE_HIGH_PREC;
-            delay_ms = DELAY_HIGH_PREC_MS;
-            break;
-        case PRECISION_MEDIUM:
-            cmd = CMD_MEASURE_MEDIUM_PREC;
-            delay_ms = DELAY_MEDIUM_PREC_MS;
-            break;
-        case PRECISION_LOW:
-            cmd = CMD_MEASURE_LOW_PREC;
-            delay_ms = DELAY_LOW_PREC_MS;
-            break;
-        default:
-            return false;
+    if (!sht4x_precision_cmd(precision, &cmd, &delay_ms)) {
+        return false;
     }
     // Chama a função interna para fazer o trabalho pesado
-    return sht4x_perform_measurement(cmd, delay_ms, temperature, humidity);
+    if (!sht4x_perform_measurement(cmd, delay_ms, &raw_temp, &raw_humi)) {
+        return false;
+    }
+    sht4x_convert_float(raw_temp, raw_humi, temperature, humidity);
+    return true;
+}
+//Le a temp e a umidade em centesimos, sem ponto flutuante
+bool sht4x_read_temp_hum_centi(SHT4x_Precision precision, int32_t *temp_centi, int32_t *hum_centi) {
+    uint8_t cmd;
+    uint16_t delay_ms, raw_temp, raw_humi;
+
+    if (!sht4x_precision_cmd(precision, &cmd, &delay_ms)) {
+        return false;
+    }
+    if (!sht4x_perform_measurement(cmd, delay_ms, &raw_temp, &raw_humi)) {
+        return false;
+    }
+    sht4x_convert_centi(raw_temp, raw_humi, temp_centi, hum_centi);
+    return true;
 }
     //Leitura na base do aquecedor interno
 bool sht4x_read_with_heater(SHT4x_HeaterMode mode, float *temperature, float *humidity) {
     uint8_t cmd;
-    uint16_t delay_ms;
+    uint16_t delay_ms, raw_temp, raw_humi;
 
-    switch (mode) {
-        case HEATER_HIGH_1S:
-            cmd = CMD_HEATER_HIGH_1S;
-            delay_ms = DELAY_HEATER_1S;
-            break;
-        case HEATER_HIGH_0_1S:
-            cmd = CMD_HEATER_HIGH_0_1S;
-            delay_ms = DELAY_HEATER_0_1S;
-            break;
-        case HEATER_MEDIUM_1S:
-            cmd = CMD_HEATER_MEDIUM_1S;
-            delay_ms = DELAY_HEATER_1S;
-            break;
-        case HEATER_MEDIUM_0_1S:
-            cmd = CMD_HEATER_MEDIUM_0_1S;
-            delay_ms = DELAY_HEATER_0_1S;
-            break;
-        case HEATER_LOW_1S:
-            cmd = CMD_HEATER_LOW_1S;
-            delay_ms = DELAY_HEATER_1S;
-            break;
-        case HEATER_LOW_0_1S:
-            cmd = CMD_HEATER_LOW_0_1S;
-            delay_ms = DELAY_HEATER_0_1S;
-            break;
-        default:
-            return false;
+    if (!sht4x_heater_cmd(mode, &cmd, &delay_ms)) {
+        return false;
     }
     // Também chama a função interna para fazer o trabalho pesado
-    return sht4x_perform_measurement(cmd, delay_ms, temperature, humidity);
+    if (!sht4x_perform_measurement(cmd, delay_ms, &raw_temp, &raw_humi)) {
+        return false;
+    }
+    sht4x_convert_float(raw_temp, raw_humi, temperature, humidity);
+    return true;
+}
+
+//Inicia uma medição no nivel de precisao escolhido, sem esperar o resultado
+SHT4x_Status sht4x_start_measurement(SHT4x_Precision precision) {
+    uint8_t cmd;
+    uint16_t delay_ms;
+
+    if (!sht4x_precision_cmd(precision, &cmd, &delay_ms)) {
+        return SHT4X_STATUS_ERROR;
+    }
+    return sht4x_start_cmd(cmd, delay_ms);
+}
+
+//Inicia um pulso do aquecedor (seguido de medição), sem esperar o resultado
+SHT4x_Status sht4x_start_heater(SHT4x_HeaterMode mode) {
+    uint8_t cmd;
+    uint16_t delay_ms;
+
+    if (!sht4x_heater_cmd(mode, &cmd, &delay_ms)) {
+        return SHT4X_STATUS_ERROR;
+    }
+    return sht4x_start_cmd(cmd, delay_ms);
+}
+
+//Indica se a medição iniciada já terminou (não acessa o barramento)
+bool sht4x_measurement_ready(void) {
+    return meas_pending && time_reached(meas_ready_at);
+}
+
+//Instante em que a medição em andamento termina
+absolute_time_t sht4x_measurement_ready_at(void) {
+    return meas_ready_at;
+}
+
+//Busca o resultado em centesimos; NOT_READY enquanto o prazo do datasheet não passou
+SHT4x_Status sht4x_fetch_result(int32_t *temp_centi, int32_t *hum_centi) {
+    uint16_t raw_temp, raw_humi;
+    SHT4x_Status status = sht4x_fetch_raw(&raw_temp, &raw_humi);
+    if (status == SHT4X_STATUS_OK) {
+        sht4x_convert_centi(raw_temp, raw_humi, temp_centi, hum_centi);
+    }
+    return status;
+}
+
+//Dorme até o prazo da medição em andamento e busca o resultado
+SHT4x_Status sht4x_wait_result(int32_t *temp_centi, int32_t *hum_centi) {
+    if (meas_pending) {
+        sleep_until(meas_ready_at);
+    }
+    return sht4x_fetch_result(temp_centi, hum_centi);
 }
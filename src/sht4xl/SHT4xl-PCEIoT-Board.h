@@ -2,9 +2,15 @@
 #define SHT4X_PCEIOT_BOARD_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "pico/time.h"
 
 // Endereco I2C padrao do SHT4x presente no datasheet
 #define SHT4X_I2C_ADDRESS 0x44
+// Clock máximo do SHT4x no barramento compartilhado (Fast-mode Plus)
+#ifndef SHT4X_I2C_MAX_HZ
+#define SHT4X_I2C_MAX_HZ 1000000
+#endif
 
 // Enumeracao para os niveis de precisao da medicao
 typedef enum {
@@ -23,14 +29,37 @@ typedef enum {
     HEATER_LOW_0_1S
 } SHT4x_HeaterMode;
 
+// Enumeracao para o resultado da API em duas fases
+typedef enum {
+    SHT4X_STATUS_OK = 0,
+    SHT4X_STATUS_NOT_READY,   // medição ainda em andamento
+    SHT4X_STATUS_ERROR,       // falha de I2C ou nenhuma medição iniciada
+    SHT4X_STATUS_CRC_ERROR,
+    SHT4X_STATUS_HEATER_AFFECTED // amostra válida, mas afetada pelo aquecedor (sht4x_heater.h)
+} SHT4x_Status;
+
 
-//Inicializa a comunicacao I2C e reseta o sensor
+//Inicializa o barramento I2C compartilhado (i2c_bus) e reseta o sensor
 bool sht4x_init(void);
  //Envia um comando de reset para o sensor
 bool sht4x_reset(void);
  //Le temperatura e umidade com um nivel de precisao 
 bool sht4x_read_temp_hum(SHT4x_Precision precision, float *temperature, float *humidity);
+ //Le temperatura e umidade em centesimos de °C e de %UR (sem ponto flutuante)
+bool sht4x_read_temp_hum_centi(SHT4x_Precision precision, int32_t *temp_centi, int32_t *hum_centi);
 //Le temperatura e umidade utilizando um modo de aquecedor
 bool sht4x_read_with_heater(SHT4x_HeaterMode mode, float *temperature, float *humidity);
 
+// --- INTERFACE EM DUAS FASES (NÃO BLOQUEANTE) ---
+//Inicia uma medição (ou pulso do aquecedor) e retorna logo após o comando
+SHT4x_Status sht4x_start_measurement(SHT4x_Precision precision);
+SHT4x_Status sht4x_start_heater(SHT4x_HeaterMode mode);
+//Prazo da medição em andamento (não acessa o barramento)
+bool sht4x_measurement_ready(void);
+absolute_time_t sht4x_measurement_ready_at(void);
+//Busca o resultado em centesimos; SHT4X_STATUS_NOT_READY antes do prazo
+SHT4x_Status sht4x_fetch_result(int32_t *temp_centi, int32_t *hum_centi);
+//Dorme até o prazo e busca o resultado
+SHT4x_Status sht4x_wait_result(int32_t *temp_centi, int32_t *hum_centi);
+
 #endif
@@ -0,0 +1,141 @@
+/**
+ * @file sht4x_heater.c
+ * @brief Agendador não bloqueante do aquecedor do SHT4x.
+ *
+ * Em ambientes muito úmidos o filme do sensor condensa e a umidade fica presa
+ * no limite de 100 %UR. O aquecedor interno evapora a água, mas aquece o
+ * sensor: a medição feita junto com o pulso e as seguintes (enquanto o sensor
+ * esfria) não representam o ambiente e são marcadas como afetadas.
+ *
+ * O duty cycle é garantido pelo espaçamento entre pulsos: depois de um pulso
+ * de duração d, o próximo só é permitido após d * 100 / max_duty_percent.
+ */
+
+#include "sht4x_heater.h"
+#include "pico/stdlib.h"
+
+static sht4x_heater_config_t config = SHT4X_HEATER_CONFIG_DEFAULT;
+
+static bool measuring = false;          // medição (ou pulso) iniciada e não lida
+static bool heating = false;            // a medição em andamento é um pulso do aquecedor
+static absolute_time_t next_sample_at;  // próxima medição normal
+static absolute_time_t heater_allowed_at; // próximo pulso permitido pelo duty cycle
+static uint8_t suspect_count = 0;       // amostras suspeitas seguidas
+static uint8_t settle_left = 0;         // amostras ainda descartadas após o pulso
+static int32_t last_hum_centi = -1;     // última umidade publicada (-1 = nenhuma)
+static uint32_t pulse_count = 0;
+
+// Duração do aquecimento de um modo, em ms
+static uint32_t heater_on_ms(SHT4x_HeaterMode mode) {
+    switch (mode) {
+        case HEATER_HIGH_1S:
+        case HEATER_MEDIUM_1S:
+        case HEATER_LOW_1S:
+            return 1000;
+        default:
+            return 100;
+    }
+}
+
+// Reinicia o agendador com uma nova configuração
+void sht4x_heater_init(const sht4x_heater_config_t *cfg) {
+    config = *cfg;
+    if (config.max_duty_percent == 0) config.max_duty_percent = 1;
+    if (config.max_duty_percent > 100) config.max_duty_percent = 100;
+    if (config.trigger_samples == 0) config.trigger_samples = 1;
+
+    measuring = false;
+    heating = false;
+    next_sample_at = get_absolute_time();
+    heater_allowed_at = next_sample_at;
+    suspect_count = 0;
+    settle_left = 0;
+    last_hum_centi = -1;
+    pulse_count = 0;
+}
+
+// Saturada, ou alta e sem variar: sinais de condensação no sensor
+static bool sample_suspect(int32_t hum_centi) {
+    if (hum_centi >= config.saturation_centi)
+        return true;
+    if (last_hum_centi < 0 || hum_centi < config.stuck_min_centi)
+        return false;
+    int32_t delta = hum_centi - last_hum_centi;
+    if (delta < 0) delta = -delta;
+    return delta <= config.stuck_delta_centi;
+}
+
+// Inicia um pulso se houver condensação suspeita e o duty cycle permitir
+static bool try_start_pulse(void) {
+    if (suspect_count < config.trigger_samples || !time_reached(heater_allowed_at))
+        return false;
+    if (sht4x_start_heater(config.mode) != SHT4X_STATUS_OK)
+        return false;
+
+    uint32_t on_ms = heater_on_ms(config.mode);
+    heater_allowed_at = make_timeout_time_ms(on_ms * 100 / config.max_duty_percent);
+    heating = true;
+    suspect_count = 0;
+    pulse_count++;
+    return true;
+}
+
+// Inicia a próxima medição (ou pulso) se o intervalo entre amostras já passou
+static SHT4x_Status start_next(void) {
+    if (!time_reached(next_sample_at))
+        return SHT4X_STATUS_NOT_READY;
+    if (!try_start_pulse()) {
+        SHT4x_Status status = sht4x_start_measurement(config.precision);
+        if (status != SHT4X_STATUS_OK)
+            return status;
+    }
+    measuring = true;
+    next_sample_at = make_timeout_time_ms(config.sample_period_ms);
+    return SHT4X_STATUS_NOT_READY;
+}
+
+// Avança o agendador: inicia medições/pulsos e entrega resultados sem bloquear
+// Logo após ler um resultado a próxima medição já é iniciada, de modo que ela
+// corre enquanto o laço faz outras coisas
+SHT4x_Status sht4x_heater_poll(sht4x_sample_t *sample) {
+    if (!measuring)
+        return start_next();
+
+    SHT4x_Status status = sht4x_fetch_result(&sample->temp_centi, &sample->hum_centi);
+    if (status == SHT4X_STATUS_NOT_READY)
+        return status;
+    measuring = false;
+
+    bool was_heating = heating;
+    heating = false;
+    if (status != SHT4X_STATUS_OK)
+        return status;
+
+    if (was_heating) {
+        // A medição do pulso é feita com o sensor quente; as próximas esfriando
+        settle_left = config.settle_samples;
+        sample->heater_affected = true;
+    } else if (settle_left > 0) {
+        settle_left--;
+        sample->heater_affected = true;
+    } else {
+        suspect_count = sample_suspect(sample->hum_centi)
+                        ? (suspect_count < 255 ? suspect_count + 1 : suspect_count)
+                        : 0;
+        last_hum_centi = sample->hum_centi;
+        sample->heater_affected = false;
+    }
+
+    start_next(); // uma falha aqui é reportada no próximo poll
+    return sample->heater_affected ? SHT4X_STATUS_HEATER_AFFECTED : SHT4X_STATUS_OK;
+}
+
+// Indica se um pulso do aquecedor está em andamento
+bool sht4x_heater_active(void) {
+    return measuring && heating;
+}
+
+// Total de pulsos disparados desde o init
+uint32_t sht4x_heater_pulse_count(void) {
+    return pulse_count;
+}
@@ -0,0 +1,58 @@
+#ifndef SHT4X_HEATER_H
+#define SHT4X_HEATER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "SHT4xl-PCEIoT-Board.h"
+
+// --- AGENDADOR DO AQUECEDOR ---
+// Mede o SHT4x sem bloquear e, quando a umidade satura ou trava em valores
+// altos (condensação), dispara pulsos do aquecedor com duty cycle limitado.
+// As amostras afetadas pelo aquecimento não entram na série publicada
+
+// Configuração do agendador
+typedef struct {
+    SHT4x_Precision precision;     // precisão das medições normais
+    uint32_t sample_period_ms;     // intervalo mínimo entre medições (0 = a cada poll)
+    uint16_t saturation_centi;     // UR considerada saturada (centésimos de %)
+    uint16_t stuck_min_centi;      // UR acima da qual leituras paradas são suspeitas
+    uint16_t stuck_delta_centi;    // variação máxima para considerar a leitura parada
+    uint8_t trigger_samples;       // amostras suspeitas seguidas antes de aquecer
+    SHT4x_HeaterMode mode;         // potência e duração do pulso
+    uint8_t max_duty_percent;      // tempo aquecendo / tempo total, no máximo (1 a 100)
+    uint8_t settle_samples;        // amostras descartadas após cada pulso
+} sht4x_heater_config_t;
+
+// Valores padrão: pulsos de 200 mW por 1 s, no máximo 10% do tempo (limite do datasheet)
+#define SHT4X_HEATER_CONFIG_DEFAULT { \
+    .precision = PRECISION_HIGH,      \
+    .sample_period_ms = 0,            \
+    .saturation_centi = 9900,         \
+    .stuck_min_centi = 9500,          \
+    .stuck_delta_centi = 2,           \
+    .trigger_samples = 5,             \
+    .mode = HEATER_HIGH_1S,           \
+    .max_duty_percent = 10,           \
+    .settle_samples = 3,              \
+}
+
+// Amostra entregue pelo agendador
+typedef struct {
+    int32_t temp_centi;
+    int32_t hum_centi;
+    bool heater_affected;          // medida durante ou logo após um pulso
+} sht4x_sample_t;
+
+void sht4x_heater_init(const sht4x_heater_config_t *config);
+// Avança o agendador sem bloquear. Retorna:
+//  SHT4X_STATUS_OK              nova amostra publicável em *sample
+//  SHT4X_STATUS_HEATER_AFFECTED nova amostra em *sample, fora da série publicada
+//  SHT4X_STATUS_NOT_READY       nada novo (medição ou pulso em andamento)
+//  SHT4X_STATUS_ERROR / CRC_ERROR falha na medição; a próxima chamada tenta de novo
+SHT4x_Status sht4x_heater_poll(sht4x_sample_t *sample);
+// Indica se um pulso do aquecedor está em andamento
+bool sht4x_heater_active(void);
+// Total de pulsos disparados desde o init
+uint32_t sht4x_heater_pulse_count(void);
+
+#endif // SHT4X_HEATER_H
@@ -0,0 +1,27 @@
+/**
+ * @file i2c.h
+ * @brief Substituto de hardware/i2c.h no host
+ *
+ * Os drivers não acessam o controlador: tudo passa por i2c_bus.h, que na
+ * simulação é implementado por sim_i2c_bus.c. Ficam só o tipo da instância e
+ * os bits de IC_DATA_CMD usados para montar sequências de DMA.
+ */
+
+#ifndef SIM_HARDWARE_I2C_H
+#define SIM_HARDWARE_I2C_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/error.h"
+
+typedef struct i2c_inst i2c_inst_t;
+extern i2c_inst_t sim_i2c0_inst;
+#define i2c0 (&sim_i2c0_inst)
+
+#define I2C_IC_DATA_CMD_DAT_BITS     0x000000ffu
+#define I2C_IC_DATA_CMD_CMD_BITS     0x00000100u
+#define I2C_IC_DATA_CMD_STOP_BITS    0x00000200u
+#define I2C_IC_DATA_CMD_RESTART_BITS 0x00000400u
+
+#endif // SIM_HARDWARE_I2C_H
@@ -0,0 +1,20 @@
+/**
+ * @file sync.h
+ * @brief Substituto de hardware/sync.h: a simulação roda em uma única thread,
+ * e as "interrupções" são chamadas diretas, então as seções críticas são vazias
+ */
+
+#ifndef SIM_HARDWARE_SYNC_H
+#define SIM_HARDWARE_SYNC_H
+
+#include <stdint.h>
+
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+static inline void __mem_fence_acquire(void) {}
+static inline void __mem_fence_release(void) {}
+static inline void __dmb(void) {}
+static inline void __wfe(void) {}
+static inline void __sev(void) {}
+
+#endif // SIM_HARDWARE_SYNC_H
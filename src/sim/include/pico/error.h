@@ -0,0 +1,17 @@
+/**
+ * @file error.h
+ * @brief Códigos de erro do pico-sdk usados pelos drivers (build de host)
+ */
+
+#ifndef SIM_PICO_ERROR_H
+#define SIM_PICO_ERROR_H
+
+enum pico_error_codes {
+    PICO_OK = 0,
+    PICO_ERROR_NONE = 0,
+    PICO_ERROR_TIMEOUT = -1,
+    PICO_ERROR_GENERIC = -2,
+    PICO_ERROR_NO_DATA = -3,
+};
+
+#endif // SIM_PICO_ERROR_H
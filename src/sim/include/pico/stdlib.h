@@ -0,0 +1,21 @@
+/**
+ * @file stdlib.h
+ * @brief Substituto de pico/stdlib.h para a compilação dos drivers no host
+ */
+
+#ifndef SIM_PICO_STDLIB_H
+#define SIM_PICO_STDLIB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/error.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+typedef unsigned int uint;
+
+static inline void tight_loop_contents(void) {}
+static inline bool stdio_init_all(void) { return true; }
+
+#endif // SIM_PICO_STDLIB_H
@@ -0,0 +1,45 @@
+/**
+ * @file time.h
+ * @brief Subconjunto de pico/time.h sobre o relógio virtual da simulação
+ *
+ * O tempo só avança quando o código espera (sleep_*, busy_wait_*) ou quando o
+ * barramento simulado cobra o tempo de uma transação, então os resultados
+ * são determinísticos e uma espera de 1 s não custa 1 s de verdade.
+ */
+
+#ifndef SIM_PICO_TIME_H
+#define SIM_PICO_TIME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef uint64_t absolute_time_t; ///< Microssegundos desde o "boot" simulado
+
+#define nil_time ((absolute_time_t)0)
+#define at_the_end_of_time ((absolute_time_t)UINT64_MAX)
+
+absolute_time_t get_absolute_time(void);
+uint32_t time_us_32(void);
+uint64_t time_us_64(void);
+
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000u); }
+static inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) { return t + us; }
+static inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) { return t + (uint64_t)ms * 1000u; }
+static inline absolute_time_t make_timeout_time_us(uint64_t us) { return get_absolute_time() + us; }
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) { return get_absolute_time() + (uint64_t)ms * 1000u; }
+static inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) {
+    return (int64_t)(to - from);
+}
+static inline bool time_reached(absolute_time_t t) { return get_absolute_time() >= t; }
+static inline bool is_nil_time(absolute_time_t t) { return t == nil_time; }
+
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+void sleep_until(absolute_time_t t);
+void busy_wait_us_32(uint32_t us);
+void busy_wait_us(uint64_t us);
+// Sem eventos na simulação: avança até o prazo e indica timeout
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp);
+
+#endif // SIM_PICO_TIME_H
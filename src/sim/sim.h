@@ -0,0 +1,109 @@
+/**
+ * @file sim.h
+ * @brief Simulação no host do barramento I2C da placa e dos seus quatro chips
+ *
+ * No build de host (opção PCEIOT_HOST_SIM do CMake) os drivers reais são
+ * compilados contra cabeçalhos substitutos do pico-sdk (src/sim/include) e
+ * contra esta implementação de i2c_bus.h. Cada transação é entregue ao modelo
+ * comportamental do endereço correspondente:
+ *
+ * - MS5637 (0x76): PROM com CRC-4 válido, conversões D1/D2 com tempo por OSR;
+ * - SHT4x (0x44): medições e pulsos do aquecedor com CRC-8 e NACK antes do prazo;
+ * - SX1509B (0x3E): banco de registradores com auto-incremento, botões,
+ *   fonte de interrupção e pino NINT;
+ * - SSD1306 (0x3C): decodifica comandos de janela e escreve a GDDRAM.
+ *
+ * O tempo é virtual (pico/time.h da simulação) e cada transação cobra do
+ * relógio o seu tempo de barramento, então contagens de transações, bytes e
+ * ocupação do barramento saem determinísticas.
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// --- RELÓGIO VIRTUAL ---
+uint64_t sim_time_us(void);
+void sim_time_advance_us(uint64_t us);
+
+// --- GPIO ---
+// Nível imposto por um chip simulado num pino de entrada (dreno aberto:
+// false puxa para baixo). Uma descida dispara a IRQ registrada no pino
+void sim_gpio_drive(unsigned int gpio, bool level);
+
+// --- BARRAMENTO ---
+/**
+ * @brief Modelo de um dispositivo no barramento simulado
+ *
+ * write/read recebem os bytes de uma fase (entre START/RESTART e STOP) e
+ * retornam false para NACK.
+ */
+typedef struct {
+    bool (*write)(const uint8_t *data, size_t len);
+    bool (*read)(uint8_t *data, size_t len);
+} sim_i2c_model_t;
+
+// Contadores de tráfego (por dispositivo ou totais)
+typedef struct {
+    uint32_t transactions; ///< Transações concluídas ou falhas
+    uint32_t nacks;        ///< Transações recusadas pelo modelo (ou sem dispositivo)
+    uint32_t bytes_written;
+    uint32_t bytes_read;
+    uint64_t bus_time_us;  ///< Tempo de barramento cobrado do relógio virtual
+} sim_i2c_counters_t;
+
+void sim_i2c_attach(uint8_t address, const sim_i2c_model_t *model);
+void sim_i2c_detach(uint8_t address);
+// Simula um escravo prendendo o SDA: as transações vencem o prazo e a fila
+// para até i2c_bus_service(). Com set_stuck o escravo só solta quando
+// chamado com false; com set_stuck_clocks, depois desse número de pulsos de SCL
+void sim_i2c_set_stuck(bool stuck);
+void sim_i2c_set_stuck_clocks(uint32_t clocks);
+// Pulsos de SCL gerados por GPIO (liberação do barramento) desde o início
+uint32_t sim_i2c_scl_pulses(void);
+// Uso interno: sim_platform.c avisa quando o firmware muda o nível de um pino
+void sim_i2c_line_changed(unsigned int gpio, bool level);
+// Atraso, em palavras enviadas, do atendimento de cada STOP_DET de uma
+// sequência por DMA (0 = IRQ imediata)
+void sim_i2c_set_irq_latency(uint32_t words);
+void sim_i2c_counters(uint8_t address, sim_i2c_counters_t *out);
+void sim_i2c_total_counters(sim_i2c_counters_t *out);
+void sim_i2c_clear_counters(void);
+
+// --- MS5637 ---
+void sim_ms5637_attach(void);
+// Valores brutos devolvidos pelas conversões D1 (pressão) e D2 (temperatura)
+void sim_ms5637_set_raw(uint32_t d1, uint32_t d2);
+// Corrompe a PROM (para exercitar o CRC-4)
+void sim_ms5637_corrupt_prom(bool corrupt);
+// Conversões iniciadas desde o attach: D2 (temperatura) ou D1 (pressão)
+uint32_t sim_ms5637_conversions(bool temperature);
+
+// --- SHT4x ---
+void sim_sht4x_attach(void);
+// Condição do ambiente em centésimos de °C e de %UR
+void sim_sht4x_set_conditions(int32_t temp_centi, int32_t hum_centi);
+uint32_t sim_sht4x_heater_pulses(void);
+// Estraga o CRC-8 das próximas respostas (para exercitar a verificação)
+void sim_sht4x_corrupt_crc(bool corrupt);
+
+// --- SX1509B ---
+// nint_gpio: pino do RP2040 ligado ao NINT
+void sim_sx1509_attach(unsigned int nint_gpio);
+// Nível de um botão (pinos 0-2 do banco A); true = pressionado
+void sim_sx1509_set_button(uint8_t button, bool pressed);
+uint8_t sim_sx1509_reg(uint8_t reg);
+// Recusa (NACK) as próximas `count` escritas em RegInterruptSource
+void sim_sx1509_nack_source_clear(unsigned count);
+
+// --- SSD1306 ---
+void sim_ssd1306_attach(void);
+bool sim_ssd1306_pixel(uint8_t x, uint8_t y);
+bool sim_ssd1306_display_on(void);
+// Bytes de dados escritos na GDDRAM desde o attach
+uint32_t sim_ssd1306_data_bytes(void);
+
+#endif // SIM_H
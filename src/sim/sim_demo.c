@@ -0,0 +1,138 @@
+/**
+ * @file sim_demo.c
+ * @brief Roda os drivers da placa sobre o barramento simulado e mostra o tráfego
+ *
+ * Lê os dois sensores, desenha e envia frames ao display (completo e parcial),
+ * pressiona um botão e consome o evento, e força um barramento preso para
+ * exercitar o prazo das transações. Ao fim imprime transações, bytes e tempo
+ * de barramento por dispositivo, todos determinísticos (relógio virtual).
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "pico/stdlib.h"
+#include "i2c_bus.h"
+#include "i2c_bus_profile.h"
+#include "ms5637.h"
+#include "SHT4xl-PCEIoT-Board.h"
+#include "ssd1306.h"
+#include "io_expander.h"
+#include "fixed_fmt.h"
+
+static ssd1306_t display;
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    printf("  %-44s %s\n", what, ok ? "ok" : "FALHOU");
+    if (!ok)
+        failures++;
+}
+
+// GDDRAM do modelo igual ao buffer de frame do driver
+static bool gddram_matches(const ssd1306_t *disp) {
+    for (uint8_t y = 0; y < SSD1306_HEIGHT; y++)
+        for (uint8_t x = 0; x < SSD1306_WIDTH; x++) {
+            bool want = (disp->buffer[(y / 8) * SSD1306_WIDTH + x] >> (y % 8)) & 1;
+            if (sim_ssd1306_pixel(x, y) != want)
+                return false;
+        }
+    return true;
+}
+
+static void print_counters(const char *name, uint8_t address) {
+    sim_i2c_counters_t c;
+    sim_i2c_counters(address, &c);
+    printf("  %-8s 0x%02X %6lu %5lu %7lu %6lu %9llu\n", name, address,
+           (unsigned long)c.transactions, (unsigned long)c.nacks,
+           (unsigned long)c.bytes_written, (unsigned long)c.bytes_read,
+           (unsigned long long)c.bus_time_us);
+}
+
+int main(void) {
+    char a[16], b[16];
+
+    sim_ms5637_attach();
+    sim_sht4x_attach();
+    sim_sx1509_attach(IO_EXPANDER_NINT_GPIO);
+    sim_ssd1306_attach();
+    sim_sht4x_set_conditions(2350, 4875);
+
+    printf("[SIM] Inicialização\n");
+    i2c_bus_init();
+    check(ssd1306_init(&display, SSD1306_I2C_ADDR), "ssd1306_init");
+    check(sim_ssd1306_display_on(), "display ligado (0xAF)");
+    ms5637_init();
+    check(sht4x_init(), "sht4x_init");
+    io_expander_init_buttons();
+    io_expander_init_leds();
+    io_expander_init_button_irq();
+
+    printf("[SIM] Sensores\n");
+    int32_t temp_ms = 0, press_ms = 0;
+    check(ms5637_read_temperature_pressure_centi(&temp_ms, &press_ms) == MS5637_STATUS_OK,
+          "MS5637 leitura (PROM com CRC-4 do modelo)");
+    fixed_fmt(a, sizeof(a), temp_ms, 2, 2, 0, " C");
+    fixed_fmt(b, sizeof(b), press_ms, 2, 2, 0, " mbar"); // Pa = centésimos de mbar
+    printf("  MS5637: %s, %s\n", a, b);
+    check(temp_ms == 2000 && press_ms == 110002, "MS5637 = exemplo do datasheet");
+
+    int32_t temp_sht = 0, hum_sht = 0;
+    check(sht4x_read_temp_hum_centi(PRECISION_HIGH, &temp_sht, &hum_sht),
+          "SHT4x leitura (CRC-8 do modelo)");
+    fixed_fmt(a, sizeof(a), temp_sht, 2, 2, 0, " C");
+    fixed_fmt(b, sizeof(b), hum_sht, 2, 2, 0, " %UR");
+    printf("  SHT4x: %s, %s\n", a, b);
+    check(temp_sht >= 2349 && temp_sht <= 2351 && hum_sht >= 4874 && hum_sht <= 4876,
+          "SHT4x = condição imposta (+-0,01)");
+
+    printf("[SIM] Display\n");
+    ssd1306_clear(&display);
+    ssd1306_draw_string(&display, 0, 0, "PCEIoT sim");
+    ssd1306_draw_string(&display, 0, 16, "T 23.50 C");
+    ssd1306_display(&display);
+    check(gddram_matches(&display), "GDDRAM = buffer (frame completo)");
+    printf("  enviados %u bytes, poupados %u\n", display.bytes_sent, display.bytes_saved);
+
+    ssd1306_draw_string(&display, 0, 16, "T 23.51 C");
+    check(ssd1306_display_async(&display, NULL), "ssd1306_display_async");
+    ssd1306_flush_wait(&display);
+    check(gddram_matches(&display), "GDDRAM = buffer (atualização parcial)");
+    printf("  enviados %u bytes, poupados %u\n", display.bytes_sent, display.bytes_saved);
+
+    printf("[SIM] Botões\n");
+    io_expander_event_t ev;
+    sim_sx1509_set_button(1, true);
+    io_expander_service();
+    check(io_expander_pop_event(&ev) && ev.button == 1 && ev.pressed, "evento botão 1 pressionado");
+    sim_sx1509_set_button(1, false);
+    io_expander_service();
+    check(io_expander_pop_event(&ev) && ev.button == 1 && !ev.pressed, "evento botão 1 solto");
+    check(sim_sx1509_reg(0x19) == 0, "RegInterruptSourceA limpo");
+
+    printf("[SIM] Barramento preso\n");
+    sim_i2c_set_stuck(true);
+    check(ms5637_read_temperature_pressure_centi(&temp_ms, &press_ms) != MS5637_STATUS_OK,
+          "leitura falha com SDA preso");
+    sim_i2c_set_stuck(false);
+    check(ms5637_read_temperature_pressure_centi(&temp_ms, &press_ms) == MS5637_STATUS_OK,
+          "leitura volta após a recuperação");
+    i2c_bus_stats_t stats;
+    i2c_bus_get_stats(&stats);
+    printf("  prazos vencidos %lu, recuperações %lu, abortos %lu\n",
+           (unsigned long)stats.timeouts, (unsigned long)stats.recoveries,
+           (unsigned long)stats.aborts);
+
+    printf("[SIM] Tráfego (tempo virtual %llu us)\n", (unsigned long long)sim_time_us());
+    printf("  %-8s %-4s %6s %5s %7s %6s %9s\n", "disp", "end", "trans", "nack", "escr", "lidos", "barr(us)");
+    print_counters("SSD1306", SSD1306_I2C_ADDR);
+    print_counters("MS5637", MS5637_ADDR);
+    print_counters("SHT4x", SHT4X_I2C_ADDRESS);
+    print_counters("SX1509", 0x3E);
+
+    printf("[SIM] Perfil do barramento (i2c_bus_profile)\n");
+    i2c_bus_profile_report();
+
+    printf("[SIM] %s\n", failures ? "FALHOU" : "OK");
+    return failures ? 1 : 0;
+}
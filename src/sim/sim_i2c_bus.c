@@ -0,0 +1,373 @@
+/**
+ * @file sim_i2c_bus.c
+ * @brief Implementação de i2c_bus.h sobre os modelos de chips da simulação
+ *
+ * Mesma fila por prioridade do motor real (i2c_bus_core.c), mas executada na
+ * hora: enviar uma transação com o barramento parado a processa (e a todas
+ * que os callbacks enfileirarem) antes de retornar. Transações enviadas
+ * durante o processamento entram na fila e saem pela prioridade, como na IRQ
+ * do I2C.
+ *
+ * As transações de bytes viram as mesmas palavras de IC_DATA_CMD que o motor
+ * coloca na FIFO (i2c_bus_next_word), e essas palavras, como as sequências
+ * por DMA, são executadas como pelo controlador: STOP, RESTART e troca de
+ * direção delimitam as fases entregues aos modelos. O fim de cada transação
+ * é decidido nos STOP_DET pelas mesmas condições do motor real.
+ *
+ * Uma transação que não termina (SDA preso por um escravo, sequência sem STOP
+ * final) cobra do relógio o prazo do motor, falha e para a fila, como o
+ * alarme do firmware. i2c_bus_service() executa então a liberação do motor
+ * real sobre os pinos simulados e retoma a fila.
+ */
+
+#include "i2c_bus.h"
+#include "i2c_bus_core.h"
+#include "i2c_bus_profile.h"
+#include "sim.h"
+#include "pico/stdlib.h"
+
+struct i2c_inst {
+    int unused;
+};
+i2c_inst_t sim_i2c0_inst;
+
+#define SIM_I2C_ADDRESSES 128
+#define SIM_I2C_PHASE_MAX 2048 // maior escrita numa fase (quadro do display e folga)
+
+// Como uma transação termina no barramento simulado
+typedef enum {
+    TXN_END_OK,
+    TXN_END_NACK, // modelo recusou (ou não há dispositivo): TX_ABRT
+    TXN_END_HUNG, // nenhum STOP_DET conclui a transação: só o prazo a termina
+} txn_end_t;
+
+static const sim_i2c_model_t *models[SIM_I2C_ADDRESSES];
+static sim_i2c_counters_t counters[SIM_I2C_ADDRESSES];
+static uint32_t stuck_clocks = 0; // pulsos de SCL até o escravo soltar o SDA (0 = não solta)
+static uint32_t scl_pulses = 0;
+static bool recovery_pending = false; // prazo vencido: fila parada até i2c_bus_service()
+static uint32_t irq_latency_words = 0;
+static uint32_t bus_hz = I2C_BUS_INIT_HZ;
+static i2c_bus_stats_t bus_stats;
+
+static bool processing = false;
+
+// Fase em andamento: do START (ou RESTART) até o STOP seguinte. Leituras vão
+// direto para o destino da transação
+static struct {
+    bool open;
+    bool read;
+    size_t len;
+    uint8_t *rx;
+    size_t rx_room;
+    uint8_t data[SIM_I2C_PHASE_MAX];
+} phase;
+
+void sim_i2c_attach(uint8_t address, const sim_i2c_model_t *model) {
+    if (address < SIM_I2C_ADDRESSES)
+        models[address] = model;
+}
+
+void sim_i2c_detach(uint8_t address) {
+    if (address < SIM_I2C_ADDRESSES)
+        models[address] = NULL;
+}
+
+void sim_i2c_set_stuck(bool stuck) {
+    stuck_clocks = 0;
+    sim_gpio_drive(I2C_BUS_SDA, !stuck);
+}
+
+void sim_i2c_set_stuck_clocks(uint32_t clocks) {
+    stuck_clocks = clocks;
+    sim_gpio_drive(I2C_BUS_SDA, false);
+}
+
+uint32_t sim_i2c_scl_pulses(void) {
+    return scl_pulses;
+}
+
+// Cada subida do SCL completa um pulso; o escravo preso termina o byte em
+// andamento e solta o SDA
+void sim_i2c_line_changed(unsigned int gpio, bool level) {
+    if (gpio != I2C_BUS_SCL || !level)
+        return;
+    scl_pulses++;
+    if (stuck_clocks && --stuck_clocks == 0)
+        sim_gpio_drive(I2C_BUS_SDA, true);
+}
+
+void sim_i2c_set_irq_latency(uint32_t words) {
+    irq_latency_words = words;
+}
+
+void sim_i2c_counters(uint8_t address, sim_i2c_counters_t *out) {
+    *out = counters[address & (SIM_I2C_ADDRESSES - 1)];
+}
+
+void sim_i2c_total_counters(sim_i2c_counters_t *out) {
+    *out = (sim_i2c_counters_t){0};
+    for (int a = 0; a < SIM_I2C_ADDRESSES; a++) {
+        out->transactions += counters[a].transactions;
+        out->nacks += counters[a].nacks;
+        out->bytes_written += counters[a].bytes_written;
+        out->bytes_read += counters[a].bytes_read;
+        out->bus_time_us += counters[a].bus_time_us;
+    }
+}
+
+void sim_i2c_clear_counters(void) {
+    for (int a = 0; a < SIM_I2C_ADDRESSES; a++)
+        counters[a] = (sim_i2c_counters_t){0};
+    bus_stats = (i2c_bus_stats_t){0};
+}
+
+void i2c_bus_init(void) {
+}
+
+void i2c_bus_device_init(i2c_bus_device_t *dev, uint8_t address, uint32_t max_hz) {
+    dev->address = address;
+    dev->max_hz = max_hz;
+    dev->timeout_us = I2C_BUS_DEFAULT_TIMEOUT_US;
+}
+
+uint32_t i2c_bus_clock_hz(void) {
+    return bus_hz;
+}
+
+// Tempo de barramento: 9 bits por byte, mais START/STOP, arredondado para cima
+static uint32_t wire_us(uint32_t bytes, uint32_t bits_extra) {
+    uint64_t bits = (uint64_t)bytes * 9u + bits_extra;
+    return (uint32_t)((bits * 1000000u + bus_hz - 1) / bus_hz);
+}
+
+// Entrega uma fase de escrita ao modelo (endereço + bytes)
+static bool phase_write(const i2c_txn_t *txn, const uint8_t *data, size_t len, uint32_t *us) {
+    const sim_i2c_model_t *model = models[txn->dev->address & (SIM_I2C_ADDRESSES - 1)];
+    *us += wire_us((uint32_t)len + 1, 2);
+    if (!model || !model->write || !model->write(data, len))
+        return false;
+    counters[txn->dev->address & (SIM_I2C_ADDRESSES - 1)].bytes_written += (uint32_t)len;
+    return true;
+}
+
+static bool phase_read(const i2c_txn_t *txn, uint8_t *data, size_t len, uint32_t *us) {
+    const sim_i2c_model_t *model = models[txn->dev->address & (SIM_I2C_ADDRESSES - 1)];
+    *us += wire_us((uint32_t)len + 1, 2);
+    if (!model || !model->read || !model->read(data, len))
+        return false;
+    counters[txn->dev->address & (SIM_I2C_ADDRESSES - 1)].bytes_read += (uint32_t)len;
+    return true;
+}
+
+static bool phase_close(const i2c_txn_t *txn, uint32_t *us) {
+    if (!phase.open)
+        return true;
+    phase.open = false;
+    if (!phase.read)
+        return phase_write(txn, phase.data, phase.len, us);
+    if (phase.len > phase.rx_room)
+        return false;
+    bool ok = phase_read(txn, phase.rx, phase.len, us);
+    phase.rx += phase.len;
+    phase.rx_room -= phase.len;
+    return ok;
+}
+
+// Executa uma palavra de IC_DATA_CMD como o controlador: RESTART ou troca de
+// direção começam outra fase (repeated start), STOP fecha a atual
+static bool ctl_word(const i2c_txn_t *txn, uint16_t word, uint32_t *us) {
+    bool read = (word & I2C_IC_DATA_CMD_CMD_BITS) != 0;
+    if (phase.open && ((word & I2C_IC_DATA_CMD_RESTART_BITS) || read != phase.read) &&
+        !phase_close(txn, us))
+        return false;
+    if (!phase.open) {
+        phase.open = true;
+        phase.read = read;
+        phase.len = 0;
+    }
+    if (!read) {
+        if (phase.len >= sizeof(phase.data))
+            return false;
+        phase.data[phase.len] = (uint8_t)(word & I2C_IC_DATA_CMD_DAT_BITS);
+    }
+    phase.len++;
+    return !(word & I2C_IC_DATA_CMD_STOP_BITS) || phase_close(txn, us);
+}
+
+// Transação de bytes: palavras montadas como na IRQ do motor
+static txn_end_t run_bytes(const i2c_txn_t *txn, uint32_t *us) {
+    i2c_bus_cursor_t cur = {0};
+    uint16_t word;
+    for (;;) {
+        if (!i2c_bus_next_word(&cur, txn, &word)) {
+            // Sem palavra e sem leitura pendente na FIFO de RX nada mais acontece
+            if (!i2c_bus_words_pending(&cur, txn) || cur.rx_pos == cur.rd_cmds)
+                return TXN_END_HUNG;
+            // FIFO de RX cheia: RX_FULL a esvazia (os bytes vão ao destino no STOP)
+            cur.rx_pos = cur.rd_cmds;
+            continue;
+        }
+        if (!ctl_word(txn, word, us))
+            return TXN_END_NACK;
+        if (word & I2C_IC_DATA_CMD_STOP_BITS) {
+            // STOP_DET: esvazia a FIFO de RX e confere o fim, como bus_irq_handler
+            cur.rx_pos = cur.rd_cmds;
+            if (i2c_bus_bytes_done(&cur, txn))
+                return TXN_END_OK;
+        }
+    }
+}
+
+/*
+ * Sequência por DMA. Cada STOP_DET é atendido `irq_latency_words` palavras
+ * depois do STOP; nesse meio tempo o DMA mantém a FIFO cheia e o controlador
+ * já desloca a palavra seguinte. Se o motor concluir antes do fim, o que
+ * ainda não saiu não chega ao dispositivo
+ */
+static txn_end_t run_words(const i2c_txn_t *txn, uint32_t *us) {
+    uint32_t n = txn->word_count;
+    uint32_t finish_at = UINT32_MAX; // palavras já enviadas quando o motor concluir
+    for (uint32_t i = 0; i < n && i < finish_at; i++) {
+        uint16_t word = txn->words[i];
+        // Só escritas: no modo DMA o motor não esvazia a FIFO de RX
+        if ((word & I2C_IC_DATA_CMD_CMD_BITS) || !ctl_word(txn, word, us))
+            return TXN_END_NACK;
+        if ((word & I2C_IC_DATA_CMD_STOP_BITS) && finish_at == UINT32_MAX) {
+            uint32_t sent = i + 1 + irq_latency_words < n ? i + 1 + irq_latency_words : n;
+            uint32_t taken = sent < n ? sent + 1 : n; // a seguinte está no registrador de saída
+            uint32_t handed = taken + I2C_BUS_FIFO_DEPTH < n ? taken + I2C_BUS_FIFO_DEPTH : n;
+            if (i2c_bus_words_done(handed < n, handed - taken, sent < n))
+                finish_at = sent;
+        }
+    }
+    if (finish_at == UINT32_MAX)
+        return TXN_END_HUNG;
+    phase.open = false; // fase cortada: sem STOP, o dispositivo a descarta
+    return TXN_END_OK;
+}
+
+// Executa uma transação; quando ela não termina, cobra o prazo do motor real
+// e deixa a liberação pendente
+static bool run_txn(i2c_txn_t *txn) {
+    sim_i2c_counters_t *c = &counters[txn->dev->address & (SIM_I2C_ADDRESSES - 1)];
+    bus_hz = txn->dev->max_hz;
+    uint32_t us = 0;
+    txn_end_t end;
+
+    phase.open = false;
+    phase.rx = txn->rx;
+    phase.rx_room = txn->words ? 0 : txn->rx_len;
+    if (!gpio_get(I2C_BUS_SDA))
+        end = TXN_END_HUNG; // sem START: o controlador espera o SDA até o prazo
+    else if (txn->words)
+        end = run_words(txn, &us);
+    else
+        end = run_bytes(txn, &us);
+
+    if (end == TXN_END_HUNG) {
+        us = i2c_bus_txn_budget_us(txn, bus_hz);
+        bus_stats.timeouts++;
+        recovery_pending = true;
+    } else if (end == TXN_END_NACK) {
+        bus_stats.aborts++;
+        c->nacks++;
+    }
+
+    bool ok = end == TXN_END_OK;
+    c->transactions++;
+    c->bus_time_us += us;
+    sim_time_advance_us(us);
+    i2c_bus_profile_record(txn, ok, us);
+    return ok;
+}
+
+// Executa a fila até esvaziar ou parar num prazo vencido
+static void bus_run(void) {
+    if (processing)
+        return;
+    processing = true;
+    i2c_txn_t *next;
+    while (!recovery_pending && (next = i2c_bus_queue_pop()) != NULL) {
+        next->state = I2C_TXN_ACTIVE;
+        bool ok = run_txn(next);
+        next->state = ok ? I2C_TXN_DONE : I2C_TXN_FAILED;
+        if (next->callback)
+            next->callback(next, ok);
+    }
+    processing = false;
+}
+
+bool i2c_bus_submit(i2c_txn_t *txn) {
+    if (!txn->dev || txn->prio >= I2C_BUS_PRIO_COUNT)
+        return false;
+    if (txn->words ? txn->word_count == 0
+                   : (txn->tx_len == 0 && txn->rx_len == 0))
+        return false;
+    if (txn->state == I2C_TXN_QUEUED || txn->state == I2C_TXN_ACTIVE)
+        return false;
+
+    txn->state = I2C_TXN_QUEUED;
+    i2c_bus_queue_push(txn);
+    bus_run();
+    return true;
+}
+
+// Chamada de dentro de um callback não teria como esperar: falha em vez de
+// travar. Uma liberação pendente é atendida aqui mesmo, como no motor real
+int i2c_bus_transfer(i2c_txn_t *txn) {
+    if (!i2c_bus_submit(txn))
+        return PICO_ERROR_GENERIC;
+    while (!i2c_bus_txn_finished(txn) && recovery_pending && !processing)
+        i2c_bus_service();
+    if (!i2c_bus_txn_finished(txn) || txn->state == I2C_TXN_FAILED)
+        return PICO_ERROR_GENERIC;
+    return txn->rx_len ? txn->rx_len : txn->tx_len;
+}
+
+int i2c_bus_write(const i2c_bus_device_t *dev, const uint8_t *src, size_t len) {
+    i2c_txn_t txn = {
+        .dev = dev, .tx = src, .tx_len = (uint16_t)len, .prio = I2C_BUS_PRIO_NORMAL,
+    };
+    return i2c_bus_transfer(&txn);
+}
+
+int i2c_bus_read(const i2c_bus_device_t *dev, uint8_t *dst, size_t len) {
+    i2c_txn_t txn = {
+        .dev = dev, .rx = dst, .rx_len = (uint16_t)len, .prio = I2C_BUS_PRIO_NORMAL,
+    };
+    return i2c_bus_transfer(&txn);
+}
+
+int i2c_bus_write_read(const i2c_bus_device_t *dev, const uint8_t *src, size_t src_len,
+                       uint8_t *dst, size_t dst_len) {
+    i2c_txn_t txn = {
+        .dev = dev, .tx = src, .tx_len = (uint16_t)src_len,
+        .rx = dst, .rx_len = (uint16_t)dst_len,
+        .restart = true, .prio = I2C_BUS_PRIO_NORMAL,
+    };
+    return i2c_bus_transfer(&txn);
+}
+
+// Liberação do motor real sobre os pinos simulados, no relógio virtual
+void i2c_bus_service(void) {
+    if (!recovery_pending)
+        return;
+    i2c_bus_clear();
+    bus_stats.recoveries++;
+    bus_hz = I2C_BUS_INIT_HZ;
+    recovery_pending = false;
+    bus_run();
+}
+
+bool i2c_bus_service_pending(void) {
+    return recovery_pending;
+}
+
+bool i2c_bus_busy(void) {
+    return processing || !i2c_bus_queue_empty();
+}
+
+void i2c_bus_get_stats(i2c_bus_stats_t *stats) {
+    *stats = bus_stats;
+}
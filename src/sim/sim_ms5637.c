@@ -0,0 +1,138 @@
+/**
+ * @file sim_ms5637.c
+ * @brief Modelo do MS5637-02BA03 no barramento simulado
+ *
+ * PROM com os coeficientes do exemplo do datasheet e CRC-4 calculado aqui
+ * pela rotina bit a bit da AN520 (independente da tabela de src/crc). As
+ * conversões levam o tempo máximo do datasheet para o OSR pedido; ler o ADC
+ * antes disso devolve 0, como no chip.
+ */
+
+#include "sim.h"
+#include "ms5637.h"
+#include "pico/time.h"
+
+// Tempo máximo de conversão por OSR (256 a 8192), em µs
+static const uint32_t conv_us[6] = {540, 1060, 2080, 4130, 8220, 16440};
+
+// Coeficientes C1-C6 do exemplo do datasheet (20,00 °C e 1100,02 mbar)
+static const uint16_t example_coeffs[6] = {46372, 43981, 29059, 27842, 31553, 28165};
+
+static uint16_t prom[8];
+static uint32_t raw_d1 = 6465444;
+static uint32_t raw_d2 = 8077636;
+
+static uint8_t last_cmd = 0xFF;
+static uint32_t adc_value = 0;     // resultado da última conversão concluída
+static uint32_t conv_value = 0;    // resultado da conversão em andamento
+static absolute_time_t conv_done_at = 0;
+static bool converting = false;
+static uint32_t conversions[2];    // D1 e D2 iniciadas desde o attach
+
+// CRC-4 da AN520, bit a bit
+static uint8_t reference_crc4(const uint16_t words[8]) {
+    uint16_t n_prom[8];
+    for (int i = 0; i < 8; i++)
+        n_prom[i] = words[i];
+    n_prom[0] &= 0x0FFF;
+    n_prom[7] = 0;
+
+    uint16_t n_rem = 0;
+    for (int cnt = 0; cnt < 16; cnt++) {
+        if (cnt % 2 == 1)
+            n_rem ^= n_prom[cnt >> 1] & 0x00FF;
+        else
+            n_rem ^= n_prom[cnt >> 1] >> 8;
+        for (int bit = 8; bit > 0; bit--)
+            n_rem = (n_rem & 0x8000) ? (uint16_t)((n_rem << 1) ^ 0x3000) : (uint16_t)(n_rem << 1);
+    }
+    return (n_rem >> 12) & 0x0F;
+}
+
+static void prom_build(bool corrupt) {
+    prom[0] = 0x00B0; // bits de fábrica
+    for (int i = 0; i < 6; i++)
+        prom[1 + i] = example_coeffs[i];
+    prom[7] = 0;
+    prom[0] |= (uint16_t)reference_crc4(prom) << 12;
+    if (corrupt)
+        prom[3] ^= 0x0100; // depois do CRC: a verificação deve falhar
+}
+
+// Conversão concluída passa para o registrador do ADC
+static void conv_update(void) {
+    if (converting && time_reached(conv_done_at)) {
+        adc_value = conv_value;
+        converting = false;
+    }
+}
+
+static bool ms5637_write(const uint8_t *data, size_t len) {
+    if (len != 1)
+        return false;
+    uint8_t cmd = data[0];
+    conv_update();
+
+    if (cmd == MS5637_RESET_COMMAND) {
+        converting = false;
+        adc_value = 0;
+    } else if ((cmd & 0xF0) == MS5637_CONVERT_D1_BASE || (cmd & 0xF0) == MS5637_CONVERT_D2_BASE) {
+        uint8_t osr = (cmd & 0x0F) / 2;
+        if ((cmd & 0x01) || osr > 5)
+            return false;
+        bool d1 = (cmd & 0xF0) == MS5637_CONVERT_D1_BASE;
+        conv_value = d1 ? raw_d1 : raw_d2;
+        conversions[d1 ? 0 : 1]++;
+        conv_done_at = delayed_by_us(get_absolute_time(), conv_us[osr]);
+        converting = true;
+        adc_value = 0;
+    } else if (cmd != MS5637_READ_ADC_COMMAND &&
+               !(cmd >= MS5637_PROM_READ_BASE && cmd <= MS5637_PROM_READ_BASE + 14 && !(cmd & 1))) {
+        return false;
+    }
+    last_cmd = cmd;
+    return true;
+}
+
+static bool ms5637_read(uint8_t *data, size_t len) {
+    conv_update();
+    if (last_cmd == MS5637_READ_ADC_COMMAND) {
+        // Lido antes do fim da conversão: 0. Depois da leitura o ADC zera
+        uint32_t value = converting ? 0 : adc_value;
+        for (size_t i = 0; i < len; i++)
+            data[i] = i < 3 ? (uint8_t)(value >> (16 - 8 * i)) : 0;
+        adc_value = 0;
+        return true;
+    }
+    if (last_cmd >= MS5637_PROM_READ_BASE && last_cmd <= MS5637_PROM_READ_BASE + 14) {
+        uint16_t word = prom[(last_cmd - MS5637_PROM_READ_BASE) / 2];
+        for (size_t i = 0; i < len; i++)
+            data[i] = i == 0 ? (uint8_t)(word >> 8) : i == 1 ? (uint8_t)word : 0;
+        return true;
+    }
+    return false;
+}
+
+static const sim_i2c_model_t ms5637_model = {ms5637_write, ms5637_read};
+
+void sim_ms5637_attach(void) {
+    prom_build(false);
+    last_cmd = 0xFF;
+    converting = false;
+    adc_value = 0;
+    conversions[0] = conversions[1] = 0;
+    sim_i2c_attach(MS5637_ADDR, &ms5637_model);
+}
+
+void sim_ms5637_set_raw(uint32_t d1, uint32_t d2) {
+    raw_d1 = d1 & 0xFFFFFF;
+    raw_d2 = d2 & 0xFFFFFF;
+}
+
+void sim_ms5637_corrupt_prom(bool corrupt) {
+    prom_build(corrupt);
+}
+
+uint32_t sim_ms5637_conversions(bool temperature) {
+    return conversions[temperature ? 1 : 0];
+}
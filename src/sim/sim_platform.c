@@ -0,0 +1,151 @@
+/**
+ * @file sim_platform.c
+ * @brief Relógio virtual e GPIO da simulação (pico/time.h e hardware/gpio.h)
+ */
+
+#include "sim.h"
+#include "pico/stdlib.h"
+
+#define SIM_GPIO_COUNT 30
+
+static uint64_t now_us = 0;
+
+// Estado dos pinos: nível imposto por um chip simulado e IRQ registrada
+static bool gpio_driven_low[SIM_GPIO_COUNT];
+static bool gpio_out[SIM_GPIO_COUNT];
+static bool gpio_out_level[SIM_GPIO_COUNT];
+static uint32_t gpio_irq_events[SIM_GPIO_COUNT];
+static gpio_irq_callback_t gpio_callback = NULL;
+
+uint64_t sim_time_us(void) {
+    return now_us;
+}
+
+void sim_time_advance_us(uint64_t us) {
+    now_us += us;
+}
+
+absolute_time_t get_absolute_time(void) {
+    return now_us;
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)now_us;
+}
+
+uint64_t time_us_64(void) {
+    return now_us;
+}
+
+void sleep_us(uint64_t us) {
+    now_us += us;
+}
+
+void sleep_ms(uint32_t ms) {
+    now_us += (uint64_t)ms * 1000u;
+}
+
+void sleep_until(absolute_time_t t) {
+    if (t > now_us)
+        now_us = t;
+}
+
+void busy_wait_us_32(uint32_t us) {
+    now_us += us;
+}
+
+void busy_wait_us(uint64_t us) {
+    now_us += us;
+}
+
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp) {
+    sleep_until(timeout_timestamp);
+    return true;
+}
+
+// O barramento simulado acompanha as linhas que o firmware move por GPIO
+// (pulsos de SCL da liberação)
+static void line_changed(unsigned int gpio, bool before) {
+    bool after = gpio_get(gpio);
+    if (after != before)
+        sim_i2c_line_changed(gpio, after);
+}
+
+void gpio_init(unsigned int gpio) {
+    if (gpio >= SIM_GPIO_COUNT)
+        return;
+    bool before = gpio_get(gpio);
+    gpio_out[gpio] = false;
+    gpio_out_level[gpio] = false;
+    line_changed(gpio, before);
+}
+
+void gpio_set_function(unsigned int gpio, enum gpio_function fn) {
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_set_dir(unsigned int gpio, bool out) {
+    if (gpio >= SIM_GPIO_COUNT)
+        return;
+    bool before = gpio_get(gpio);
+    gpio_out[gpio] = out;
+    line_changed(gpio, before);
+}
+
+void gpio_put(unsigned int gpio, bool value) {
+    if (gpio >= SIM_GPIO_COUNT)
+        return;
+    bool before = gpio_get(gpio);
+    gpio_out_level[gpio] = value;
+    line_changed(gpio, before);
+}
+
+// Entradas com pull-up: alto, a menos que um chip puxe a linha para baixo
+bool gpio_get(unsigned int gpio) {
+    if (gpio >= SIM_GPIO_COUNT)
+        return false;
+    if (gpio_out[gpio])
+        return gpio_out_level[gpio];
+    return !gpio_driven_low[gpio];
+}
+
+void gpio_pull_up(unsigned int gpio) {
+    (void)gpio;
+}
+
+void gpio_disable_pulls(unsigned int gpio) {
+    (void)gpio;
+}
+
+void gpio_set_irq_enabled(unsigned int gpio, uint32_t events, bool enabled) {
+    if (gpio >= SIM_GPIO_COUNT)
+        return;
+    if (enabled)
+        gpio_irq_events[gpio] |= events;
+    else
+        gpio_irq_events[gpio] &= ~events;
+}
+
+void gpio_set_irq_enabled_with_callback(unsigned int gpio, uint32_t events, bool enabled,
+                                        gpio_irq_callback_t callback) {
+    gpio_set_irq_enabled(gpio, events, enabled);
+    gpio_callback = callback;
+}
+
+// A "IRQ" roda na hora, dentro de quem mudou o nível (um modelo de chip)
+void sim_gpio_drive(unsigned int gpio, bool level) {
+    if (gpio >= SIM_GPIO_COUNT)
+        return;
+    bool before = gpio_get(gpio);
+    gpio_driven_low[gpio] = !level;
+    bool after = gpio_get(gpio);
+
+    uint32_t event = 0;
+    if (before && !after)
+        event = GPIO_IRQ_EDGE_FALL;
+    else if (!before && after)
+        event = GPIO_IRQ_EDGE_RISE;
+    if ((event & gpio_irq_events[gpio]) && gpio_callback)
+        gpio_callback(gpio, event);
+}
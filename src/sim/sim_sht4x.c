@@ -0,0 +1,142 @@
+/**
+ * @file sim_sht4x.c
+ * @brief Modelo do SHT4x no barramento simulado
+ *
+ * Responde aos comandos de medição, aquecedor, reset e número de série com
+ * palavras protegidas por CRC-8 (calculado aqui bit a bit). Enquanto mede, o
+ * chip não reconhece o endereço: leituras antes do prazo e novos comandos
+ * recebem NACK, como no sensor real. A medição feita no fim de um pulso do
+ * aquecedor sai quente (HEATER_RISE_CENTI acima do ambiente), para os testes
+ * distinguirem amostras afetadas. sim_sht4x_corrupt_crc() estraga o CRC
+ * das respostas seguintes, para exercitar a verificação do driver.
+ */
+
+#include "sim.h"
+#include "SHT4xl-PCEIoT-Board.h"
+#include "pico/time.h"
+
+#define CMD_RESET  0x94
+#define CMD_SERIAL 0x89
+#define HEATER_RISE_CENTI 2000 // sensor aquecido no fim do pulso (valor arbitrário)
+
+// Comandos e duração máxima (µs) das medições e pulsos do aquecedor
+typedef struct {
+    uint8_t cmd;
+    uint32_t duration_us;
+    bool heater;
+} sht4x_cmd_info_t;
+
+static const sht4x_cmd_info_t commands[] = {
+    {0xFD, 8300, false},   {0xF6, 4500, false},    {0xE0, 1600, false},
+    {0x39, 1008300, true}, {0x32, 108300, true},   {0x2F, 1008300, true},
+    {0x24, 108300, true},  {0x1E, 1008300, true},  {0x15, 108300, true},
+};
+
+static int32_t env_temp_centi = 2500;
+static int32_t env_hum_centi = 5000;
+static uint32_t heater_pulses = 0;
+static bool crc_corrupt = false;
+
+static uint8_t result[6];
+static bool result_valid = false;
+static bool measuring = false;
+static absolute_time_t ready_at = 0;
+
+// CRC-8 Sensirion (0x31, inicial 0xFF), bit a bit
+static uint8_t reference_crc8(const uint8_t *data, size_t len) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+static void put_word(uint8_t *out, uint16_t word) {
+    out[0] = (uint8_t)(word >> 8);
+    out[1] = (uint8_t)word;
+    out[2] = reference_crc8(out, 2);
+    if (crc_corrupt)
+        out[2] ^= 0x01;
+}
+
+// Inverso das fórmulas do datasheet: T = -45 + 175 * S / 65535, RH = -6 + 125 * S / 65535
+static uint16_t raw_from(int32_t centi, int32_t offset_centi, int32_t span_centi) {
+    int64_t raw = ((int64_t)(centi + offset_centi) * 65535 + span_centi / 2) / span_centi;
+    if (raw < 0) raw = 0;
+    if (raw > 65535) raw = 65535;
+    return (uint16_t)raw;
+}
+
+static void measuring_update(void) {
+    if (measuring && time_reached(ready_at)) {
+        measuring = false;
+        result_valid = true;
+    }
+}
+
+static bool sht4x_write(const uint8_t *data, size_t len) {
+    measuring_update();
+    if (measuring || len != 1)
+        return false;
+
+    uint8_t cmd = data[0];
+    if (cmd == CMD_RESET) {
+        result_valid = false;
+        return true;
+    }
+    if (cmd == CMD_SERIAL) {
+        put_word(&result[0], 0x1234);
+        put_word(&result[3], 0x5678);
+        result_valid = true;
+        return true;
+    }
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        if (commands[i].cmd != cmd)
+            continue;
+        int32_t temp_centi = env_temp_centi + (commands[i].heater ? HEATER_RISE_CENTI : 0);
+        put_word(&result[0], raw_from(temp_centi, 4500, 17500));
+        put_word(&result[3], raw_from(env_hum_centi, 600, 12500));
+        if (commands[i].heater)
+            heater_pulses++;
+        ready_at = delayed_by_us(get_absolute_time(), commands[i].duration_us);
+        measuring = true;
+        result_valid = false;
+        return true;
+    }
+    return false;
+}
+
+static bool sht4x_read(uint8_t *data, size_t len) {
+    measuring_update();
+    if (measuring || !result_valid || len > sizeof(result))
+        return false;
+    for (size_t i = 0; i < len; i++)
+        data[i] = result[i];
+    result_valid = false;
+    return true;
+}
+
+static const sim_i2c_model_t sht4x_model = {sht4x_write, sht4x_read};
+
+void sim_sht4x_attach(void) {
+    measuring = false;
+    result_valid = false;
+    heater_pulses = 0;
+    crc_corrupt = false;
+    sim_i2c_attach(SHT4X_I2C_ADDRESS, &sht4x_model);
+}
+
+void sim_sht4x_set_conditions(int32_t temp_centi, int32_t hum_centi) {
+    env_temp_centi = temp_centi;
+    env_hum_centi = hum_centi;
+}
+
+uint32_t sim_sht4x_heater_pulses(void) {
+    return heater_pulses;
+}
+
+void sim_sht4x_corrupt_crc(bool corrupt) {
+    crc_corrupt = corrupt;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file sim_ssd1306.c
+ * @brief Modelo do SSD1306 no barramento simulado
+ *
+ * Decodifica o byte de controle (Co, D/C#), os comandos com seus argumentos e
+ * os três modos de endereçamento, e escreve os dados numa GDDRAM de 8 páginas
+ * por 128 colunas. Após o reset o modo é o de página, como no chip.
+ */
+
+#include <string.h>
+#include "sim.h"
+
+#define SSD1306_ADDR  0x3C
+#define GDDRAM_COLS   128
+#define GDDRAM_PAGES  8
+
+static uint8_t gddram[GDDRAM_PAGES][GDDRAM_COLS];
+static bool display_on = false;
+static uint8_t addr_mode = 2; // 0 horizontal, 1 vertical, 2 página
+static uint8_t col, col_start, col_end;
+static uint8_t page, page_start, page_end;
+static uint32_t data_bytes = 0;
+
+// Comando em montagem: opcode e argumentos recebidos
+static uint8_t cmd_buf[8];
+static uint8_t cmd_len = 0;
+
+// Quantidade de argumentos de cada comando
+static uint8_t cmd_args(uint8_t op) {
+    switch (op) {
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+        case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+            return 1;
+        case 0x21: case 0x22: case 0xA3:
+            return 2;
+        case 0x29: case 0x2A:
+            return 5;
+        case 0x26: case 0x27:
+            return 6;
+        default:
+            return 0;
+    }
+}
+
+static void cmd_execute(const uint8_t *c) {
+    uint8_t op = c[0];
+    if (op == 0xAE || op == 0xAF) {
+        display_on = op == 0xAF;
+    } else if (op == 0x20) {
+        addr_mode = c[1] & 0x03;
+    } else if (op == 0x21) {
+        col_start = c[1] & 0x7F;
+        col_end = c[2] & 0x7F;
+        col = col_start;
+    } else if (op == 0x22) {
+        page_start = c[1] & 0x07;
+        page_end = c[2] & 0x07;
+        page = page_start;
+    } else if (op >= 0xB0 && op <= 0xB7) {
+        page = op & 0x07; // modo de página
+    } else if (op <= 0x0F) {
+        col = (col & 0xF0) | op;
+    } else if (op >= 0x10 && op <= 0x1F) {
+        col = (uint8_t)((col & 0x0F) | ((op & 0x0F) << 4)) & 0x7F;
+    }
+}
+
+static void cmd_byte(uint8_t b) {
+    cmd_buf[cmd_len++] = b;
+    if (cmd_len > cmd_args(cmd_buf[0])) {
+        cmd_execute(cmd_buf);
+        cmd_len = 0;
+    }
+}
+
+// Escreve um byte na posição atual e avança conforme o modo
+static void data_byte(uint8_t b) {
+    gddram[page][col] = b;
+    data_bytes++;
+    if (addr_mode == 0) {
+        if (col++ >= col_end) {
+            col = col_start;
+            page = page >= page_end ? page_start : page + 1;
+        }
+    } else if (addr_mode == 1) {
+        if (page++ >= page_end) {
+            page = page_start;
+            col = col >= col_end ? col_start : col + 1;
+        }
+    } else {
+        col = (col + 1) & 0x7F;
+    }
+}
+
+static bool ssd1306_write(const uint8_t *data, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        uint8_t ctrl = data[i++];
+        bool is_data = ctrl & 0x40;
+        if (ctrl & 0x80) {
+            // Co = 1: só um byte segue este controle
+            if (i < len) {
+                if (is_data)
+                    data_byte(data[i]);
+                else
+                    cmd_byte(data[i]);
+                i++;
+            }
+            continue;
+        }
+        for (; i < len; i++) {
+            if (is_data)
+                data_byte(data[i]);
+            else
+                cmd_byte(data[i]);
+        }
+    }
+    return true;
+}
+
+static bool ssd1306_read(uint8_t *data, size_t len) {
+    // Leitura de status: bit 6 = display desligado
+    for (size_t i = 0; i < len; i++)
+        data[i] = display_on ? 0x00 : 0x40;
+    return true;
+}
+
+static const sim_i2c_model_t ssd1306_model = {ssd1306_write, ssd1306_read};
+
+void sim_ssd1306_attach(void) {
+    memset(gddram, 0xA5, sizeof(gddram)); // conteúdo indefinido após o power-up
+    display_on = false;
+    addr_mode = 2;
+    col = col_start = 0;
+    col_end = GDDRAM_COLS - 1;
+    page = page_start = 0;
+    page_end = GDDRAM_PAGES - 1;
+    cmd_len = 0;
+    data_bytes = 0;
+    sim_i2c_attach(SSD1306_ADDR, &ssd1306_model);
+}
+
+bool sim_ssd1306_pixel(uint8_t x, uint8_t y) {
+    if (x >= GDDRAM_COLS || y >= GDDRAM_PAGES * 8)
+        return false;
+    return (gddram[y / 8][x] >> (y % 8)) & 1;
+}
+
+bool sim_ssd1306_display_on(void) {
+    return display_on;
+}
+
+uint32_t sim_ssd1306_data_bytes(void) {
+    return data_bytes;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file sim_sx1509.c
+ * @brief Modelo do SX1509B no barramento simulado
+ *
+ * Banco de registradores com ponteiro de auto-incremento e valores de reset
+ * do datasheet. Os botões ficam nos pinos 0-2 do banco A; uma borda que casa
+ * com RegSenseLowA num pino não mascarado marca RegInterruptSourceA e puxa o
+ * NINT para baixo até a fonte ser limpa: escrevendo 1 nos bits ou, com
+ * RegMisc bit 0 = 0 (reset), lendo RegDataB/A.
+ */
+
+#include "sim.h"
+
+#define SX1509_ADDR 0x3E
+#define SX1509_REGS 0x80
+
+#define REG_DIR_A              0x0F
+#define REG_DATA_A             0x11
+#define REG_INTERRUPT_MASK_A   0x13
+#define REG_SENSE_LOW_A        0x17
+#define REG_INTERRUPT_SOURCE_B 0x18
+#define REG_INTERRUPT_SOURCE_A 0x19
+#define REG_MISC               0x1F
+
+// RegMisc bit 0 = 0 (reset): ler RegDataB/A limpa a fonte e solta o NINT
+#define MISC_NINT_CLEAR_ON_WRITE 0x01
+
+static uint8_t regs[SX1509_REGS];
+static uint8_t pointer = 0;
+static uint8_t buttons = 0;       // nível dos pinos 0-2 do banco A
+static unsigned int nint_gpio = 0;
+static bool nint_low = false;
+static unsigned source_clear_nacks = 0; // escritas na fonte a recusar
+
+// Valores de reset: direção, dados e máscaras em 0xFF, IOn dos 16 pinos em 0xFF
+static void regs_reset(void) {
+    static const uint8_t led_group_base[4] = {0x29, 0x35, 0x49, 0x55};
+    for (int r = 0; r < SX1509_REGS; r++)
+        regs[r] = 0;
+    for (uint8_t r = 0x0E; r <= 0x13; r++)
+        regs[r] = 0xFF;
+    for (uint8_t pin = 0; pin < 16; pin++) {
+        uint8_t stride = (pin & 0x04) ? 5 : 3;
+        regs[led_group_base[pin >> 2] + stride * (pin & 0x03) + 1] = 0xFF;
+    }
+}
+
+static void nint_update(void) {
+    bool low = (regs[REG_INTERRUPT_SOURCE_A] | regs[REG_INTERRUPT_SOURCE_B]) != 0;
+    if (low != nint_low) {
+        nint_low = low;
+        sim_gpio_drive(nint_gpio, !low);
+    }
+}
+
+// Valor de um registrador sem efeitos colaterais. Em DATA_A os pinos de
+// entrada mostram o nível externo
+static uint8_t reg_peek(uint8_t reg) {
+    if (reg == REG_DATA_A) {
+        uint8_t inputs = regs[REG_DIR_A] & 0x07;
+        return (uint8_t)((regs[REG_DATA_A] & ~inputs) | (buttons & inputs));
+    }
+    return regs[reg & (SX1509_REGS - 1)];
+}
+
+// Leitura pelo barramento: com RegMisc bit 0 = 0, ler RegData limpa a fonte
+static uint8_t reg_read(uint8_t reg) {
+    uint8_t value = reg_peek(reg);
+    if ((reg == REG_DATA_A || reg == REG_DATA_A - 1) &&
+        !(regs[REG_MISC] & MISC_NINT_CLEAR_ON_WRITE)) {
+        regs[REG_INTERRUPT_SOURCE_A] = 0;
+        regs[REG_INTERRUPT_SOURCE_B] = 0;
+        nint_update();
+    }
+    return value;
+}
+
+static void reg_write(uint8_t reg, uint8_t value) {
+    reg &= SX1509_REGS - 1;
+    if (reg == REG_INTERRUPT_SOURCE_A || reg == REG_INTERRUPT_SOURCE_B) {
+        regs[reg] &= (uint8_t)~value;
+        nint_update();
+        return;
+    }
+    regs[reg] = value;
+}
+
+static bool sx1509_write(const uint8_t *data, size_t len) {
+    if (len == 0)
+        return false;
+    if (source_clear_nacks && len > 1 &&
+        (data[0] == REG_INTERRUPT_SOURCE_A || data[0] == REG_INTERRUPT_SOURCE_B)) {
+        source_clear_nacks--;
+        return false;
+    }
+    pointer = data[0];
+    for (size_t i = 1; i < len; i++)
+        reg_write(pointer++, data[i]);
+    return true;
+}
+
+static bool sx1509_read(uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++)
+        data[i] = reg_read(pointer++);
+    return true;
+}
+
+static const sim_i2c_model_t sx1509_model = {sx1509_write, sx1509_read};
+
+void sim_sx1509_attach(unsigned int gpio) {
+    regs_reset();
+    pointer = 0;
+    buttons = 0;
+    nint_gpio = gpio;
+    nint_low = false;
+    source_clear_nacks = 0;
+    sim_gpio_drive(nint_gpio, true);
+    sim_i2c_attach(SX1509_ADDR, &sx1509_model);
+}
+
+// Borda num botão: RegSenseLowA tem 2 bits por pino (01 subida, 10 descida)
+void sim_sx1509_set_button(uint8_t button, bool pressed) {
+    if (button > 2)
+        return;
+    uint8_t bit = 1 << button;
+    bool was = buttons & bit;
+    if (was == pressed)
+        return;
+    buttons = pressed ? (buttons | bit) : (buttons & ~bit);
+
+    uint8_t sense = (regs[REG_SENSE_LOW_A] >> (2 * button)) & 0x03;
+    bool edge_match = pressed ? (sense & 0x01) : (sense & 0x02);
+    if (edge_match && !(regs[REG_INTERRUPT_MASK_A] & bit)) {
+        regs[REG_INTERRUPT_SOURCE_A] |= bit;
+        nint_update();
+    }
+}
+
+void sim_sx1509_nack_source_clear(unsigned count) {
+    source_clear_nacks = count;
+}
+
+uint8_t sim_sx1509_reg(uint8_t reg) {
+    return reg_peek(reg);
+}
@@ -0,0 +1,124 @@
+/**
+ * @file bench_altitude.c
+ * @brief Altitude em ponto fixo contra powf(): limite de erro e amostras/s
+ *
+ * Varre P0 de 950 a 1030 hPa e P em passos de 3 Pa por toda a faixa da
+ * tabela (P/P0 de 0,5 a 1,125) e confere o erro de ms5637_altitude_cm() em
+ * relação à fórmula exata em double contra o limite documentado (1,9 cm; 1,3 cm
+ * entre -1 km e +1 km) e a diferença para o powf() em float (2,1 cm),
+ * imprimindo também o erro do próprio powf(). Depois mede amostras por segundo no host da
+ * altitude sozinha e do caminho completo ADC -> Pa -> altitude, com o
+ * calculate_altitude() de antes (powf) e com a tabela.
+ */
+
+#include <math.h>
+#include <time.h>
+#include "sim.h"
+#include "sim_test.h"
+#include "ms5637.h"
+#include "ms5637_altitude.h"
+
+#define BENCH_SAMPLES 2000000
+
+// Limites documentados em ms5637_altitude.c e no README do driver (cm)
+#define ERROR_BOUND_CM      1.9
+#define ERROR_BOUND_1KM_CM  1.3
+#define ERROR_BOUND_POWF_CM 2.1
+
+static volatile int32_t sink_cm;
+static volatile float sink_m;
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// O calculate_altitude() de main.c antes da tabela
+static float calculate_altitude(float pressure_hpa, float baseline_hpa) {
+    return 44330.0f * (1.0f - powf(pressure_hpa / baseline_hpa, 1.0f / 5.255f));
+}
+
+static double exact_cm(int32_t p, int32_t p0) {
+    return 4433000.0 * (1.0 - pow((double)p / p0, 1.0 / 5.255));
+}
+
+// Pressões de uma subida e descida de ~5 km ao redor de 1013,25 hPa
+static int32_t sample_pa(uint32_t i) {
+    return 60000 + (int32_t)(i % 45000);
+}
+
+static double rate(uint64_t ns) {
+    return BENCH_SAMPLES / ((double)ns / 1e9);
+}
+
+int main(void) {
+    double max_err = 0, max_err_1km = 0, max_powf = 0, max_diff = 0;
+    for (int32_t p0 = 95000; p0 <= 103000; p0 += 500) {
+        int32_t p_min = (int32_t)(p0 * 0.5) + 1;
+        int32_t p_max = (int32_t)(p0 * 1.125);
+        for (int32_t p = p_min; p <= p_max; p += 3) {
+            double exact = exact_cm(p, p0);
+            int32_t fixed = ms5637_altitude_cm(p, p0);
+            double flt = calculate_altitude(p / 100.0f, p0 / 100.0f) * 100.0;
+            double err = fabs(fixed - exact);
+            max_err = fmax(max_err, err);
+            if (fabs(exact) <= 100000)
+                max_err_1km = fmax(max_err_1km, err);
+            max_powf = fmax(max_powf, fabs(flt - exact));
+            max_diff = fmax(max_diff, fabs(fixed - flt));
+        }
+    }
+    printf("[altitude] erro máximo contra a fórmula exata (double)\n");
+    printf("  %-34s %6.2f cm\n", "tabela, faixa inteira", max_err);
+    printf("  %-34s %6.2f cm\n", "tabela, -1 km a +1 km", max_err_1km);
+    printf("  %-34s %6.2f cm\n", "powf() em float, faixa inteira", max_powf);
+    printf("  %-34s %6.2f cm\n", "tabela contra powf()", max_diff);
+    sim_check(max_err <= ERROR_BOUND_CM + 0.05, "erro <= 1,9 cm na faixa da tabela");
+    sim_check(max_err_1km <= ERROR_BOUND_1KM_CM + 0.05, "erro <= 1,3 cm entre -1 km e +1 km");
+    sim_check(max_diff <= ERROR_BOUND_POWF_CM, "diferença para powf() <= 2,1 cm");
+
+    sim_check(ms5637_altitude_cm(101325, 101325) == 0, "P = P0 -> 0 cm");
+    sim_check(ms5637_altitude_cm(30000, 101325) == ms5637_altitude_cm(20000, 101325),
+              "abaixo de P/P0 = 0,5 satura");
+    sim_check(ms5637_altitude_cm(120000, 101325) == ms5637_altitude_cm(130000, 101325),
+              "acima de P/P0 = 1,125 satura");
+
+    // Só a altitude
+    uint64_t ns = host_ns();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+        sink_m = calculate_altitude(sample_pa(i) / 100.0f, 1013.25f);
+    uint64_t ns_powf = host_ns() - ns;
+
+    ns = host_ns();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++)
+        sink_cm = ms5637_altitude_cm(sample_pa(i), 101325);
+    uint64_t ns_table = host_ns() - ns;
+
+    // ADC -> pressão -> altitude, com os coeficientes da PROM simulada
+    sim_ms5637_attach();
+    ms5637_init();
+    int32_t t, p;
+    ns = host_ns();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++) {
+        ms5637_compensate(6465444 + (i % 4096) * 64, 8077636, &t, &p);
+        sink_m = calculate_altitude(p / 100.0f, 1013.25f);
+    }
+    uint64_t ns_pipe_powf = host_ns() - ns;
+
+    ns = host_ns();
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++) {
+        ms5637_compensate(6465444 + (i % 4096) * 64, 8077636, &t, &p);
+        sink_cm = ms5637_altitude_cm(p, 101325);
+    }
+    uint64_t ns_pipe_table = host_ns() - ns;
+
+    printf("[bench altitude] %d amostras, amostras/s no host\n", BENCH_SAMPLES);
+    printf("  %-34s %12s %12s %8s\n", "caminho", "powf", "tabela", "ganho");
+    printf("  %-34s %12.0f %12.0f %7.1fx\n", "altitude", rate(ns_powf), rate(ns_table),
+           (double)ns_powf / ns_table);
+    printf("  %-34s %12.0f %12.0f %7.1fx\n", "ADC -> Pa -> altitude", rate(ns_pipe_powf),
+           rate(ns_pipe_table), (double)ns_pipe_powf / ns_pipe_table);
+
+    return sim_test_result("bench altitude");
+}
@@ -0,0 +1,73 @@
+/**
+ * @file bench_crc.c
+ * @brief Custo dos CRCs por tabela contra as rotinas bit a bit originais
+ *
+ * Compilado com CRC_NIBBLE_TABLES = 0 e = 1 e sempre com otimização, mede no
+ * host o tempo de uma resposta do SHT4x (duas palavras de 2 bytes) e de uma
+ * PROM do MS5637, e imprime a flash ocupada pelas tabelas. Os números do host
+ * servem para comparar as variantes entre si, não são o custo no RP2040.
+ */
+
+#include <time.h>
+#include "crc.h"
+#include "crc_reference.h"
+#include "sim_test.h"
+
+#define BENCH_ROUNDS 2000000
+
+static volatile uint8_t sink;
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Verificação de uma resposta de 6 bytes: CRC de cada palavra
+static void sht4x_table(const uint8_t *rx) {
+    sink = (uint8_t)(crc8_sensirion(rx, 2) ^ crc8_sensirion(rx + 3, 2));
+}
+
+static void sht4x_reference(const uint8_t *rx) {
+    sink = (uint8_t)(reference_crc8(rx, 2) ^ reference_crc8(rx + 3, 2));
+}
+
+static double bench_sht4x(void (*op)(const uint8_t *)) {
+    uint8_t rx[6] = {0x66, 0x12, 0x00, 0x7A, 0x4C, 0x00};
+    uint64_t ns = host_ns();
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        rx[1] = (uint8_t)i; // entrada diferente a cada volta
+        op(rx);
+    }
+    return (double)(host_ns() - ns) / BENCH_ROUNDS;
+}
+
+static double bench_prom(uint8_t (*crc)(const uint16_t *)) {
+    uint16_t prom[8] = {0x40B0, 46372, 43981, 29059, 27842, 31553, 28165, 0};
+    uint64_t ns = host_ns();
+    for (uint32_t i = 0; i < BENCH_ROUNDS / 4; i++) {
+        prom[3] = (uint16_t)i;
+        sink = crc(prom);
+    }
+    return (double)(host_ns() - ns) / (BENCH_ROUNDS / 4);
+}
+
+int main(void) {
+    const char *name = CRC_NIBBLE_TABLES ? "nibble (16)" : "byte (256)";
+    unsigned table_bytes = CRC_NIBBLE_TABLES ? 16 + 16 : 256 + 256;
+
+    double sht_table = bench_sht4x(sht4x_table);
+    double sht_ref = bench_sht4x(sht4x_reference);
+    double prom_table = bench_prom(crc4_ms5637);
+    double prom_ref = bench_prom(reference_crc4);
+
+    printf("[bench crc] tabelas %s: %u B de flash\n", name, table_bytes);
+    printf("  %-24s %10s %10s %8s\n", "operação", "tabela(ns)", "bits(ns)", "ganho");
+    printf("  %-24s %10.1f %10.1f %7.1fx\n", "resposta SHT4x (6 B)", sht_table, sht_ref,
+           sht_ref / sht_table);
+    printf("  %-24s %10.1f %10.1f %7.1fx\n", "PROM MS5637 (16 B)", prom_table, prom_ref,
+           prom_ref / prom_table);
+
+    sim_check(sht_table > 0 && prom_table > 0, "medições concluídas");
+    return sim_test_result(CRC_NIBBLE_TABLES ? "bench crc nibble" : "bench crc");
+}
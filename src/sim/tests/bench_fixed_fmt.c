@@ -0,0 +1,124 @@
+/**
+ * @file bench_fixed_fmt.c
+ * @brief fixed_fmt() contra snprintf("%.2f") com float, em tempo e tamanho
+ *
+ * Confere que fixed_fmt() gera o mesmo texto que snprintf() com "%.2f" e
+ * "%*.2f" numa faixa que cobre temperatura, pressão, umidade e altitude,
+ * mede o tempo de host por chamada e imprime o tamanho do código e das
+ * tabelas de fixed_fmt.c. Para o lado do printf, com a libc estática do host,
+ * imprime o tamanho do formatador de float da glibc (printf_fp.o); no firmware
+ * o que sai é o printf de float do newlib/pico_printf, cujo tamanho só o
+ * .map do build ARM mostra.
+ *
+ * Argumentos (passados pelo CMake): nm, libpceiot_drivers.a e, se houver, libc.a.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim_test.h"
+#include "fixed_fmt.h"
+
+#define BENCH_CALLS 2000000
+
+static volatile size_t sink;
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Três chamadas por volta, como um quadro do painel do MS5637
+static double bench_fixed(void) {
+    char buf[20];
+    uint64_t ns = host_ns();
+    for (int32_t i = 0; i < BENCH_CALLS / 3; i++) {
+        sink = fixed_fmt(buf, sizeof(buf), 2300 + i % 500, 2, 2, 0, " C");
+        sink = fixed_fmt(buf, sizeof(buf), 101325 - i % 700, 2, 2, 0, " hPa");
+        sink = fixed_fmt(buf, sizeof(buf), 1520 + i % 300, 2, 2, 0, " m");
+    }
+    return (double)(host_ns() - ns) / (BENCH_CALLS / 3 * 3);
+}
+
+static double bench_snprintf(void) {
+    char buf[20];
+    uint64_t ns = host_ns();
+    for (int32_t i = 0; i < BENCH_CALLS / 3; i++) {
+        sink = (size_t)snprintf(buf, sizeof(buf), "%.2f C", (2300 + i % 500) / 100.0f);
+        sink = (size_t)snprintf(buf, sizeof(buf), "%.2f hPa", (101325 - i % 700) / 100.0f);
+        sink = (size_t)snprintf(buf, sizeof(buf), "%.2f m", (1520 + i % 300) / 100.0f);
+    }
+    return (double)(host_ns() - ns) / (BENCH_CALLS / 3 * 3);
+}
+
+// Soma dos tamanhos (nm -S) dos símbolos definidos num membro do arquivo .a
+static long member_bytes(const char *nm, const char *archive, const char *member) {
+    char cmd[512], line[512];
+    snprintf(cmd, sizeof(cmd), "'%s' -S -t d --defined-only '%s' 2>/dev/null", nm, archive);
+    FILE *pipe = popen(cmd, "r");
+    if (!pipe)
+        return -1;
+    long total = -1;
+    bool inside = false;
+    while (fgets(line, sizeof(line), pipe)) {
+        size_t len = strcspn(line, "\n");
+        if (len && line[len - 1] == ':') {
+            line[len - 1] = '\0';
+            inside = strcmp(line, member) == 0;
+            if (inside && total < 0)
+                total = 0;
+            continue;
+        }
+        long addr, size;
+        char type;
+        if (inside && sscanf(line, "%ld %ld %c", &addr, &size, &type) == 3 &&
+            strchr("TtRrDd", type))
+            total += size;
+    }
+    pclose(pipe);
+    return total;
+}
+
+int main(int argc, char **argv) {
+    char fixed[32], ref[32];
+    uint32_t mismatches = 0;
+    for (int32_t v = -100000; v <= 200000; v++) {
+        fixed_fmt(fixed, sizeof(fixed), v, 2, 2, 0, " hPa");
+        snprintf(ref, sizeof(ref), "%.2f hPa", v / 100.0f);
+        mismatches += strcmp(fixed, ref) != 0;
+    }
+    sim_check(mismatches == 0, "\"%.2f\" de -1000.00 a 2000.00 (float)");
+
+    mismatches = 0;
+    for (int32_t v = -100000; v <= 200000; v += 7) {
+        for (uint8_t width = 0; width <= 10; width += 5) {
+            fixed_fmt(fixed, sizeof(fixed), v, 2, 2, width, NULL);
+            snprintf(ref, sizeof(ref), "%*.2f", width, v / 100.0);
+            mismatches += strcmp(fixed, ref) != 0;
+        }
+    }
+    sim_check(mismatches == 0, "\"%*.2f\" com larguras 0, 5 e 10");
+
+    double t_fixed = bench_fixed();
+    double t_printf = bench_snprintf();
+    printf("[bench fixed_fmt] %d chamadas, tempo de host por chamada\n", BENCH_CALLS / 3 * 3);
+    printf("  %-28s %8.1f ns\n", "fixed_fmt()", t_fixed);
+    printf("  %-28s %8.1f ns (%.1fx)\n", "snprintf(\"%.2f\", float)", t_printf,
+           t_printf / t_fixed);
+
+    if (argc >= 3) {
+        long fixed_size = member_bytes(argv[1], argv[2], "fixed_fmt.c.o");
+        printf("[bench fixed_fmt] tamanho no host (x86-64, nm -S)\n");
+        printf("  %-28s %8ld B\n", "fixed_fmt.c (código + tabela)", fixed_size);
+        sim_check(fixed_size > 0, "tamanho de fixed_fmt.c lido");
+        if (argc >= 4) {
+            long fp_size = member_bytes(argv[1], argv[3], "printf_fp.o");
+            if (fp_size > 0)
+                printf("  %-28s %8ld B (%.0fx)\n", "glibc printf_fp.o (float)", fp_size,
+                       (double)fp_size / fixed_size);
+        }
+    }
+
+    return sim_test_result("bench fixed_fmt");
+}
@@ -0,0 +1,139 @@
+/**
+ * @file bench_render.c
+ * @brief Desenho por colunas/páginas contra o desenho pixel a pixel original
+ *
+ * Monta o quadro do painel do MS5637 (título, linhas, três rótulos, três
+ * valores e rodapé) com o driver atual e com as rotinas antigas de
+ * render_reference.h, confere que os dois framebuffers saem idênticos em todo
+ * quadro e mede o tempo de host por quadro e por primitiva. Só o desenho no
+ * buffer é medido; o envio ao painel é igual nos dois caminhos.
+ */
+
+#include <time.h>
+#include "sim_test.h"
+#include "render_reference.h"
+
+#define BENCH_FRAMES 20000
+
+static ssd1306_t fast;
+static ssd1306_t slow;
+static char values[3][16];
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Valores do quadro n, no formato do painel (mudam a cada quadro)
+static void frame_values(int n) {
+    snprintf(values[0], sizeof(values[0]), "%d.%02d C", 20 + n % 10, n % 100);
+    snprintf(values[1], sizeof(values[1]), "%d.%02d hPa", 1000 + n % 30, (n * 7) % 100);
+    snprintf(values[2], sizeof(values[2]), "%d.%02d m", 100 + n % 50, (n * 3) % 100);
+}
+
+// Mesmo leiaute de draw_ms5637_panel() em main.c
+static void panel_fast(ssd1306_t *d) {
+    ssd1306_clear(d);
+    ssd1306_draw_string(d, 30, 0, "MS5637 02BA03");
+    ssd1306_fill_rect(d, 0, 10, 128, 1, true);
+    ssd1306_draw_string(d, 10, 15, "Temperatura:");
+    ssd1306_draw_string(d, 80, 15, values[0]);
+    ssd1306_draw_string(d, 10, 27, "Pressao:");
+    ssd1306_draw_string(d, 80, 27, values[1]);
+    ssd1306_draw_string(d, 10, 39, "Altitude:");
+    ssd1306_draw_string(d, 80, 39, values[2]);
+    ssd1306_fill_rect(d, 0, 50, 128, 1, true);
+    ssd1306_draw_string(d, 15, 55, "Monitor Climatico 1");
+}
+
+static void panel_slow(ssd1306_t *d) {
+    ssd1306_clear(d);
+    reference_draw_string(d, 30, 0, "MS5637 02BA03");
+    reference_fill_rect(d, 0, 10, 128, 1, true);
+    reference_draw_string(d, 10, 15, "Temperatura:");
+    reference_draw_string(d, 80, 15, values[0]);
+    reference_draw_string(d, 10, 27, "Pressao:");
+    reference_draw_string(d, 80, 27, values[1]);
+    reference_draw_string(d, 10, 39, "Altitude:");
+    reference_draw_string(d, 80, 39, values[2]);
+    reference_fill_rect(d, 0, 50, 128, 1, true);
+    reference_draw_string(d, 15, 55, "Monitor Climatico 1");
+}
+
+// Primitivas isoladas: texto alinhado à página, texto entre páginas, retângulo
+static void text_aligned_fast(ssd1306_t *d) { ssd1306_draw_string(d, 0, 16, "Temperatura: 23.45"); }
+static void text_aligned_slow(ssd1306_t *d) { reference_draw_string(d, 0, 16, "Temperatura: 23.45"); }
+static void text_split_fast(ssd1306_t *d) { ssd1306_draw_string(d, 0, 27, "Temperatura: 23.45"); }
+static void text_split_slow(ssd1306_t *d) { reference_draw_string(d, 0, 27, "Temperatura: 23.45"); }
+static void rect_fast(ssd1306_t *d) { ssd1306_fill_rect(d, 4, 13, 120, 38, true); }
+static void rect_slow(ssd1306_t *d) { reference_fill_rect(d, 4, 13, 120, 38, true); }
+
+static double bench(void (*draw)(ssd1306_t *), ssd1306_t *d) {
+    uint64_t ns = host_ns();
+    for (int n = 0; n < BENCH_FRAMES; n++) {
+        d->buffer[n % SSD1306_BUFFER_SIZE] ^= 1; // impede que o laço seja descartado
+        draw(d);
+    }
+    return (double)(host_ns() - ns) / BENCH_FRAMES;
+}
+
+static bool same_frame(void) {
+    return memcmp(fast.buffer, slow.buffer, SSD1306_BUFFER_SIZE) == 0;
+}
+
+static void row(const char *name, void (*f)(ssd1306_t *), void (*s)(ssd1306_t *)) {
+    double t_fast = bench(f, &fast);
+    double t_slow = bench(s, &slow);
+    printf("  %-26s %10.0f %10.0f %7.1fx\n", name, t_fast, t_slow, t_slow / t_fast);
+}
+
+int main(void) {
+    fast.width = slow.width = SSD1306_WIDTH;
+    fast.height = slow.height = SSD1306_HEIGHT;
+    reference_font_capture(&slow);
+
+    // Todos os glifos, em todas as linhas de 0 a 56, dos dois jeitos
+    uint32_t mismatches = 0;
+    for (int y = 0; y <= SSD1306_HEIGHT - 8; y++) {
+        ssd1306_clear(&fast);
+        ssd1306_clear(&slow);
+        for (int c = 0; c < 95; c++) {
+            ssd1306_draw_char(&fast, (uint8_t)((c % 21) * 6), (uint8_t)y, (char)(32 + c));
+            reference_draw_char(&slow, (uint8_t)((c % 21) * 6), (uint8_t)y, (char)(32 + c));
+        }
+        mismatches += !same_frame();
+    }
+    sim_check(mismatches == 0, "glifos iguais em todas as linhas (y = 0..56)");
+
+    mismatches = 0;
+    for (int n = 0; n < 1000; n++) {
+        uint8_t x = (uint8_t)(n * 37 % 140), y = (uint8_t)(n * 11 % 72);
+        uint8_t w = (uint8_t)(n * 13 % 110), h = (uint8_t)(n * 7 % 70);
+        memset(fast.buffer, 0xA5, SSD1306_BUFFER_SIZE);
+        memset(slow.buffer, 0xA5, SSD1306_BUFFER_SIZE);
+        ssd1306_fill_rect(&fast, x, y, w, h, n & 1);
+        reference_fill_rect(&slow, x, y, w, h, n & 1);
+        mismatches += !same_frame();
+    }
+    sim_check(mismatches == 0, "1000 retângulos iguais (com corte na borda)");
+
+    mismatches = 0;
+    for (int n = 0; n < 1000; n++) {
+        frame_values(n);
+        panel_fast(&fast);
+        panel_slow(&slow);
+        mismatches += !same_frame();
+    }
+    sim_check(mismatches == 0, "1000 quadros do painel MS5637 idênticos");
+
+    frame_values(0);
+    printf("[bench render] %d quadros por linha, tempo de host por quadro\n", BENCH_FRAMES);
+    printf("  %-26s %10s %10s %8s\n", "quadro", "atual(ns)", "pixel(ns)", "ganho");
+    row("painel MS5637 completo", panel_fast, panel_slow);
+    row("18 caracteres, y = 16", text_aligned_fast, text_aligned_slow);
+    row("18 caracteres, y = 27", text_split_fast, text_split_slow);
+    row("retângulo 120x38", rect_fast, rect_slow);
+
+    return sim_test_result("bench render");
+}
@@ -0,0 +1,126 @@
+/**
+ * @file bench_throughput.c
+ * @brief Vazão do barramento e custo de CPU dos drivers sobre a simulação
+ *
+ * Para cada operação típica do laço principal mede, no relógio virtual
+ * (determinístico), o tempo de barramento e a duração total (com as esperas de
+ * conversão), além do tempo de CPU do host gasto nos drivers e no modelo. Do
+ * tempo de barramento sai a taxa máxima que o i2c0 sustenta só com aquela
+ * operação; o tempo de host serve para comparar versões do código, não é o
+ * custo no RP2040.
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include "sim.h"
+#include "sim_test.h"
+#include "ssd1306.h"
+#include "ms5637.h"
+#include "SHT4xl-PCEIoT-Board.h"
+#include "io_expander.h"
+
+#define BENCH_ROUNDS 200
+
+static ssd1306_t display;
+static int frame_counter = 0;
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Operações medidas
+static void full_frame(void) {
+    ssd1306_invalidate(&display);
+    ssd1306_display(&display);
+}
+
+static void partial_frame(void) {
+    char text[8];
+    snprintf(text, sizeof(text), "%05d", frame_counter++ % 100000);
+    ssd1306_fill_rect(&display, 80, 16, 40, 8, false);
+    ssd1306_draw_string(&display, 80, 16, text);
+    ssd1306_display(&display);
+}
+
+static void async_frame(void) {
+    ssd1306_invalidate(&display);
+    ssd1306_display_async(&display, NULL);
+    ssd1306_flush_wait(&display);
+}
+
+static void ms5637_read(void) {
+    int32_t t, p;
+    ms5637_read_temperature_pressure_centi(&t, &p);
+}
+
+static void sht4x_read(void) {
+    int32_t t, h;
+    sht4x_read_temp_hum_centi(PRECISION_HIGH, &t, &h);
+}
+
+static void button_event(void) {
+    io_expander_event_t ev;
+    sim_sx1509_set_button(0, true);
+    sim_sx1509_set_button(0, false);
+    while (io_expander_pop_event(&ev))
+        ;
+}
+
+// Roda a operação BENCH_ROUNDS vezes e imprime uma linha da tabela
+static void bench(const char *name, void (*op)(void)) {
+    sim_i2c_counters_t before, after;
+    sim_i2c_total_counters(&before);
+    uint64_t virt_us = sim_time_us();
+    uint64_t ns = host_ns();
+    for (int i = 0; i < BENCH_ROUNDS; i++)
+        op();
+    ns = host_ns() - ns;
+    virt_us = sim_time_us() - virt_us;
+    sim_i2c_total_counters(&after);
+
+    uint64_t bus_us = after.bus_time_us - before.bus_time_us;
+    uint64_t bytes = (after.bytes_written - before.bytes_written) +
+                     (uint64_t)(after.bytes_read - before.bytes_read);
+    double per_op_us = (double)bus_us / BENCH_ROUNDS;
+    printf("  %-22s %8.1f %8.1f %9.1f %10.1f %9.0f %9.2f\n", name,
+           (double)bytes / BENCH_ROUNDS, per_op_us, (double)virt_us / BENCH_ROUNDS,
+           per_op_us > 0 ? 1e6 / per_op_us : 0.0,
+           bus_us ? (double)bytes * 1e6 / bus_us : 0.0, (double)ns / BENCH_ROUNDS / 1000.0);
+}
+
+int main(void) {
+    sim_ssd1306_attach();
+    sim_ms5637_attach();
+    sim_sht4x_attach();
+    sim_sx1509_attach(IO_EXPANDER_NINT_GPIO);
+
+    sim_check(ssd1306_init(&display, SSD1306_I2C_ADDR), "ssd1306_init");
+    ms5637_init();
+    sim_check(sht4x_init(), "sht4x_init");
+    io_expander_init_button_irq();
+    ssd1306_draw_string(&display, 0, 0, "PCEIoT bench");
+    ssd1306_display(&display);
+
+    printf("[bench] %d rodadas por operação\n", BENCH_ROUNDS);
+    printf("  %-22s %8s %8s %9s %10s %9s %9s\n", "operação", "bytes", "barr(us)", "total(us)",
+           "max(op/s)", "B/s barr", "host(us)");
+    bench("quadro completo", full_frame);
+    bench("quadro completo async", async_frame);
+    bench("campo de 5 dígitos", partial_frame);
+    bench("MS5637 D2+D1 (8192)", ms5637_read);
+    ms5637_set_osr(MS5637_OSR_256);
+    bench("MS5637 D2+D1 (256)", ms5637_read);
+    bench("SHT4x alta precisão", sht4x_read);
+    bench("botão (2 bordas)", button_event);
+
+    sim_i2c_counters_t total;
+    sim_i2c_total_counters(&total);
+    printf("  total: %lu transações, %lu NACKs, tempo virtual %llu us\n",
+           (unsigned long)total.transactions, (unsigned long)total.nacks,
+           (unsigned long long)sim_time_us());
+    sim_check(total.nacks == 0, "nenhum NACK durante o benchmark");
+
+    return sim_test_result("bench");
+}
@@ -0,0 +1,201 @@
+/**
+ * @file bench_ui.c
+ * @brief Painéis em modo retido (ssd1306_ui) contra o redesenho completo
+ *
+ * O painel do MS5637 é atualizado de três formas: modo imediato como era em
+ * main.c (limpa o buffer e redesenha títulos, linhas, rótulos e valores a cada
+ * quadro), o mesmo com as rotinas pixel a pixel originais e modo retido
+ * (modelo desenhado uma vez, só os campos que mudaram). Os três buffers são
+ * conferidos iguais quadro a quadro. Para cada cenário de variação dos valores
+ * mede o tempo de host do desenho sozinho e com ssd1306_display() (inclui a
+ * comparação com a cópia sombra e o modelo do painel), os bytes e o tempo de
+ * barramento por quadro.
+ */
+
+#include <time.h>
+#include "sim.h"
+#include "sim_test.h"
+#include "render_reference.h"
+#include "ssd1306_ui.h"
+#include "fixed_fmt.h"
+
+#define BENCH_FRAMES 20000
+#define SENT_FRAMES  300
+
+static const ssd1306_ui_static_t ms5637_template[] = {
+    {SSD1306_UI_TEXT, 30, 0, 0, "MS5637 02BA03"},
+    {SSD1306_UI_RULE, 0, 10, 128, NULL},
+    {SSD1306_UI_TEXT, 10, 15, 0, "Temperatura:"},
+    {SSD1306_UI_TEXT, 10, 27, 0, "Pressao:"},
+    {SSD1306_UI_TEXT, 10, 39, 0, "Altitude:"},
+    {SSD1306_UI_RULE, 0, 50, 128, NULL},
+    {SSD1306_UI_TEXT, 15, 55, 0, "Monitor Climatico 1"},
+};
+
+static ssd1306_ui_field_t ms5637_fields[] = {
+    {80, 15, 8, ""},
+    {80, 27, 8, ""},
+    {80, 39, 8, ""},
+};
+
+static ssd1306_ui_panel_t ms5637_panel = {
+    ms5637_template, sizeof(ms5637_template) / sizeof(ms5637_template[0]),
+    ms5637_fields, sizeof(ms5637_fields) / sizeof(ms5637_fields[0]),
+};
+
+static const char *const suffixes[3] = {" C", " hPa", " m"};
+
+static ssd1306_t immediate;
+static ssd1306_t pixel;
+static ssd1306_t retained;
+
+// Cenários: temperatura (centi °C), pressão (Pa) e altitude (cm) no quadro n
+static void values_moving(int n, int32_t v[3]) {
+    v[0] = 2300 + n % 97;
+    v[1] = 101325 - n % 311;
+    v[2] = 1520 + n % 53;
+}
+
+// Leitura típica a 150 ms: altitude filtrada muda sempre, pressão a cada 2
+// quadros, temperatura a cada 8
+static void values_typical(int n, int32_t v[3]) {
+    v[0] = 2300 + (n / 8) % 20;
+    v[1] = 101325 - (n / 2) % 40;
+    v[2] = 1520 + n % 17;
+}
+
+static void values_still(int n, int32_t v[3]) {
+    (void)n;
+    v[0] = 2300;
+    v[1] = 101325;
+    v[2] = 1520;
+}
+
+static void (*values)(int n, int32_t v[3]);
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Modo imediato: o draw_ms5637_panel() de antes da camada de UI
+static void frame_immediate(ssd1306_t *d, int n) {
+    int32_t v[3];
+    char buf[20];
+    values(n, v);
+    ssd1306_clear(d);
+    for (unsigned i = 0; i < ms5637_panel.item_count; i++) {
+        const ssd1306_ui_static_t *item = &ms5637_template[i];
+        if (item->kind == SSD1306_UI_TEXT)
+            ssd1306_draw_string(d, item->x, item->y, item->text);
+        else
+            ssd1306_fill_rect(d, item->x, item->y, item->w, 1, true);
+    }
+    for (int f = 0; f < 3; f++) {
+        fixed_fmt(buf, sizeof(buf), v[f], 2, 2, 0, suffixes[f]);
+        ssd1306_draw_string(d, ms5637_fields[f].x, ms5637_fields[f].y, buf);
+    }
+}
+
+static void frame_pixel(ssd1306_t *d, int n) {
+    int32_t v[3];
+    char buf[20];
+    values(n, v);
+    ssd1306_clear(d);
+    for (unsigned i = 0; i < ms5637_panel.item_count; i++) {
+        const ssd1306_ui_static_t *item = &ms5637_template[i];
+        if (item->kind == SSD1306_UI_TEXT)
+            reference_draw_string(d, item->x, item->y, item->text);
+        else
+            reference_fill_rect(d, item->x, item->y, item->w, 1, true);
+    }
+    for (int f = 0; f < 3; f++) {
+        fixed_fmt(buf, sizeof(buf), v[f], 2, 2, 0, suffixes[f]);
+        reference_draw_string(d, ms5637_fields[f].x, ms5637_fields[f].y, buf);
+    }
+}
+
+static void frame_retained(ssd1306_t *d, int n) {
+    int32_t v[3];
+    char buf[20];
+    values(n, v);
+    for (int f = 0; f < 3; f++) {
+        fixed_fmt(buf, sizeof(buf), v[f], 2, 2, 0, suffixes[f]);
+        ssd1306_ui_field_set(d, &ms5637_fields[f], buf);
+    }
+}
+
+// Modelo no buffer e painel sincronizado, como ao entrar no painel
+static void start_retained(void) {
+    ssd1306_ui_panel_show(&retained, &ms5637_panel);
+    frame_retained(&retained, 0);
+    ssd1306_display(&retained);
+}
+
+static void row(const char *name, ssd1306_t *d, void (*frame)(ssd1306_t *, int)) {
+    uint64_t ns = host_ns();
+    for (int n = 1; n <= BENCH_FRAMES; n++)
+        frame(d, n);
+    ns = host_ns() - ns;
+
+    // Envio ao painel a partir de um quadro já sincronizado
+    frame(d, 0);
+    ssd1306_display(d);
+    sim_i2c_counters_t before, after;
+    sim_i2c_total_counters(&before);
+    uint32_t bytes = 0;
+    uint64_t sent_ns = host_ns();
+    for (int n = 1; n <= SENT_FRAMES; n++) {
+        frame(d, n);
+        ssd1306_display(d);
+        bytes += d->bytes_sent;
+    }
+    sent_ns = host_ns() - sent_ns;
+    sim_i2c_total_counters(&after);
+
+    printf("  %-26s %11.0f %11.0f %8.1f %9.1f\n", name, (double)ns / BENCH_FRAMES,
+           (double)sent_ns / SENT_FRAMES, (double)bytes / SENT_FRAMES,
+           (double)(after.bus_time_us - before.bus_time_us) / SENT_FRAMES);
+}
+
+static void scenario(const char *name, void (*v)(int n, int32_t v[3])) {
+    values = v;
+    start_retained();
+    printf("[bench ui] %s\n", name);
+    printf("  %-26s %11s %11s %8s %9s\n", "modo", "desenho(ns)", "c/envio(ns)", "bytes",
+           "barr(us)");
+    row("imediato", &immediate, frame_immediate);
+    row("imediato, pixel a pixel", &pixel, frame_pixel);
+    row("retido (ssd1306_ui)", &retained, frame_retained);
+}
+
+int main(void) {
+    sim_ssd1306_attach();
+    sim_check(ssd1306_init(&immediate, SSD1306_I2C_ADDR), "ssd1306_init (imediato)");
+    sim_check(ssd1306_init(&pixel, SSD1306_I2C_ADDR), "ssd1306_init (pixel a pixel)");
+    sim_check(ssd1306_init(&retained, SSD1306_I2C_ADDR), "ssd1306_init (retido)");
+    reference_font_capture(&pixel);
+
+    // Os três modos têm de produzir o mesmo quadro em todos os cenários
+    void (*const all[3])(int, int32_t[3]) = {values_moving, values_typical, values_still};
+    uint32_t mismatches = 0;
+    for (int s = 0; s < 3; s++) {
+        values = all[s];
+        start_retained();
+        for (int n = 0; n < 2000; n++) {
+            frame_immediate(&immediate, n);
+            frame_pixel(&pixel, n);
+            frame_retained(&retained, n);
+            mismatches += memcmp(immediate.buffer, retained.buffer, SSD1306_BUFFER_SIZE) != 0;
+            mismatches += memcmp(pixel.buffer, retained.buffer, SSD1306_BUFFER_SIZE) != 0;
+        }
+    }
+    sim_check(mismatches == 0, "quadros iguais nos três modos (3 x 2000)");
+
+    scenario("três valores mudando a cada quadro", values_moving);
+    scenario("leitura típica (T a cada 8, P a cada 2, alt sempre)", values_typical);
+    scenario("valores parados", values_still);
+
+    return sim_test_result("bench ui");
+}
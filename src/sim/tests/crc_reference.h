@@ -0,0 +1,58 @@
+/**
+ * @file crc_reference.h
+ * @brief Rotinas bit a bit originais dos drivers, referência dos CRCs por tabela
+ *
+ * sht4x_crc8() e crc4() como estavam no SHT4x e no MS5637 antes de src/crc.
+ * O crc4() original escrevia na PROM do chamador; aqui ele trabalha numa
+ * cópia, com o mesmo resultado.
+ */
+
+#ifndef CRC_REFERENCE_H
+#define CRC_REFERENCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+static inline uint8_t reference_crc8(const uint8_t *data, size_t len) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t j = 0; j < 8; j++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static inline uint8_t reference_crc4(const uint16_t prom[8]) {
+    uint16_t n_prom[8];
+    for (int i = 0; i < 8; i++)
+        n_prom[i] = prom[i];
+    uint16_t n_rem = 0x00;
+    n_prom[0] &= 0x0FFF;
+    n_prom[7] = 0;
+    for (int cnt = 0; cnt < 16; cnt++) {
+        if (cnt % 2 == 1)
+            n_rem ^= n_prom[cnt >> 1] & 0x00FF;
+        else
+            n_rem ^= n_prom[cnt >> 1] >> 8;
+        for (int n_bit = 8; n_bit > 0; n_bit--) {
+            if (n_rem & 0x8000)
+                n_rem = (n_rem << 1) ^ 0x3000;
+            else
+                n_rem <<= 1;
+        }
+    }
+    return (n_rem >> 12) & 0xF;
+}
+
+// Gerador pseudoaleatório fixo (xorshift32): entradas iguais a cada execução
+static inline uint32_t crc_test_random(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+#endif // CRC_REFERENCE_H
@@ -0,0 +1,56 @@
+/**
+ * @file render_reference.h
+ * @brief Desenho pixel a pixel como era antes do blitter, para comparação
+ *
+ * ssd1306_draw_char(), ssd1306_draw_string() e ssd1306_fill_rect() na forma
+ * original: um ssd1306_set_pixel() por pixel aceso do glifo ou do retângulo.
+ * A fonte é estática em ssd1306.c, então as colunas de cada glifo são
+ * capturadas uma vez com o driver atual (caminho alinhado) antes das medições.
+ */
+
+#ifndef RENDER_REFERENCE_H
+#define RENDER_REFERENCE_H
+
+#include <string.h>
+#include "ssd1306.h"
+
+static uint8_t reference_font[95][5];
+
+// Lê as colunas de cada glifo desenhando-o na página 0 de um buffer limpo
+static inline void reference_font_capture(ssd1306_t *scratch) {
+    for (int c = 0; c < 95; c++) {
+        memset(scratch->buffer, 0, SSD1306_WIDTH);
+        ssd1306_draw_char(scratch, 0, 0, (char)(32 + c));
+        memcpy(reference_font[c], scratch->buffer, 5);
+    }
+}
+
+static inline void reference_draw_char(ssd1306_t *display, uint8_t x, uint8_t y, char c) {
+    if (c < 32 || c > 126)
+        return;
+    const uint8_t *font_char = reference_font[c - 32];
+    for (int i = 0; i < 5; i++) {
+        uint8_t line = font_char[i];
+        for (int j = 0; j < 8; j++) {
+            if (line & (1 << j))
+                ssd1306_set_pixel(display, x + i, y + j, true);
+        }
+    }
+}
+
+static inline void reference_draw_string(ssd1306_t *display, uint8_t x, uint8_t y, const char *str) {
+    while (*str) {
+        reference_draw_char(display, x, y, *str);
+        x += 6;
+        str++;
+    }
+}
+
+static inline void reference_fill_rect(ssd1306_t *display, uint8_t x, uint8_t y, uint8_t w,
+                                       uint8_t h, bool on) {
+    for (uint8_t i = 0; i < w; i++)
+        for (uint8_t j = 0; j < h; j++)
+            ssd1306_set_pixel(display, x + i, y + j, on);
+}
+
+#endif // RENDER_REFERENCE_H
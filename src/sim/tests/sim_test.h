@@ -0,0 +1,29 @@
+/**
+ * @file sim_test.h
+ * @brief Verificações dos testes de host: imprimem cada item e contam as falhas
+ *
+ * Cada teste é um executável próprio (estado dos drivers zerado) registrado
+ * no ctest; o código de saída é 0 só quando todas as verificações passam.
+ */
+
+#ifndef SIM_TEST_H
+#define SIM_TEST_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+static int sim_test_failures = 0;
+
+static inline void sim_check(bool ok, const char *what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FALHOU");
+    if (!ok)
+        sim_test_failures++;
+}
+
+// Resumo e código de saída do teste
+static inline int sim_test_result(const char *name) {
+    printf("[%s] %s\n", name, sim_test_failures ? "FALHOU" : "OK");
+    return sim_test_failures ? 1 : 0;
+}
+
+#endif // SIM_TEST_H
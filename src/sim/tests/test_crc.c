@@ -0,0 +1,80 @@
+/**
+ * @file test_crc.c
+ * @brief CRCs por tabela (src/crc) contra as rotinas bit a bit originais
+ *
+ * Compilado duas vezes, com CRC_NIBBLE_TABLES = 0 e = 1. O CRC-8 é comparado
+ * em todas as entradas de 1 e 2 bytes (as respostas do SHT4x são palavras de
+ * 2 bytes) e em buffers aleatórios; o CRC-4 em PROMs aleatórias e variando
+ * cada palavra por todos os 65536 valores. Também confere que a PROM não é
+ * alterada.
+ */
+
+#include <string.h>
+#include "crc.h"
+#include "crc_reference.h"
+#include "sim_test.h"
+
+#define RANDOM_BUFFERS 100000
+#define RANDOM_PROMS   200000
+
+int main(void) {
+    uint32_t seed = 0x2545F491u;
+
+    printf("[crc] CRC-8 Sensirion (tabelas de %d entradas)\n", CRC_NIBBLE_TABLES ? 16 : 256);
+    const uint8_t example[2] = {0xBE, 0xEF};
+    sim_check(crc8_sensirion(example, 2) == 0x92, "exemplo do datasheet: 0xBEEF -> 0x92");
+    sim_check(crc8_sensirion(example, 0) == CRC8_SENSIRION_INIT, "buffer vazio = valor inicial");
+
+    uint32_t mismatches = 0;
+    for (uint32_t v = 0; v < 0x10000; v++) {
+        uint8_t data[2] = {(uint8_t)(v >> 8), (uint8_t)v};
+        mismatches += crc8_sensirion(data, 1) != reference_crc8(data, 1);
+        mismatches += crc8_sensirion(data, 2) != reference_crc8(data, 2);
+    }
+    sim_check(mismatches == 0, "todas as entradas de 1 e 2 bytes");
+
+    mismatches = 0;
+    for (uint32_t n = 0; n < RANDOM_BUFFERS; n++) {
+        uint8_t data[64];
+        size_t len = crc_test_random(&seed) % (sizeof(data) + 1);
+        for (size_t i = 0; i < len; i++)
+            data[i] = (uint8_t)crc_test_random(&seed);
+        mismatches += crc8_sensirion(data, len) != reference_crc8(data, len);
+    }
+    sim_check(mismatches == 0, "100000 buffers aleatórios de 0 a 64 bytes");
+
+    printf("[crc] CRC-4 da PROM do MS5637\n");
+    // Coeficientes do exemplo do datasheet, com o CRC gravado no nibble alto
+    uint16_t prom[8] = {0x00B0, 46372, 43981, 29059, 27842, 31553, 28165, 0};
+    prom[0] |= (uint16_t)reference_crc4(prom) << 12;
+    uint16_t copy[8];
+    memcpy(copy, prom, sizeof(prom));
+    sim_check(crc4_ms5637(prom) == (prom[0] >> 12), "PROM do exemplo confere");
+    sim_check(memcmp(copy, prom, sizeof(prom)) == 0, "PROM não é alterada");
+    prom[7] = 0xFFFF;
+    sim_check(crc4_ms5637(prom) == (prom[0] >> 12), "PROM[7] fica fora do cálculo");
+
+    mismatches = 0;
+    uint32_t mutated = 0;
+    for (uint32_t n = 0; n < RANDOM_PROMS; n++) {
+        for (int i = 0; i < 8; i++)
+            prom[i] = (uint16_t)crc_test_random(&seed);
+        memcpy(copy, prom, sizeof(prom));
+        mismatches += crc4_ms5637(prom) != reference_crc4(prom);
+        mutated += memcmp(copy, prom, sizeof(prom)) != 0;
+    }
+    sim_check(mismatches == 0 && mutated == 0, "200000 PROMs aleatórias, sem alteração");
+
+    mismatches = 0;
+    for (int word = 0; word < 8; word++) {
+        for (int i = 0; i < 8; i++)
+            prom[i] = (uint16_t)crc_test_random(&seed);
+        for (uint32_t v = 0; v < 0x10000; v++) {
+            prom[word] = (uint16_t)v;
+            mismatches += crc4_ms5637(prom) != reference_crc4(prom);
+        }
+    }
+    sim_check(mismatches == 0, "cada palavra por todos os 65536 valores");
+
+    return sim_test_result(CRC_NIBBLE_TABLES ? "crc nibble" : "crc");
+}
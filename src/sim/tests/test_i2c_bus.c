@@ -0,0 +1,279 @@
+/**
+ * @file test_i2c_bus.c
+ * @brief Contrato de i2c_bus.h: prioridades, palavras, NACK, prazo e recuperação
+ *
+ * Roda contra sim_i2c_bus.c, que usa a fila, a montagem das palavras de
+ * IC_DATA_CMD e a condição de fim de sequência do motor real
+ * (i2c_bus_core.c). Confere a ordem de saída por prioridade (e por envio
+ * dentro de uma prioridade), os bits de STOP/RESTART e o limite de leituras
+ * na FIFO, o fim de uma sequência por DMA com a IRQ atrasada, a contagem de
+ * abortos, que um SDA preso custa no máximo um prazo por transação e que o
+ * barramento volta a funcionar depois da liberação.
+ */
+
+#include "sim.h"
+#include "sim_test.h"
+#include "i2c_bus.h"
+#include "i2c_bus_core.h"
+#include "pico/stdlib.h"
+
+#define DUMMY_ADDR 0x50
+
+#define CMD     I2C_IC_DATA_CMD_CMD_BITS
+#define STOP    I2C_IC_DATA_CMD_STOP_BITS
+#define RESTART I2C_IC_DATA_CMD_RESTART_BITS
+
+// Dispositivo de teste: aceita tudo e devolve o primeiro byte escrito,
+// incrementado a cada byte lido. Conta as fases recebidas
+static uint8_t dummy_last = 0;
+static uint32_t dummy_writes = 0, dummy_reads = 0;
+static size_t dummy_write_len = 0, dummy_read_len = 0;
+static uint8_t dummy_write_tail = 0; // último byte da última escrita
+
+static bool dummy_write(const uint8_t *data, size_t len) {
+    if (len)
+        dummy_last = data[0];
+    dummy_writes++;
+    dummy_write_len = len;
+    dummy_write_tail = len ? data[len - 1] : 0;
+    return true;
+}
+
+static bool dummy_read(uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++)
+        data[i] = (uint8_t)(dummy_last + i);
+    dummy_reads++;
+    dummy_read_len = len;
+    return true;
+}
+
+static const sim_i2c_model_t dummy_model = {dummy_write, dummy_read};
+static const i2c_bus_device_t dummy = I2C_BUS_DEVICE(DUMMY_ADDR, I2C_BUS_FAST_HZ);
+static const i2c_bus_device_t absent = I2C_BUS_DEVICE(0x51, I2C_BUS_FAST_HZ);
+
+// Ordem em que as transações terminaram (o byte escrito identifica cada uma)
+static uint8_t order[8];
+static int order_len = 0;
+
+static void record_done(i2c_txn_t *txn, bool ok) {
+    if (ok && order_len < (int)sizeof(order))
+        order[order_len++] = txn->tx[0];
+}
+
+static const uint8_t ids[5] = {'A', 'b', 'h', 'n', 'H'};
+static i2c_txn_t queued[4];
+
+// Callback da primeira transação: com o barramento ocupado, enfileira as
+// demais fora de ordem de prioridade
+static void first_done(i2c_txn_t *txn, bool ok) {
+    record_done(txn, ok);
+    static const i2c_bus_prio_t prios[4] = {
+        I2C_BUS_PRIO_BULK, I2C_BUS_PRIO_HIGH, I2C_BUS_PRIO_NORMAL, I2C_BUS_PRIO_HIGH,
+    };
+    for (int i = 0; i < 4; i++) {
+        queued[i] = (i2c_txn_t){
+            .dev = &dummy, .tx = &ids[1 + i], .tx_len = 1,
+            .prio = prios[i], .callback = record_done,
+        };
+        i2c_bus_submit(&queued[i]);
+    }
+}
+
+// Palavras que o motor põe na FIFO para a transação; com `drain` a FIFO de RX
+// é esvaziada sempre que a montagem para por ela
+static int build_words(const i2c_txn_t *txn, uint16_t *words, int max, bool drain) {
+    i2c_bus_cursor_t cur = {0};
+    int n = 0;
+    while (n < max) {
+        if (!i2c_bus_next_word(&cur, txn, &words[n])) {
+            if (!drain || !i2c_bus_words_pending(&cur, txn))
+                break;
+            cur.rx_pos = cur.rd_cmds;
+            continue;
+        }
+        n++;
+    }
+    return n;
+}
+
+static bool words_are(const uint16_t *words, int n, const uint16_t *expect, int expect_n) {
+    if (n != expect_n)
+        return false;
+    for (int i = 0; i < n; i++)
+        if (words[i] != expect[i])
+            return false;
+    return true;
+}
+
+int main(void) {
+    uint8_t byte = 0x5A, rx = 0;
+    i2c_bus_stats_t stats;
+
+    sim_i2c_attach(DUMMY_ADDR, &dummy_model);
+    i2c_bus_init();
+
+    printf("[i2c_bus] Transações síncronas\n");
+    sim_check(i2c_bus_write(&dummy, &byte, 1) == 1, "escrita devolve os bytes");
+    sim_check(i2c_bus_write_read(&dummy, &byte, 1, &rx, 1) == 1 && rx == 0x5A, "escrita + leitura");
+    sim_check(i2c_bus_clock_hz() == I2C_BUS_FAST_HZ, "clock do dispositivo");
+
+    i2c_txn_t empty = {.dev = &dummy, .prio = I2C_BUS_PRIO_NORMAL};
+    sim_check(!i2c_bus_submit(&empty), "transação vazia recusada");
+
+    printf("[i2c_bus] Prioridades\n");
+    i2c_txn_t first = {
+        .dev = &dummy, .tx = &ids[0], .tx_len = 1,
+        .prio = I2C_BUS_PRIO_NORMAL, .callback = first_done,
+    };
+    sim_check(i2c_bus_submit(&first), "i2c_bus_submit");
+    sim_check(order_len == 5 && order[0] == 'A' && order[1] == 'h' && order[2] == 'H' &&
+              order[3] == 'n' && order[4] == 'b',
+              "HIGH na ordem de envio, depois NORMAL e BULK");
+    sim_check(!i2c_bus_busy(), "fila vazia ao fim");
+
+    printf("[i2c_bus] Palavras de IC_DATA_CMD\n");
+    static const uint8_t reg3[3] = {0x11, 0x22, 0x33};
+    uint16_t words[48];
+    uint8_t rx_buf[40];
+    int n;
+    i2c_txn_t wr = {.dev = &dummy, .tx = reg3, .tx_len = 3};
+    n = build_words(&wr, words, 48, false);
+    sim_check(words_are(words, n, (const uint16_t[]){0x11, 0x22, 0x33 | STOP}, 3),
+              "escrita: STOP no último byte");
+    i2c_txn_t wrr = {.dev = &dummy, .tx = reg3, .tx_len = 1, .rx = rx_buf, .rx_len = 2,
+                     .restart = true};
+    n = build_words(&wrr, words, 48, false);
+    sim_check(words_are(words, n, (const uint16_t[]){0x11, CMD | RESTART, CMD | STOP}, 3),
+              "escrita + leitura: RESTART, STOP no fim");
+    wrr.restart = false;
+    n = build_words(&wrr, words, 48, false);
+    sim_check(words_are(words, n, (const uint16_t[]){0x11 | STOP, CMD, CMD | STOP}, 3),
+              "sem repeated start: STOP + START");
+    i2c_txn_t rd = {.dev = &dummy, .rx = rx_buf, .rx_len = 1, .restart = true};
+    n = build_words(&rd, words, 48, false);
+    sim_check(words_are(words, n, (const uint16_t[]){CMD | STOP}, 1), "só leitura: sem RESTART");
+
+    rd.rx_len = 40;
+    n = build_words(&rd, words, 48, false);
+    sim_check(n == I2C_BUS_FIFO_DEPTH && words[n - 1] == CMD,
+              "leitura longa para com a FIFO de RX cheia");
+    n = build_words(&rd, words, 48, true);
+    sim_check(n == 40 && words[39] == (CMD | STOP), "esvaziando a FIFO, segue até o STOP");
+
+    uint32_t reads = dummy_reads;
+    byte = 0x30;
+    sim_check(i2c_bus_write_read(&dummy, &byte, 1, rx_buf, 40) == 40 && rx_buf[0] == 0x30 &&
+              rx_buf[39] == 0x30 + 39,
+              "leitura de 40 bytes pelo barramento");
+    sim_check(dummy_reads == reads + 1 && dummy_read_len == 40, "numa única fase de leitura");
+    byte = 0x5A;
+
+    printf("[i2c_bus] Fim de sequência por DMA\n");
+    sim_check(i2c_bus_words_done(false, 0, false), "DMA parado, FIFO vazia, mestre ocioso");
+    sim_check(!i2c_bus_words_done(false, 0, true), "último byte ainda saindo: continua");
+    sim_check(!i2c_bus_words_done(true, 0, false) && !i2c_bus_words_done(false, 2, false),
+              "DMA ou FIFO com palavras: continua");
+
+    // Última transação de um byte: no STOP anterior a FIFO já esvaziou
+    static const uint16_t short_tail[4] = {0x10, 0x11, 0x12 | STOP, 0x13 | STOP};
+    i2c_txn_t seq = {.dev = &dummy, .words = short_tail, .word_count = 4,
+                     .prio = I2C_BUS_PRIO_BULK};
+    uint32_t writes = dummy_writes;
+    i2c_bus_submit(&seq);
+    sim_check(seq.state == I2C_TXN_DONE && dummy_writes == writes + 2 &&
+              dummy_write_len == 1 && dummy_write_tail == 0x13,
+              "último byte entregue antes do fim");
+
+    static const uint16_t three[12] = {
+        0x20, 0x21, 0x22, 0x23 | STOP, 0x24, 0x25, 0x26, 0x27 | STOP,
+        0x28, 0x29, 0x2A, 0x2B | STOP,
+    };
+    seq = (i2c_txn_t){.dev = &dummy, .words = three, .word_count = 12,
+                      .prio = I2C_BUS_PRIO_BULK};
+    writes = dummy_writes;
+    sim_i2c_set_irq_latency(3); // STOP_DET do meio atendido no último byte
+    i2c_bus_submit(&seq);
+    sim_i2c_set_irq_latency(0);
+    sim_check(seq.state == I2C_TXN_DONE && dummy_writes == writes + 3 &&
+              dummy_write_len == 4 && dummy_write_tail == 0x2B,
+              "IRQ atrasada: as três transações saem inteiras");
+
+    printf("[i2c_bus] NACK\n");
+    i2c_bus_get_stats(&stats);
+    uint32_t aborts = stats.aborts;
+    sim_check(i2c_bus_write(&absent, &byte, 1) < 0, "endereço sem dispositivo: erro");
+    i2c_txn_t nacked = {.dev = &absent, .tx = &byte, .tx_len = 1, .prio = I2C_BUS_PRIO_NORMAL};
+    i2c_bus_submit(&nacked);
+    sim_check(nacked.state == I2C_TXN_FAILED, "descritor termina em FAILED");
+    i2c_bus_get_stats(&stats);
+    sim_check(stats.aborts == aborts + 2 && stats.timeouts == 0, "abortos contados, sem prazo vencido");
+
+    printf("[i2c_bus] SDA preso\n");
+    // Limites tirados do tempo nominal de fio (START, endereço, 16 bytes com
+    // ACK e STOP a 400 kHz), não da fórmula do motor: o prazo não pode cortar
+    // uma transação sã que ainda está no fio, nem passar do triplo dela mais a
+    // folga do dispositivo. A liberação são 9 pulsos, o STOP e as esperas de
+    // meio período: no máximo 12 períodos de SCL a 100 kHz
+    uint8_t block[16] = {0};
+    uint32_t nominal_us = ((1u + 17u * 9u + 1u) * 1000000u + I2C_BUS_FAST_HZ - 1) / I2C_BUS_FAST_HZ;
+    uint64_t low = dummy.timeout_us + nominal_us;
+    uint64_t high = dummy.timeout_us + 3u * nominal_us;
+    uint64_t clear_max = 12u * 1000000u / I2C_BUS_STANDARD_HZ;
+
+    i2c_bus_get_stats(&stats);
+    uint32_t timeouts = stats.timeouts, recoveries = stats.recoveries;
+    sim_i2c_set_stuck(true);
+    uint64_t start = sim_time_us();
+    sim_check(i2c_bus_write(&dummy, block, sizeof(block)) < 0, "transação falha");
+    uint64_t cost = sim_time_us() - start;
+    printf("  prazo %llu us (entre %llu e %llu us)\n", (unsigned long long)cost,
+           (unsigned long long)low, (unsigned long long)high);
+    sim_check(cost >= low && cost <= high, "prazo entre o fio nominal e o limite");
+    sim_check(i2c_bus_service_pending(), "liberação pendente");
+    i2c_bus_get_stats(&stats);
+    sim_check(stats.timeouts == timeouts + 1 && stats.recoveries == recoveries,
+              "prazo contado, liberação ainda não");
+
+    uint32_t pulses = sim_i2c_scl_pulses();
+    start = sim_time_us();
+    sim_check(i2c_bus_write(&dummy, block, sizeof(block)) < 0, "acesso seguinte também falha");
+    cost = sim_time_us() - start;
+    printf("  liberação + prazo %llu us (limite %llu us)\n", (unsigned long long)cost,
+           (unsigned long long)(high + clear_max));
+    sim_check(cost <= high + clear_max, "uma liberação e um prazo por acesso");
+    sim_check(sim_i2c_scl_pulses() - pulses == 10, "9 pulsos e o STOP com o SDA preso");
+    i2c_bus_get_stats(&stats);
+    sim_check(stats.timeouts == timeouts + 2 && stats.recoveries == recoveries + 1,
+              "prazos e liberações contados");
+
+    printf("[i2c_bus] Recuperação pendente\n");
+    sim_i2c_set_stuck_clocks(3); // solta o SDA no terceiro pulso
+    i2c_bus_service();
+    sim_check(!i2c_bus_service_pending() && gpio_get(I2C_BUS_SDA), "liberação solta o SDA");
+    i2c_txn_t stuck_txn = {.dev = &dummy, .tx = block, .tx_len = 16, .prio = I2C_BUS_PRIO_NORMAL};
+    i2c_txn_t waiting = {.dev = &dummy, .tx = &byte, .tx_len = 1, .prio = I2C_BUS_PRIO_NORMAL};
+    sim_i2c_set_stuck_clocks(3);
+    i2c_bus_submit(&stuck_txn);
+    sim_check(stuck_txn.state == I2C_TXN_FAILED && i2c_bus_service_pending(),
+              "prazo vencido: falha e liberação pendente");
+    i2c_bus_submit(&waiting);
+    sim_check(waiting.state == I2C_TXN_QUEUED && i2c_bus_busy(), "fila parada até o service");
+    pulses = sim_i2c_scl_pulses();
+    start = sim_time_us();
+    i2c_bus_service();
+    cost = sim_time_us() - start;
+    sim_check(sim_i2c_scl_pulses() - pulses == 4, "para no terceiro pulso, depois o STOP");
+    sim_check(waiting.state == I2C_TXN_DONE && !i2c_bus_busy(), "service retoma a fila");
+    sim_check(cost <= clear_max + nominal_us, "liberação curta e a transação seguinte");
+    i2c_bus_get_stats(&stats);
+    sim_check(stats.recoveries == recoveries + 3, "liberações contadas");
+
+    sim_i2c_set_stuck(false);
+    i2c_bus_service();
+    sim_check(!i2c_bus_service_pending(), "nenhuma recuperação pendente");
+    sim_check(i2c_bus_write_read(&dummy, &byte, 1, &rx, 1) == 1 && rx == 0x5A, "barramento volta");
+    i2c_bus_get_stats(&stats);
+    sim_check(stats.timeouts == timeouts + 3, "sem novos prazos vencidos");
+
+    return sim_test_result("i2c_bus");
+}
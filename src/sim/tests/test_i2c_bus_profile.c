@@ -0,0 +1,150 @@
+/**
+ * @file test_i2c_bus_profile.c
+ * @brief Perfil de tráfego por endereço (i2c_bus_profile.c)
+ *
+ * Gera tráfego conhecido pelo barramento simulado, que chama
+ * i2c_bus_profile_record() como o motor real, e confere o que
+ * i2c_bus_profile_snapshot() devolve: transações, bytes escritos e lidos e
+ * erros por endereço, o tempo de barramento (igual ao cobrado pela
+ * simulação), a ordem das entradas e a entrada 0xFF que soma os endereços
+ * além de I2C_BUS_PROFILE_SLOTS - 1.
+ */
+
+#include "sim.h"
+#include "sim_test.h"
+#include "i2c_bus.h"
+#include "i2c_bus_core.h"
+#include "i2c_bus_profile.h"
+
+#define FIRST_ADDR 0x50
+#define OTHER_ADDR 0xFF
+#define DEVICES 10 // mais endereços que vagas na tabela
+
+// Dispositivo de teste: aceita tudo e devolve zeros
+static bool echo_write(const uint8_t *data, size_t len) {
+    (void)data; (void)len;
+    return true;
+}
+
+static bool echo_read(uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++)
+        data[i] = 0;
+    return true;
+}
+
+static const sim_i2c_model_t echo_model = {echo_write, echo_read};
+static i2c_bus_device_t devs[DEVICES];
+
+static const i2c_bus_profile_entry_t *find(const i2c_bus_profile_entry_t *e, size_t n,
+                                           uint8_t address) {
+    for (size_t i = 0; i < n; i++)
+        if (e[i].address == address)
+            return &e[i];
+    return NULL;
+}
+
+static bool entry_is(const i2c_bus_profile_entry_t *e, uint32_t transactions, uint32_t errors,
+                     uint32_t bytes_tx, uint32_t bytes_rx) {
+    return e && e->transactions == transactions && e->errors == errors &&
+           e->bytes_tx == bytes_tx && e->bytes_rx == bytes_rx;
+}
+
+// Tempo de barramento que a simulação cobrou do endereço
+static uint64_t sim_busy_us(uint8_t address) {
+    sim_i2c_counters_t c;
+    sim_i2c_counters(address, &c);
+    return c.bus_time_us;
+}
+
+int main(void) {
+    for (int i = 0; i < DEVICES; i++) {
+        i2c_bus_device_init(&devs[i], (uint8_t)(FIRST_ADDR + i), I2C_BUS_FAST_HZ);
+        if (i != 1) // 0x51 fica sem dispositivo: NACK
+            sim_i2c_attach((uint8_t)(FIRST_ADDR + i), &echo_model);
+    }
+    i2c_bus_init();
+    i2c_bus_profile_reset();
+    sim_i2c_clear_counters();
+    uint64_t start_us = sim_time_us();
+
+    printf("[perfil] Contadores por endereço\n");
+    uint8_t tx[4] = {1, 2, 3, 4}, rx[8];
+    for (int i = 0; i < 3; i++)
+        i2c_bus_write(&devs[0], tx, 2);
+    for (int i = 0; i < 2; i++)
+        i2c_bus_write_read(&devs[0], tx, 1, rx, 4);
+    i2c_bus_read(&devs[0], rx, 8);
+    i2c_bus_write(&devs[1], tx, 3);
+    i2c_bus_read(&devs[1], rx, 2);
+
+    // Sequência de IC_DATA_CMD: uma palavra por byte escrito
+    static const uint16_t seq[6] = {
+        0x10, 0x11, 0x12 | I2C_IC_DATA_CMD_STOP_BITS, 0x20, 0x21, 0x22 | I2C_IC_DATA_CMD_STOP_BITS,
+    };
+    i2c_txn_t words = {.dev = &devs[2], .words = seq, .word_count = 6};
+    i2c_bus_transfer(&words);
+
+    // SDA preso: a transação vence o prazo e conta como erro
+    sim_i2c_set_stuck(true);
+    i2c_bus_write(&devs[3], tx, 4);
+    sim_i2c_set_stuck(false);
+    i2c_bus_service();
+    i2c_bus_write(&devs[3], tx, 4);
+
+    i2c_bus_profile_entry_t snap[I2C_BUS_PROFILE_SLOTS];
+    uint64_t window_us = 0;
+    size_t n = i2c_bus_profile_snapshot(snap, I2C_BUS_PROFILE_SLOTS, &window_us);
+    sim_check(n == 4, "4 endereços com tráfego");
+    sim_check(n == 4 && snap[0].address == 0x50 && snap[1].address == 0x51 &&
+              snap[2].address == 0x52 && snap[3].address == 0x53,
+              "ordem da primeira transação");
+    sim_check(entry_is(find(snap, n, 0x50), 6, 0, 3 * 2 + 2 * 1, 2 * 4 + 8),
+              "0x50: 6 transações, 8 escritos, 16 lidos");
+    sim_check(entry_is(find(snap, n, 0x51), 2, 2, 0, 0), "0x51 ausente: 2 erros, sem bytes");
+    sim_check(entry_is(find(snap, n, 0x52), 1, 0, 6, 0), "0x52: sequência conta palavras");
+    sim_check(entry_is(find(snap, n, 0x53), 2, 1, 4, 0), "0x53: prazo vencido é erro");
+
+    bool busy_match = true;
+    for (size_t i = 0; i < n; i++)
+        busy_match = busy_match && snap[i].busy_us == sim_busy_us(snap[i].address);
+    sim_check(busy_match, "ocupação igual ao tempo cobrado pela simulação");
+    const i2c_bus_profile_entry_t *stuck = find(snap, n, 0x53);
+    i2c_txn_t probe = {.dev = &devs[3], .tx = tx, .tx_len = 4};
+    sim_check(stuck && stuck->max_us == i2c_bus_txn_budget_us(&probe, I2C_BUS_FAST_HZ),
+              "0x53: transação mais longa = prazo");
+    sim_check(window_us == sim_time_us() - start_us, "janela desde o reset");
+
+    printf("[perfil] Endereços excedentes\n");
+    // 0x54-0x56 completam as vagas; 0x57-0x59 somam na entrada 0xFF
+    for (int i = 4; i < DEVICES; i++)
+        i2c_bus_write_read(&devs[i], tx, (uint16_t)(i - 3), rx, 1);
+    n = i2c_bus_profile_snapshot(snap, I2C_BUS_PROFILE_SLOTS, NULL);
+    sim_check(n == I2C_BUS_PROFILE_SLOTS, "tabela cheia, sem passar das vagas");
+    sim_check(snap[I2C_BUS_PROFILE_SLOTS - 1].address == OTHER_ADDR, "última vaga é a 0xFF");
+    sim_check(find(snap, n, 0x56) && !find(snap, n, 0x57) && !find(snap, n, 0x59),
+              "endereços excedentes sem entrada própria");
+    sim_check(entry_is(find(snap, n, OTHER_ADDR), 3, 0, 4 + 5 + 6, 3),
+              "0xFF soma 0x57-0x59");
+    sim_check(find(snap, n, OTHER_ADDR)->busy_us ==
+              sim_busy_us(0x57) + sim_busy_us(0x58) + sim_busy_us(0x59),
+              "0xFF: ocupação somada");
+    i2c_bus_write(&devs[1], tx, 1);
+    n = i2c_bus_profile_snapshot(snap, I2C_BUS_PROFILE_SLOTS, NULL);
+    sim_check(entry_is(find(snap, n, 0x51), 3, 3, 0, 0) &&
+              entry_is(find(snap, n, OTHER_ADDR), 3, 0, 15, 3),
+              "endereço conhecido segue na sua entrada");
+
+    printf("[perfil] Cópia e reset\n");
+    n = i2c_bus_profile_snapshot(snap, 2, NULL);
+    sim_check(n == 2 && snap[0].address == 0x50 && snap[1].address == 0x51,
+              "cópia limitada à capacidade");
+    i2c_bus_profile_reset();
+    n = i2c_bus_profile_snapshot(snap, I2C_BUS_PROFILE_SLOTS, &window_us);
+    sim_check(n == 0 && window_us == 0, "reset zera a tabela e a janela");
+    i2c_bus_write(&devs[9], tx, 1);
+    n = i2c_bus_profile_snapshot(snap, I2C_BUS_PROFILE_SLOTS, NULL);
+    sim_check(n == 1 && snap[0].address == 0x59 && entry_is(&snap[0], 1, 0, 1, 0),
+              "após o reset, endereço ganha entrada própria");
+
+    return sim_test_result("perfil");
+}
@@ -0,0 +1,233 @@
+/**
+ * @file test_ms5637.c
+ * @brief Conversões do MS5637 e verificação da PROM pelo CRC-4
+ *
+ * O modelo devolve valores D1/D2 escolhidos pelo teste: a leitura pelo
+ * barramento tem de coincidir com ms5637_compensate() sobre os mesmos valores
+ * (ADC de 24 bits montado corretamente) e esperar o tempo de conversão do OSR.
+ * A medição sem bloquear (a usada pelo laço principal) responde BUSY até cada
+ * prazo de conversão sem tocar no barramento. O modo adaptativo recebe
+ * pressões alternando entre dois valores (diferença entre vizinhas constante,
+ * então a estimativa de ruído do driver é exata) e tem de subir, descer ou
+ * ficar na resolução prevista, sem passar do limite do período de
+ * amostragem. No modo só-pressão, as conversões contadas pelo modelo mostram
+ * quando D2 é refeito (a cada N medições ou max_age_ms de tempo virtual) e o
+ * resultado com a compensação em cache tem de ser o de ms5637_compensate()
+ * com o último D2 medido. Uma PROM corrompida faz as medições falharem com
+ * CRC_ERROR até ser lida íntegra de novo.
+ */
+
+#include "sim.h"
+#include "sim_test.h"
+#include "ms5637.h"
+
+// Valores brutos do exemplo do datasheet (20,00 °C e 1100,02 mbar)
+#define EXAMPLE_D1 6465444
+#define EXAMPLE_D2 8077636
+
+// Lê pelo barramento e compara com a compensação direta dos valores brutos
+static bool read_matches(uint32_t d1, uint32_t d2) {
+    int32_t t = 0, p = 0, t_ref, p_ref;
+    sim_ms5637_set_raw(d1, d2);
+    if (ms5637_read_temperature_pressure_centi(&t, &p) != MS5637_STATUS_OK)
+        return false;
+    ms5637_compensate(d1, d2, &t_ref, &p_ref);
+    return t == t_ref && p == p_ref;
+}
+
+// Menor D1 cuja pressão fica `step_pa` acima da de EXAMPLE_D1
+static uint32_t d1_plus_pa(int32_t step_pa) {
+    int32_t t, p0, p;
+    uint32_t d1 = EXAMPLE_D1;
+    ms5637_compensate(d1, EXAMPLE_D2, &t, &p0);
+    for (p = p0; p - p0 < step_pa;)
+        ms5637_compensate(++d1, EXAMPLE_D2, &t, &p);
+    return d1;
+}
+
+static ms5637_osr_t osr_max_seen;
+
+// Lê `n` amostras com a pressão alternando entre dois valores `step_pa`
+// distantes; devolve a resolução D1 ao fim
+static ms5637_osr_t run_noise(int32_t step_pa, int n) {
+    uint32_t high = d1_plus_pa(step_pa);
+    int32_t t, p;
+    osr_max_seen = ms5637_get_osr(MS5637_CONV_PRESSURE);
+    for (int i = 0; i < n; i++) {
+        sim_ms5637_set_raw((i & 1) ? high : EXAMPLE_D1, EXAMPLE_D2);
+        ms5637_read_temperature_pressure_centi(&t, &p);
+        if (ms5637_get_osr(MS5637_CONV_PRESSURE) > osr_max_seen)
+            osr_max_seen = ms5637_get_osr(MS5637_CONV_PRESSURE);
+    }
+    return ms5637_get_osr(MS5637_CONV_PRESSURE);
+}
+
+static uint32_t ms5637_transactions(void) {
+    sim_i2c_counters_t c;
+    sim_i2c_counters(MS5637_ADDR, &c);
+    return c.transactions;
+}
+
+// Tempo virtual de uma leitura completa (D2 + D1), em µs
+static uint64_t read_time_us(void) {
+    int32_t t, p;
+    uint64_t start = sim_time_us();
+    ms5637_read_temperature_pressure_centi(&t, &p);
+    return sim_time_us() - start;
+}
+
+int main(void) {
+    int32_t t = 0, p = 0;
+    sim_ms5637_attach();
+
+    printf("[ms5637] Conversões\n");
+    ms5637_init();
+    sim_check(ms5637_read_temperature_pressure_centi(&t, &p) == MS5637_STATUS_OK &&
+              t == 2000 && p == 110002,
+              "exemplo do datasheet: 20,00 C e 1100,02 mbar");
+    sim_check(read_matches(EXAMPLE_D1, EXAMPLE_D2), "D1/D2 do datasheet = ms5637_compensate");
+    sim_check(read_matches(5000000, 7000000), "abaixo de 20 C (segunda ordem)");
+    sim_check(read_matches(4000000, 5500000), "abaixo de -15 C");
+    sim_check(read_matches(0xFFFFFF, 0xC00000), "ADC no máximo (24 bits)");
+
+    int32_t p_low, p_high;
+    sim_ms5637_set_raw(6000000, EXAMPLE_D2);
+    ms5637_read_temperature_pressure_centi(&t, &p_low);
+    sim_ms5637_set_raw(7000000, EXAMPLE_D2);
+    ms5637_read_temperature_pressure_centi(&t, &p_high);
+    sim_check(p_high > p_low, "pressão cresce com D1");
+
+    printf("[ms5637] Tempo de conversão\n");
+    sim_ms5637_set_raw(EXAMPLE_D1, EXAMPLE_D2);
+    ms5637_set_osr(MS5637_OSR_8192);
+    uint64_t slow = read_time_us();
+    ms5637_set_osr(MS5637_OSR_256);
+    uint64_t fast = read_time_us();
+    printf("  OSR 8192: %llu us, OSR 256: %llu us\n", (unsigned long long)slow,
+           (unsigned long long)fast);
+    sim_check(slow >= 2 * 16440, "OSR 8192 espera as duas conversões");
+    sim_check(fast >= 2 * 540 && fast < 5000, "OSR 256 abaixo de 5 ms");
+    sim_check(ms5637_read_temperature_pressure_centi(&t, &p) == MS5637_STATUS_OK && p == 110002,
+              "OSR 256 lê o resultado completo");
+    ms5637_set_osr(MS5637_OSR_8192);
+
+    printf("[ms5637] Medição sem bloquear\n");
+    sim_ms5637_set_raw(EXAMPLE_D1, EXAMPLE_D2);
+    uint32_t conv_us = ms5637_get_conversion_time_ms(MS5637_OSR_8192) * 1000u;
+    uint32_t txns = ms5637_transactions();
+    sim_check(ms5637_measure_start() == MS5637_STATUS_OK && ms5637_transactions() == txns + 1,
+              "início: só o comando de D2");
+    txns = ms5637_transactions();
+    bool busy = true;
+    for (int i = 0; i < 4; i++) {
+        busy = busy && ms5637_measure_poll(&t, &p) == MS5637_STATUS_BUSY;
+        sim_time_advance_us(conv_us / 4 - 10);
+    }
+    sim_check(busy && !ms5637_conversion_ready(), "BUSY antes do prazo de D2");
+    sim_check(ms5637_transactions() == txns, "consultas sem tráfego no barramento");
+    sim_time_advance_us(40);
+    sim_check(ms5637_measure_poll(&t, &p) == MS5637_STATUS_BUSY, "D2 lido, D1 iniciado: BUSY");
+    txns = ms5637_transactions();
+    sim_time_advance_us(conv_us - 10);
+    sim_check(ms5637_measure_poll(&t, &p) == MS5637_STATUS_BUSY &&
+              ms5637_transactions() == txns,
+              "BUSY antes do prazo de D1, sem tráfego");
+    sim_time_advance_us(10);
+    sim_check(ms5637_measure_poll(&t, &p) == MS5637_STATUS_OK && t == 2000 && p == 110002,
+              "resultado no prazo de D1");
+    sim_check(ms5637_measure_poll(&t, &p) == MS5637_STATUS_ERROR, "sem medição iniciada: ERROR");
+
+    printf("[ms5637] OSR adaptativo\n");
+    // D2 em OSR 8192 (17 ms) num período de 30 ms: D1 cabe até OSR 4096 (9 ms)
+    ms5637_set_osr(MS5637_OSR_8192);
+    sim_check(ms5637_set_adaptive_osr(1, 30) == MS5637_STATUS_OK &&
+              ms5637_get_osr(MS5637_CONV_PRESSURE) == MS5637_OSR_4096,
+              "resolução limitada pelo período");
+    sim_check(ms5637_set_adaptive_osr(0, 30) == MS5637_STATUS_ERROR, "ruído alvo zero recusado");
+
+    ms5637_set_osr_split(MS5637_OSR_256, MS5637_OSR_8192);
+    ms5637_set_adaptive_osr(1, 30);
+    sim_check(run_noise(40, 15) == MS5637_OSR_256, "decide só depois de 16 amostras");
+    sim_check(run_noise(40, 100) == MS5637_OSR_4096 && osr_max_seen == MS5637_OSR_4096,
+              "ruído alto: sobe até o limite e para");
+    sim_check(run_noise(0, 200) == MS5637_OSR_256, "sem ruído: desce até OSR 256");
+
+    // Alvo de 10 Pa (100 Pa²). Degraus de 10 Pa: 50 Pa² em OSR 2048, previstos
+    // 97 Pa² em OSR 1024, entre 80% e 100% do alvo. Degraus de 8 Pa: 32 Pa²,
+    // previstos 62 Pa² em 1024 e 80 Pa² em 512
+    ms5637_set_osr_split(MS5637_OSR_2048, MS5637_OSR_8192);
+    ms5637_set_adaptive_osr(10, 30);
+    sim_check(run_noise(10, 100) == MS5637_OSR_2048 && osr_max_seen == MS5637_OSR_2048,
+              "previsão acima de 80% do alvo: mantém");
+    sim_check(run_noise(8, 100) == MS5637_OSR_1024, "abaixo de 80%: desce uma só");
+    ms5637_disable_adaptive_osr();
+    sim_check(run_noise(40, 100) == MS5637_OSR_1024, "desligado: resolução fixa");
+    ms5637_set_osr(MS5637_OSR_8192);
+    sim_ms5637_set_raw(EXAMPLE_D1, EXAMPLE_D2);
+
+    printf("[ms5637] Cache de temperatura\n");
+    int32_t t_ref, p_ref;
+    ms5637_set_temperature_cache(4, 0);
+    ms5637_invalidate_temperature_cache();
+    uint32_t d1_start = sim_ms5637_conversions(false), d2_start = sim_ms5637_conversions(true);
+    for (int i = 0; i < 9; i++)
+        ms5637_read_temperature_pressure_centi(&t, &p);
+    sim_check(sim_ms5637_conversions(true) - d2_start == 3 &&
+              sim_ms5637_conversions(false) - d1_start == 9,
+              "N = 4: D2 na 1ª, 5ª e 9ª de 9 medições");
+
+    // A temperatura muda no chip, mas só a próxima D2 a enxerga
+    sim_ms5637_set_raw(6000000, 7000000);
+    uint32_t d2 = sim_ms5637_conversions(true);
+    bool cached = true;
+    for (int i = 0; i < 3; i++) {
+        ms5637_read_temperature_pressure_centi(&t, &p);
+        ms5637_compensate(6000000, EXAMPLE_D2, &t_ref, &p_ref);
+        cached = cached && t == t_ref && p == p_ref;
+    }
+    sim_check(cached && sim_ms5637_conversions(true) == d2,
+              "N-1 medições só D1 = ms5637_compensate(D2 antigo)");
+    ms5637_read_temperature_pressure_centi(&t, &p);
+    ms5637_compensate(6000000, 7000000, &t_ref, &p_ref);
+    sim_check(sim_ms5637_conversions(true) == d2 + 1 && t == t_ref && p == p_ref,
+              "N-ésima medição refaz D2");
+
+    // Cada leitura em OSR 8192 leva ~34 ms; D2 sai ~17 ms depois do início
+    ms5637_set_temperature_cache(100, 100);
+    ms5637_invalidate_temperature_cache();
+    ms5637_read_temperature_pressure_centi(&t, &p);
+    d2 = sim_ms5637_conversions(true);
+    sim_time_advance_us(40000);
+    ms5637_read_temperature_pressure_centi(&t, &p);
+    sim_check(sim_ms5637_conversions(true) == d2, "cache com ~60 ms: só D1");
+    sim_time_advance_us(30000);
+    ms5637_read_temperature_pressure_centi(&t, &p);
+    sim_check(sim_ms5637_conversions(true) == d2 + 1, "passado max_age_ms: D2 refeito");
+
+    ms5637_set_temperature_cache(0, 0);
+    d2 = sim_ms5637_conversions(true);
+    for (int i = 0; i < 3; i++)
+        ms5637_read_temperature_pressure_centi(&t, &p);
+    sim_check(sim_ms5637_conversions(true) == d2 + 3, "N = 0: D2 em toda medição");
+    sim_ms5637_set_raw(EXAMPLE_D1, EXAMPLE_D2);
+
+    printf("[ms5637] CRC-4 da PROM\n");
+    sim_ms5637_corrupt_prom(true);
+    ms5637_init();
+    sim_check(ms5637_read_temperature_pressure_centi(&t, &p) == MS5637_STATUS_CRC_ERROR,
+              "PROM corrompida: CRC_ERROR");
+    sim_check(ms5637_measure_start() == MS5637_STATUS_CRC_ERROR, "medição não inicia");
+    sim_ms5637_corrupt_prom(false);
+    sim_check(ms5637_read_temperature_pressure_centi(&t, &p) == MS5637_STATUS_OK && p == 110002,
+              "PROM íntegra relida na medição seguinte");
+
+    printf("[ms5637] Falha de barramento\n");
+    sim_i2c_set_stuck(true);
+    sim_check(ms5637_read_temperature_pressure_centi(&t, &p) == MS5637_STATUS_ERROR,
+              "SDA preso: ERROR");
+    sim_i2c_set_stuck(false);
+    sim_check(ms5637_read_temperature_pressure_centi(&t, &p) == MS5637_STATUS_OK,
+              "leitura volta");
+
+    return sim_test_result("ms5637");
+}
@@ -0,0 +1,131 @@
+/**
+ * @file test_ms5637_filter.c
+ * @brief Média móvel exponencial e Kalman de altitude (ms5637_filter.c)
+ *
+ * Não usa o barramento: as amostras são sintéticas. A média móvel tem de
+ * seguir a resposta ao degrau de um IIR de 1ª ordem (1 - (1 - 2^-shift)^k) e
+ * assentar exatamente no valor de entrada. O Kalman tem de usar os ganhos de
+ * regime permanente de Kalata (conferidos contra a fórmula em ponto
+ * flutuante), assentar num degrau de altitude, seguir uma subida constante
+ * sem atraso e, com a entrada parada, levar a velocidade a zero.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "sim_test.h"
+#include "ms5637_filter.h"
+
+#define PERIOD_MS 180
+
+// Ganhos alfa e beta de Kalata em ponto flutuante
+static void reference_gains(double period_s, double meas_cm, double accel_cm_s2,
+                            double *alpha, double *beta) {
+    double lambda = accel_cm_s2 * period_s * period_s / meas_cm;
+    double u = ((4.0 + lambda) - sqrt(lambda * lambda + 8.0 * lambda)) / 4.0;
+    *alpha = 1.0 - u * u;
+    *beta = 2.0 * (1.0 - u) * (1.0 - u);
+}
+
+// Ganhos do filtro contra a referência, com tolerância relativa e de 2 LSB em Q16
+static bool gains_match(uint32_t period_ms, uint32_t meas_cm, uint32_t accel_cm_s2) {
+    ms5637_kalman_t kf;
+    double alpha, beta;
+    ms5637_kalman_init(&kf, period_ms, meas_cm, accel_cm_s2);
+    reference_gains(period_ms / 1000.0, meas_cm, accel_cm_s2, &alpha, &beta);
+    double k_alt = alpha * 65536.0;
+    double k_vel = beta / (period_ms / 1000.0) * 65536.0;
+    return fabs(kf.k_alt - k_alt) <= 2.0 + k_alt * 1e-3 &&
+           fabs(kf.k_vel - k_vel) <= 2.0 + k_vel * 1e-3;
+}
+
+int main(void) {
+    printf("[filtro] Média móvel exponencial\n");
+    ms5637_ema_t ema;
+    ms5637_ema_init(&ema, 2);
+    sim_check(ms5637_ema_update(&ema, 100000) == 100000, "primeira amostra sem rampa");
+
+    // Degrau de 100000 para 104000 com peso 1/4
+    bool follows = true;
+    int k63 = 0;
+    int32_t y = 0;
+    for (int k = 1; k <= 40; k++) {
+        y = ms5637_ema_update(&ema, 104000);
+        double expect = 100000.0 + 4000.0 * (1.0 - pow(0.75, k));
+        follows = follows && fabs(y - expect) <= 1.0;
+        if (!k63 && y - 100000 >= 2528) // 63,2% do degrau
+            k63 = k;
+    }
+    sim_check(follows, "segue 1 - (3/4)^k ponto a ponto");
+    sim_check(k63 == 4, "63% do degrau na 4ª amostra");
+    sim_check(y == 104000, "assenta exatamente no valor de subida");
+    for (int k = 0; k < 40; k++)
+        y = ms5637_ema_update(&ema, 99000);
+    sim_check(y == 99000, "assenta exatamente no valor de descida");
+    ms5637_ema_init(&ema, 3);
+    ms5637_ema_update(&ema, -500);
+    for (int k = 0; k < 80; k++)
+        y = ms5637_ema_update(&ema, -1500);
+    sim_check(y == -1500, "valores negativos");
+    ms5637_ema_init(&ema, 0);
+    ms5637_ema_update(&ema, 10);
+    sim_check(ms5637_ema_update(&ema, 12345) == 12345, "shift 0: sem filtro");
+
+    printf("[filtro] Kalman de altitude\n");
+    sim_check(gains_match(PERIOD_MS, 24, 100), "ganhos do laço principal = Kalata");
+    sim_check(gains_match(20, 500, 10) && gains_match(1000, 5, 2000),
+              "ganhos nos extremos de lambda = Kalata");
+
+    ms5637_kalman_t kf;
+    ms5637_kalman_init(&kf, PERIOD_MS, 24, 100);
+    ms5637_kalman_update(&kf, 5000, PERIOD_MS);
+    sim_check(ms5637_kalman_altitude_cm(&kf) == 5000 && ms5637_kalman_speed_cm_s(&kf) == 0,
+              "primeira amostra: na medida, parado");
+    for (int k = 0; k < 50; k++)
+        ms5637_kalman_update(&kf, 5000, PERIOD_MS);
+    sim_check(ms5637_kalman_altitude_cm(&kf) == 5000 && ms5637_kalman_speed_cm_s(&kf) == 0,
+              "entrada constante: altitude fixa, velocidade zero");
+
+    // Degrau de 10 m: o primeiro passo anda alfa do degrau, depois assenta
+    ms5637_kalman_update(&kf, 6000, PERIOD_MS);
+    int32_t first = ms5637_kalman_altitude_cm(&kf) - 5000;
+    int32_t expect_first = (int32_t)(1000.0 * kf.k_alt / 65536.0);
+    sim_check(abs(first - expect_first) <= 1 && first > 0 && first < 1000,
+              "degrau: primeiro passo = alfa do degrau");
+    int32_t peak = 0;
+    for (int k = 0; k < 200; k++) {
+        ms5637_kalman_update(&kf, 6000, PERIOD_MS);
+        if (ms5637_kalman_altitude_cm(&kf) > peak)
+            peak = ms5637_kalman_altitude_cm(&kf);
+    }
+    printf("  pico %ld cm\n", (long)peak);
+    sim_check(peak < 6000 + 500, "sobressinal abaixo de metade do degrau");
+    sim_check(abs(ms5637_kalman_altitude_cm(&kf) - 6000) <= 1 &&
+              abs(ms5637_kalman_speed_cm_s(&kf)) <= 1,
+              "degrau: assenta na medida com velocidade zero");
+
+    // Subida constante de 1 m/s: sem atraso em regime (modelo de velocidade constante)
+    int32_t alt = 6000;
+    for (int k = 0; k < 300; k++) {
+        alt += 100 * PERIOD_MS / 1000;
+        ms5637_kalman_update(&kf, alt, PERIOD_MS);
+    }
+    sim_check(abs(ms5637_kalman_speed_cm_s(&kf) - 100) <= 1, "subida de 1 m/s: velocidade");
+    sim_check(abs(ms5637_kalman_altitude_cm(&kf) - alt) <= 1, "subida: sem atraso de altitude");
+
+    // Parado de novo, com ruído de ±24 cm alternado: velocidade média zero
+    int64_t speed_sum = 0;
+    for (int k = 0; k < 400; k++) {
+        ms5637_kalman_update(&kf, alt + ((k & 1) ? 24 : -24), PERIOD_MS);
+        if (k >= 200)
+            speed_sum += ms5637_kalman_speed_cm_s(&kf);
+    }
+    sim_check(llabs(speed_sum) <= 200, "parado com ruído: velocidade média ~0");
+    sim_check(abs(ms5637_kalman_altitude_cm(&kf) - alt) <= 24, "altitude dentro do ruído");
+
+    // Lacuna longa (painel trocado): recomeça na medida
+    ms5637_kalman_update(&kf, 100, PERIOD_MS * (MS5637_KALMAN_MAX_GAP_PERIODS + 1));
+    sim_check(ms5637_kalman_altitude_cm(&kf) == 100 && ms5637_kalman_speed_cm_s(&kf) == 0,
+              "lacuna longa reinicia o filtro");
+
+    return sim_test_result("filtro");
+}
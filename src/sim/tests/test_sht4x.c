@@ -0,0 +1,191 @@
+/**
+ * @file test_sht4x.c
+ * @brief Conversões do SHT4x, CRC-8, NACK durante a medição e agendador do aquecedor
+ *
+ * O modelo codifica a condição imposta com as fórmulas inversas do datasheet;
+ * a leitura inteira do driver tem de devolvê-la com erro de até 0,01 nas
+ * três precisões. Respostas com CRC estragado viram SHT4X_STATUS_CRC_ERROR e
+ * a busca antes do prazo não toca no barramento. O agendador de
+ * sht4x_heater.c roda contra o relógio virtual com a umidade presa: os pulsos
+ * respeitam o espaçamento do duty cycle e nenhuma amostra quente é publicada.
+ */
+
+#include <stdlib.h>
+#include "sim.h"
+#include "sim_test.h"
+#include "SHT4xl-PCEIoT-Board.h"
+#include "sht4x_heater.h"
+
+#define POLL_STEP_US 1000
+
+// Lê na precisão dada e compara com a condição imposta (+-1 centésimo)
+static bool reads_back(SHT4x_Precision precision, int32_t temp_centi, int32_t hum_centi) {
+    int32_t t = 0, h = 0;
+    sim_sht4x_set_conditions(temp_centi, hum_centi);
+    if (!sht4x_read_temp_hum_centi(precision, &t, &h))
+        return false;
+    return abs(t - temp_centi) <= 1 && abs(h - hum_centi) <= 1;
+}
+
+static uint32_t transactions(void) {
+    sim_i2c_counters_t c;
+    sim_i2c_counters(SHT4X_I2C_ADDRESS, &c);
+    return c.transactions;
+}
+
+// Resultado de um trecho do agendador do aquecedor
+typedef struct {
+    uint32_t published;        // amostras SHT4X_STATUS_OK
+    uint32_t affected;         // amostras SHT4X_STATUS_HEATER_AFFECTED
+    uint32_t errors;
+    uint32_t pulses;
+    uint32_t published_before_first; // amostras publicadas antes do 1º pulso
+    uint64_t min_spacing_us;   // menor intervalo entre inícios de pulsos
+    uint64_t max_spacing_us;
+    bool hot_published;        // alguma amostra publicada longe do ambiente
+    bool settle_ok;            // cada pulso seguido de 1 + settle_samples afetadas
+    bool active_seen;          // sht4x_heater_active() durante cada pulso
+} heater_run_t;
+
+// Roda o agendador por `duration_us`, consultando a cada POLL_STEP_US. Com
+// `hum_step` a umidade alterna entre hum_centi e hum_centi + hum_step a cada amostra
+static void run_heater(const sht4x_heater_config_t *cfg, uint64_t duration_us,
+                       int32_t hum_centi, int32_t hum_step, heater_run_t *r) {
+    const int32_t temp_centi = 2000;
+    *r = (heater_run_t){.min_spacing_us = UINT64_MAX, .settle_ok = true, .active_seen = true};
+    sim_sht4x_attach();
+    sim_sht4x_set_conditions(temp_centi, hum_centi);
+    sht4x_heater_init(cfg);
+
+    uint64_t end = sim_time_us() + duration_us;
+    uint64_t last_pulse_us = 0;
+    uint32_t expect_affected = 0;
+    bool odd = false;
+    while (sim_time_us() < end) {
+        sht4x_sample_t sample;
+        SHT4x_Status status = sht4x_heater_poll(&sample);
+        if (status == SHT4X_STATUS_OK || status == SHT4X_STATUS_HEATER_AFFECTED) {
+            bool affected = status == SHT4X_STATUS_HEATER_AFFECTED;
+            if (affected) {
+                r->affected++;
+            } else {
+                r->published++;
+                if (r->pulses == 0)
+                    r->published_before_first++;
+                if (abs(sample.temp_centi - temp_centi) > 1)
+                    r->hot_published = true;
+            }
+            if (affected != (expect_affected > 0))
+                r->settle_ok = false;
+            if (expect_affected > 0)
+                expect_affected--;
+            odd = !odd;
+            sim_sht4x_set_conditions(temp_centi, hum_centi + (odd ? hum_step : 0));
+        } else if (status != SHT4X_STATUS_NOT_READY) {
+            r->errors++;
+        }
+
+        // Pulso iniciado nesta consulta
+        if (sim_sht4x_heater_pulses() != r->pulses) {
+            uint64_t now = sim_time_us();
+            if (r->pulses > 0) {
+                uint64_t spacing = now - last_pulse_us;
+                if (spacing < r->min_spacing_us) r->min_spacing_us = spacing;
+                if (spacing > r->max_spacing_us) r->max_spacing_us = spacing;
+            }
+            if (!sht4x_heater_active())
+                r->active_seen = false;
+            last_pulse_us = now;
+            r->pulses = sim_sht4x_heater_pulses();
+            expect_affected = 1 + cfg->settle_samples;
+        }
+        sim_time_advance_us(POLL_STEP_US);
+    }
+    if (sht4x_heater_pulse_count() != r->pulses)
+        r->settle_ok = false;
+}
+
+int main(void) {
+    int32_t t = 0, h = 0;
+    sim_sht4x_attach();
+
+    printf("[sht4x] Conversões\n");
+    sim_check(sht4x_init(), "sht4x_init");
+    sim_check(reads_back(PRECISION_HIGH, 2350, 4875), "23,50 C / 48,75 %UR (alta)");
+    sim_check(reads_back(PRECISION_MEDIUM, -4000, 0), "-40,00 C / 0 %UR (média)");
+    sim_check(reads_back(PRECISION_LOW, 12500, 10000), "125,00 C / 100 %UR (baixa)");
+    sim_check(reads_back(PRECISION_HIGH, 0, 5000), "0,00 C / 50 %UR");
+    sim_check(reads_back(PRECISION_HIGH, -1234, 3333), "-12,34 C / 33,33 %UR");
+
+    // Fora de 0-100 %UR o sensor ainda codifica; o driver satura
+    sim_sht4x_set_conditions(2500, 10500);
+    sim_check(sht4x_read_temp_hum_centi(PRECISION_HIGH, &t, &h) && h == 10000, "umidade saturada em 100 %UR");
+
+    float tf = 0, hf = 0;
+    sim_sht4x_set_conditions(2350, 4875);
+    sim_check(sht4x_read_temp_hum(PRECISION_HIGH, &tf, &hf) && tf > 23.49f && tf < 23.51f &&
+              hf > 48.74f && hf < 48.76f,
+              "versão em float concorda");
+
+    printf("[sht4x] Duas fases e NACK\n");
+    sim_check(sht4x_start_measurement(PRECISION_HIGH) == SHT4X_STATUS_OK, "medição iniciada");
+    uint32_t before = transactions();
+    sim_check(sht4x_fetch_result(&t, &h) == SHT4X_STATUS_NOT_READY, "antes do prazo: NOT_READY");
+    sim_check(transactions() == before, "sem acesso ao barramento");
+    sim_check(sht4x_start_measurement(PRECISION_HIGH) == SHT4X_STATUS_ERROR,
+              "comando durante a medição: NACK");
+    sim_check(sht4x_wait_result(&t, &h) == SHT4X_STATUS_ERROR, "medição descartada pelo NACK");
+    sim_time_advance_us(10000); // a medição no chip termina sozinha
+    sim_check(sht4x_start_measurement(PRECISION_HIGH) == SHT4X_STATUS_OK &&
+              sht4x_wait_result(&t, &h) == SHT4X_STATUS_OK && t == 2350,
+              "nova medição após o prazo");
+
+    printf("[sht4x] CRC-8\n");
+    sim_sht4x_corrupt_crc(true);
+    sim_check(!sht4x_read_temp_hum_centi(PRECISION_HIGH, &t, &h), "leitura bloqueante falha");
+    sim_check(sht4x_start_measurement(PRECISION_HIGH) == SHT4X_STATUS_OK &&
+              sht4x_wait_result(&t, &h) == SHT4X_STATUS_CRC_ERROR,
+              "duas fases: CRC_ERROR");
+    sim_sht4x_corrupt_crc(false);
+    sim_check(reads_back(PRECISION_HIGH, 2350, 4875), "CRC íntegro: leitura volta");
+
+    printf("[sht4x] Aquecedor\n");
+    sim_check(sht4x_read_with_heater(HEATER_LOW_0_1S, &tf, &hf) && sim_sht4x_heater_pulses() == 1 &&
+              tf > 23.51f,
+              "pulso do aquecedor com medição (quente)");
+
+    printf("[sht4x] Agendador do aquecedor\n");
+    const sht4x_heater_config_t cfg = SHT4X_HEATER_CONFIG_DEFAULT;
+    // Pulso de 1 s com no máximo 10%: inícios separados por pelo menos 10 s
+    const uint64_t min_spacing_us = 1000000ull * 100 / cfg.max_duty_percent;
+    heater_run_t r;
+
+    run_heater(&cfg, 65000000, 10000, 0, &r);
+    printf("  100 %%UR por 65 s: %lu pulsos, espaçamento %llu-%llu ms\n", (unsigned long)r.pulses,
+           (unsigned long long)(r.min_spacing_us / 1000), (unsigned long long)(r.max_spacing_us / 1000));
+    sim_check(r.errors == 0, "sem erros");
+    sim_check(r.published_before_first == cfg.trigger_samples,
+              "1º pulso após trigger_samples saturadas");
+    sim_check(r.pulses == 7, "7 pulsos em 65 s (um a cada 10 s)");
+    sim_check(r.min_spacing_us >= min_spacing_us, "espaçamento >= pulso * 100 / max_duty");
+    sim_check(r.max_spacing_us < min_spacing_us + 100000, "pulso assim que o duty cycle permite");
+    sim_check((uint64_t)r.pulses * 1000000 * 100 <= (65000000ull + min_spacing_us) * cfg.max_duty_percent,
+              "duty cycle dentro de max_duty_percent");
+    sim_check(r.active_seen, "sht4x_heater_active() durante o pulso");
+    sim_check(r.settle_ok && r.affected == r.pulses * (1u + cfg.settle_samples),
+              "pulso + settle_samples marcadas HEATER_AFFECTED");
+    sim_check(!r.hot_published, "nenhuma amostra quente publicada");
+
+    run_heater(&cfg, 15000000, 9700, 0, &r);
+    sim_check(r.pulses == 2 && r.published_before_first == 1u + cfg.trigger_samples &&
+              r.settle_ok && !r.hot_published,
+              "97 %UR parada: travada, aquece");
+    run_heater(&cfg, 15000000, 9700, 10, &r);
+    sim_check(r.pulses == 0 && r.affected == 0, "97 %UR variando: sem pulsos");
+    run_heater(&cfg, 15000000, 9000, 0, &r);
+    sim_check(r.pulses == 0, "90 %UR parada (abaixo de stuck_min): sem pulsos");
+    run_heater(&cfg, 15000000, 5000, 0, &r);
+    sim_check(r.pulses == 0 && r.published > 1000, "50 %UR: só amostras publicadas");
+
+    return sim_test_result("sht4x");
+}
@@ -0,0 +1,122 @@
+/**
+ * @file test_ssd1306.c
+ * @brief Trechos alterados do SSD1306: o que vai ao barramento em cada quadro
+ *
+ * Confere, pelo modelo do painel, que o primeiro quadro (e todo quadro após
+ * ssd1306_invalidate() ou uma falha) vai em 8 trechos de página inteira, que
+ * um quadro sem mudanças não gera tráfego e que cada página alterada vira um
+ * único trecho da primeira à última coluna modificada.
+ */
+
+#include "sim.h"
+#include "sim_test.h"
+#include "ssd1306.h"
+
+static ssd1306_t display;
+
+static bool gddram_matches(void) {
+    for (uint8_t y = 0; y < SSD1306_HEIGHT; y++)
+        for (uint8_t x = 0; x < SSD1306_WIDTH; x++) {
+            bool want = (display.buffer[(y / 8) * SSD1306_WIDTH + x] >> (y % 8)) & 1;
+            if (sim_ssd1306_pixel(x, y) != want)
+                return false;
+        }
+    return true;
+}
+
+// Tráfego gerado por um envio: transações e bytes de dados na GDDRAM
+typedef struct {
+    uint32_t transactions;
+    uint32_t data_bytes;
+} traffic_t;
+
+static traffic_t traffic_mark(void) {
+    sim_i2c_counters_t c;
+    sim_i2c_counters(SSD1306_I2C_ADDR, &c);
+    return (traffic_t){c.transactions, sim_ssd1306_data_bytes()};
+}
+
+static traffic_t traffic_since(traffic_t mark) {
+    traffic_t now = traffic_mark();
+    return (traffic_t){now.transactions - mark.transactions, now.data_bytes - mark.data_bytes};
+}
+
+// Envio síncrono: janela + dados por trecho
+static bool sync_sends(uint32_t spans, uint32_t bytes) {
+    traffic_t mark = traffic_mark();
+    ssd1306_display(&display);
+    traffic_t t = traffic_since(mark);
+    return t.transactions == 2 * spans && t.data_bytes == bytes && display.bytes_sent == bytes &&
+           gddram_matches();
+}
+
+static int async_calls = 0;
+static bool async_ok = false;
+
+static void flush_done(ssd1306_t *disp, bool ok) {
+    (void)disp;
+    async_calls++;
+    async_ok = ok;
+}
+
+int main(void) {
+    sim_ssd1306_attach();
+
+    printf("[ssd1306] Quadro completo\n");
+    sim_check(ssd1306_init(&display, SSD1306_I2C_ADDR) && sim_ssd1306_display_on(), "ssd1306_init");
+    ssd1306_draw_string(&display, 0, 0, "PCEIoT");
+    sim_check(sync_sends(8, SSD1306_BUFFER_SIZE), "primeiro quadro: 8 trechos de 128 bytes");
+    sim_check(display.bytes_saved == 0, "primeiro quadro não poupa bytes");
+
+    printf("[ssd1306] Trechos alterados\n");
+    sim_check(sync_sends(0, 0), "quadro igual: nenhuma transação");
+    ssd1306_set_pixel(&display, 10, 20, true);
+    sim_check(sync_sends(1, 1), "um pixel: um trecho de 1 byte");
+    ssd1306_set_pixel(&display, 5, 20, true);
+    ssd1306_set_pixel(&display, 100, 23, true);
+    sim_check(sync_sends(1, 96), "colunas 5 e 100 da página 2: 96 bytes");
+    ssd1306_set_pixel(&display, 64, 1, true);
+    ssd1306_set_pixel(&display, 64, 1, false); // volta ao que o painel mostra
+    ssd1306_set_pixel(&display, 127, 63, true);
+    ssd1306_set_pixel(&display, 64, 2, true);
+    sim_check(sync_sends(2, 2), "páginas 0 e 7: dois trechos");
+    sim_check(display.bytes_saved == SSD1306_BUFFER_SIZE - 2, "bytes poupados no quadro");
+
+    printf("[ssd1306] Invalidação e falha\n");
+    ssd1306_invalidate(&display);
+    sim_check(sync_sends(8, SSD1306_BUFFER_SIZE), "após invalidate: 8 trechos de página");
+
+    sim_i2c_detach(SSD1306_I2C_ADDR);
+    ssd1306_fill_rect(&display, 0, 32, 128, 8, true);
+    ssd1306_display(&display);
+    sim_check(!display.shadow_valid, "NACK: cópia sombra descartada");
+    sim_ssd1306_attach(); // painel religado com GDDRAM indefinida
+    sim_check(sync_sends(8, SSD1306_BUFFER_SIZE), "quadro seguinte vai inteiro");
+
+    printf("[ssd1306] Envio assíncrono\n");
+    ssd1306_invalidate(&display);
+    traffic_t mark = traffic_mark();
+    sim_check(ssd1306_display_async(&display, flush_done), "ssd1306_display_async");
+    ssd1306_flush_wait(&display);
+    traffic_t t = traffic_since(mark);
+    // Janela e dados vão na mesma sequência de DMA: uma transação por página
+    sim_check(t.transactions == 8 && t.data_bytes == SSD1306_BUFFER_SIZE,
+              "quadro completo: 8 transações BULK");
+    sim_check(async_calls == 1 && async_ok && gddram_matches(), "callback único e GDDRAM = buffer");
+
+    ssd1306_draw_string(&display, 0, 56, "x");
+    mark = traffic_mark();
+    sim_check(ssd1306_display_async(&display, flush_done), "atualização parcial assíncrona");
+    ssd1306_flush_wait(&display);
+    t = traffic_since(mark);
+    sim_check(t.transactions == 1 && t.data_bytes == display.bytes_sent && display.bytes_sent <= 5,
+              "um trecho só com as colunas do glifo");
+    sim_check(async_calls == 2 && gddram_matches(), "GDDRAM = buffer");
+
+    mark = traffic_mark();
+    sim_check(ssd1306_display_async(&display, flush_done), "quadro igual assíncrono");
+    t = traffic_since(mark);
+    sim_check(t.transactions == 0 && async_calls == 3 && async_ok, "callback sem tráfego");
+
+    return sim_test_result("ssd1306");
+}
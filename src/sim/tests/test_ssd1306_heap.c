@@ -0,0 +1,79 @@
+/**
+ * @file test_ssd1306_heap.c
+ * @brief O envio de quadros do SSD1306 não usa o heap
+ *
+ * Ligado com -Wl,--wrap para malloc, calloc, realloc e free: toda chamada
+ * feita pelos drivers e pelo barramento passa pelos contadores abaixo. Os
+ * quadros completos, parciais e assíncronos têm de terminar com zero chamadas.
+ */
+
+#include <stdlib.h>
+#include "sim.h"
+#include "sim_test.h"
+#include "ssd1306.h"
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+static unsigned heap_calls = 0;
+
+void *__wrap_malloc(size_t size) {
+    heap_calls++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+    heap_calls++;
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    heap_calls++;
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr) {
+    heap_calls++;
+    __real_free(ptr);
+}
+
+static ssd1306_t display;
+
+int main(void) {
+    // Os contadores precisam enxergar as chamadas, senão o teste nada prova
+    // (volatile: com otimização o par malloc/free seria eliminado)
+    void *volatile probe = malloc(16);
+    free(probe);
+    sim_check(heap_calls == 2, "--wrap ativo (malloc/free contados)");
+
+    sim_ssd1306_attach();
+    sim_check(ssd1306_init(&display, SSD1306_I2C_ADDR), "ssd1306_init");
+
+    heap_calls = 0;
+    ssd1306_draw_string(&display, 0, 0, "MS5637 SENSOR");
+    ssd1306_fill_rect(&display, 0, 10, 128, 1, true);
+    ssd1306_display(&display);
+    sim_check(display.bytes_sent == SSD1306_BUFFER_SIZE, "quadro completo enviado");
+    sim_check(heap_calls == 0, "quadro completo: nenhuma chamada ao heap");
+
+    for (int i = 0; i < 50; i++) {
+        ssd1306_fill_rect(&display, 80, 16, 40, 8, false);
+        ssd1306_draw_char(&display, 80 + (i % 6) * 6, 16, (char)('0' + i % 10));
+        ssd1306_display(&display);
+    }
+    sim_check(heap_calls == 0, "50 quadros parciais: nenhuma chamada");
+
+    for (int i = 0; i < 50; i++) {
+        ssd1306_draw_char(&display, 80, 32, (char)('A' + i % 26));
+        ssd1306_display_async(&display, NULL);
+        ssd1306_flush_wait(&display);
+    }
+    ssd1306_invalidate(&display);
+    ssd1306_display_async(&display, NULL);
+    ssd1306_flush_wait(&display);
+    sim_check(heap_calls == 0, "envios assíncronos: nenhuma chamada");
+
+    return sim_test_result("ssd1306 heap");
+}
@@ -0,0 +1,220 @@
+/**
+ * @file test_sx1509.c
+ * @brief Caminho de eventos dos botões: NINT, leitura em rajada e fila
+ *
+ * A descida do NINT no modelo dispara a IRQ do GPIO, que enfileira a leitura
+ * de prioridade alta; o callback dela gera os eventos e limpa a fonte. Confere
+ * a ordem dos eventos, o NINT de volta em repouso, o descarte com a fila
+ * cheia e a retomada por io_expander_service() após uma leitura que falhou.
+ */
+
+#include "sim.h"
+#include "sim_test.h"
+#include "io_expander.h"
+#include "i2c_bus.h"
+#include "pico/stdlib.h"
+
+#define SX1509_ADDR                0x3E
+#define REG_INTERRUPT_SOURCE_A     0x19
+#define REG_MISC                   0x1F
+#define REG_DIR_B                  0x0E
+#define REG_DIR_A                  0x0F
+#define REG_DATA_B                 0x10
+#define REG_DATA_A                 0x11
+
+// RegIOn dos pinos do LED RGB 1 (5-7), pela tabela de registradores do datasheet
+static const uint8_t led1_ion[3] = {0x3B, 0x40, 0x45};
+
+// Blocos do driver de LED pelo datasheet: RegTOn, RegIOn, RegOff e, nos pinos
+// 4-7 e 12-15, RegTRise e RegTFall
+#define LED_TON9  0x4C
+#define LED_TON13 0x5A
+#define LED_TON14 0x5F
+#define LED_TON15 0x64
+
+// Compara `count` registradores a partir de `reg` com os valores esperados
+static bool regs_are(uint8_t reg, const uint8_t *expected, int count) {
+    for (int i = 0; i < count; i++)
+        if (sim_sx1509_reg((uint8_t)(reg + i)) != expected[i])
+            return false;
+    return true;
+}
+
+static uint32_t sx1509_transactions(void) {
+    sim_i2c_counters_t c;
+    sim_i2c_counters(SX1509_ADDR, &c);
+    return c.transactions;
+}
+
+static bool led1_ion_full(void) {
+    for (int i = 0; i < 3; i++)
+        if (sim_sx1509_reg(led1_ion[i]) != 0xFF)
+            return false;
+    return true;
+}
+
+// Próximo evento da fila é (button, pressed)
+static bool next_event_is(uint8_t button, bool pressed) {
+    io_expander_event_t ev;
+    return io_expander_pop_event(&ev) && ev.button == button && ev.pressed == pressed;
+}
+
+static bool nint_idle(void) {
+    return gpio_get(IO_EXPANDER_NINT_GPIO) && sim_sx1509_reg(REG_INTERRUPT_SOURCE_A) == 0;
+}
+
+int main(void) {
+    sim_sx1509_attach(IO_EXPANDER_NINT_GPIO);
+
+    printf("[sx1509] Cópia de DIR/DATA em RAM\n");
+    sim_i2c_counters_t c0, c1;
+    sim_i2c_counters(SX1509_ADDR, &c0);
+    io_expander_init_buttons();
+    sim_i2c_counters(SX1509_ADDR, &c1);
+    sim_check(c1.transactions - c0.transactions == 1 && c1.bytes_read - c0.bytes_read == 4,
+              "primeiro uso: uma leitura de DIR/DATA (4 B)");
+    sim_check(c1.bytes_written - c0.bytes_written == 1, "botões já são entrada: sem escrita");
+
+    c0 = c1;
+    io_expander_init_leds();
+    sim_i2c_counters(SX1509_ADDR, &c1);
+    sim_check(c1.bytes_read == c0.bytes_read, "io_expander_init_leds() não relê o chip");
+    sim_check(c1.transactions - c0.transactions == 1 && c1.bytes_written - c0.bytes_written == 3,
+              "DIR dos dois bancos numa escrita com auto-incremento");
+    sim_check(sim_sx1509_reg(REG_DIR_B) == 0x18 && sim_sx1509_reg(REG_DIR_A) == 0x1F,
+              "DIR_B = 0x18, DIR_A = 0x1F");
+
+    c0 = c1;
+    set_rgb_led(RGB_LED_2, true, false, false);
+    sim_i2c_counters(SX1509_ADDR, &c1);
+    sim_check(c1.transactions - c0.transactions == 1 && c1.bytes_written - c0.bytes_written == 2,
+              "cor do LED 2: só DATA_B");
+    sim_check((sim_sx1509_reg(REG_DATA_B) & 0x07) == 0x06, "vermelho: pino 8 em nível baixo");
+
+    c0 = c1;
+    set_rgb_led(RGB_LED_2, true, false, false);
+    io_expander_init_buttons();
+    io_expander_init_leds();
+    sim_i2c_counters(SX1509_ADDR, &c1);
+    sim_check(c1.transactions == c0.transactions, "nada mudou: nenhuma transação");
+
+    printf("[sx1509] Inicialização\n");
+    io_expander_init_button_irq();
+    sim_check(nint_idle(), "NINT em repouso e fonte limpa");
+    sim_check(sim_sx1509_reg(REG_MISC) & 0x01, "RegMisc bit 0: fonte limpa só por escrita");
+    sim_check(!io_expander_event_pending(), "fila vazia");
+
+    printf("[sx1509] Eventos\n");
+    sim_sx1509_set_button(0, true);
+    sim_check(next_event_is(0, true), "botão 0 pressionado");
+    sim_check(nint_idle(), "NINT solto após a limpeza");
+    sim_sx1509_set_button(0, false);
+    sim_check(next_event_is(0, false), "botão 0 solto");
+
+    sim_sx1509_set_button(1, true);
+    sim_sx1509_set_button(2, true);
+    sim_sx1509_set_button(2, false);
+    sim_sx1509_set_button(1, false);
+    sim_check(next_event_is(1, true) && next_event_is(2, true) &&
+              next_event_is(2, false) && next_event_is(1, false),
+              "quatro bordas em ordem");
+    sim_check(!io_expander_event_pending() && nint_idle(), "nada pendente");
+
+    printf("[sx1509] Fila cheia\n");
+    for (int i = 0; i < IO_EXPANDER_EVENT_QUEUE_SIZE / 2 + 2; i++) {
+        sim_sx1509_set_button(0, true);
+        sim_sx1509_set_button(0, false);
+    }
+    int popped = 0;
+    io_expander_event_t ev;
+    while (io_expander_pop_event(&ev))
+        popped++;
+    sim_check(popped == IO_EXPANDER_EVENT_QUEUE_SIZE, "fila entrega a capacidade");
+    sim_check(io_expander_dropped_events() == 4, "excedentes contados como descartados");
+
+    printf("[sx1509] Leitura com falha\n");
+    sim_i2c_set_stuck(true);
+    sim_sx1509_set_button(2, true);
+    sim_check(!io_expander_event_pending(), "leitura falhou: nada na fila");
+    sim_check(!gpio_get(IO_EXPANDER_NINT_GPIO), "NINT continua baixo");
+    sim_check(i2c_bus_service_pending(), "barramento espera a liberação");
+    sim_i2c_set_stuck(false);
+    i2c_bus_service(); // como no laço principal: liberação, depois o expansor
+    io_expander_service();
+    sim_check(next_event_is(2, true), "io_expander_service() retoma o evento");
+    sim_check(nint_idle(), "NINT solto");
+
+    sim_i2c_counters_t before, after;
+    sim_i2c_counters(SX1509_ADDR, &before);
+    io_expander_service();
+    sim_i2c_counters(SX1509_ADDR, &after);
+    sim_check(after.transactions == before.transactions, "NINT em repouso: service sem tráfego");
+
+    printf("[sx1509] Limpeza da fonte com falha\n");
+    sim_sx1509_nack_source_clear(1);
+    sim_sx1509_set_button(1, true);
+    sim_check(next_event_is(1, true), "borda lida e enfileirada");
+    sim_check(!gpio_get(IO_EXPANDER_NINT_GPIO), "limpeza recusada: NINT continua baixo");
+    uint32_t txns = sx1509_transactions();
+    io_expander_service();
+    sim_check(sx1509_transactions() - txns == 1, "service repete só a limpeza");
+    sim_check(nint_idle(), "NINT solto");
+    sim_check(!io_expander_event_pending(), "sem soltar + pressionar falsos");
+    sim_sx1509_set_button(1, false);
+    sim_check(next_event_is(1, false) && !io_expander_event_pending(), "próxima borda normal");
+
+    printf("[sx1509] LED RGB aceso/apagado com o driver de LED ligado\n");
+    io_expander_init_led_driver();
+    txns = sx1509_transactions();
+    set_rgb_led(RGB_LED_1, false, true, false);
+    sim_check(sx1509_transactions() - txns == 1, "primeira cor: uma transação");
+    sim_check((sim_sx1509_reg(REG_DATA_A) & 0xE0) == 0xA0, "verde: só o pino 6 em nível baixo");
+    txns = sx1509_transactions();
+    set_rgb_led(RGB_LED_1, false, false, true);
+    sim_check(sx1509_transactions() - txns == 1, "verde -> azul: uma transação");
+    sim_check((sim_sx1509_reg(REG_DATA_A) & 0xE0) == 0x60, "azul: só o pino 7 em nível baixo");
+    sim_check(led1_ion_full(), "RegIOn dos pinos 5-7 continua 255");
+    txns = sx1509_transactions();
+    set_rgb_led(RGB_LED_1, false, false, true);
+    sim_check(sx1509_transactions() == txns, "mesma cor: nenhuma transação");
+
+    // Depois de uma intensidade parcial, acender volta o bloco ao aceso fixo
+    set_rgb_led_pwm(RGB_LED_1, 0, 0, 40);
+    set_rgb_led(RGB_LED_1, false, false, true);
+    sim_check(sim_sx1509_reg(led1_ion[2]) == 0xFF, "após PWM parcial: RegIOn de volta a 255");
+
+    // Códigos de tempo com ClkX = 250 kHz: TOn/TOff n * 65,28 ms (1-15) e
+    // n * 522,24 ms (16-31); TRise/TFall n * (IOn - 4 * IOff) * 1,02 ms (1-15)
+    printf("[sx1509] Registradores do driver de LED\n");
+    io_expander_led_blink(9, 200, 12, 1500, 130);
+    sim_check(regs_are(LED_TON9, (const uint8_t[]){15, 200, (2 << 3) | 3}, 3),
+              "pino 9, pisca 1,5 s/130 ms: TOn 15, Off 2|3");
+    sim_check(!(sim_sx1509_reg(REG_DATA_B) & 0x02), "pino 9 ligado em DATA_B");
+    io_expander_led_blink(9, 200, 12, 4667, 4668);
+    sim_check(regs_are(LED_TON9, (const uint8_t[]){15, 200, (16 << 3) | 3}, 3),
+              "buraco 0,98-8,4 s: 4667 ms -> 15, 4668 ms -> 16");
+    io_expander_led_blink(9, 200, 0, 10000, 16000);
+    sim_check(regs_are(LED_TON9, (const uint8_t[]){19, 200, 31 << 3}, 3),
+              "passo longo: 10 s -> 19, 16 s -> 31");
+
+    io_expander_led_breathe(14, 255, 12, 500, 1000, 1000, 5000);
+    sim_check(regs_are(LED_TON14, (const uint8_t[]){8, 255, (15 << 3) | 3, 4, 15}, 5),
+              "pino 14 respirando: TOn 8, Off 15|3, rampas 4 e 15");
+
+    set_rgb_led_pattern(RGB_LED_3, LED_PATTERN_SAMPLING);
+    sim_check(regs_are(LED_TON13, (const uint8_t[]){0, 0, 0, 0, 0}, 5) &&
+              regs_are(LED_TON14, (const uint8_t[]){8, 96, 15 << 3, 10, 10}, 5) &&
+              regs_are(LED_TON15, (const uint8_t[]){0, 0, 0, 0, 0}, 5),
+              "padrão amostrando: verde respirando, R e B apagados");
+    sim_check((sim_sx1509_reg(REG_DATA_B) & 0xE0) == 0xA0, "só o pino 14 ligado");
+    set_rgb_led_pattern(RGB_LED_3, LED_PATTERN_ALARM);
+    sim_check(regs_are(LED_TON13, (const uint8_t[]){2, 255, 2 << 3, 0, 0}, 5) &&
+              regs_are(LED_TON14, (const uint8_t[]){0, 0, 0, 0, 0}, 5),
+              "padrão alarme: vermelho piscando 130 ms");
+    sim_check((sim_sx1509_reg(REG_DATA_B) & 0xE0) == 0xC0, "só o pino 13 ligado");
+    txns = sx1509_transactions();
+    set_rgb_led_pattern(RGB_LED_3, LED_PATTERN_ALARM);
+    sim_check(sx1509_transactions() == txns, "mesmo padrão: nenhuma transação");
+
+    return sim_test_result("sx1509");
+}
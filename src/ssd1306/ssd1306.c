@@ -9,6 +9,19 @@
  */
 
 #include "ssd1306.h"
+#include <stddef.h>
+
+#if SSD1306_DOUBLE_BUFFER
+#define SSD1306_FRONT(d) ((d)->front)  ///< Referência do que o painel exibe
+#else
+#define SSD1306_FRONT(d) ((d)->shadow) ///< Referência do que o painel exibe
+
+// O envio sem cópia depende do byte de controle estar colado ao buffer
+_Static_assert(offsetof(ssd1306_t, buffer) == offsetof(ssd1306_t, data_ctrl) + 1,
+               "data_ctrl deve preceder buffer[] sem padding");
+#endif
+
+#define SSD1306_CTRL_DATA 0x40 ///< Byte de controle: bytes seguintes são dados da GDDRAM
 
 /**
  * @brief Fonte 5x8 para caracteres ASCII (32-126)
@@ -114,96 +127,353 @@ static const uint8_t font5x8[95][5] = {
     {0x08, 0x04, 0x08, 0x10, 0x08}, // ~
 };
 
+// Send a command sequence in a single I2C transaction
+bool ssd1306_send_cmds(ssd1306_t *display, const uint8_t *cmds, size_t len)
+{
+    uint8_t buf[SSD1306_MAX_CMD_BATCH + 1];
+
+    if (len == 0 || len > SSD1306_MAX_CMD_BATCH)
+        return false;
+
+    ssd1306_flush_wait(display);
+    buf[0] = 0x00; // Co = 0, D/C# = 0: todos os bytes seguintes são comandos
+    memcpy(buf + 1, cmds, len);
+    return i2c_bus_write(&display->dev, buf, len + 1) == (int)(len + 1);
+}
+
 /**
- * @brief Envia um comando para o display SSD1306
+ * @brief Envia dados para o display SSD1306
  *
- * Função interna para comunicação de baixo nível com o display.
+ * Função interna para comunicação de baixo nível com o display. Não aloca nem
+ * copia: o byte imediatamente anterior a data (o byte de controle do
+ * framebuffer ou um byte do próprio buffer) recebe temporariamente o controle 0x40 e é restaurado após o envio.
  *
  * @param display Ponteiro para a estrutura do display
- * @param cmd Comando a ser enviado
+ * @param data Ponteiro para os dados a serem enviados (dentro de display->buffer)
+ * @param len Número de bytes a serem enviados
+ * @return true se todos os bytes foram aceitos pelo display
  */
-static void ssd1306_send_cmd(ssd1306_t *display, uint8_t cmd)
+static bool ssd1306_send_data(ssd1306_t *display, uint8_t *data, size_t len)
 {
-    uint8_t buf[2] = {0x00, cmd};
-    i2c_write_blocking(display->i2c_port, display->address, buf, 2, false);
+    uint8_t *frame = data - 1;
+    uint8_t saved = *frame;
+    *frame = SSD1306_CTRL_DATA;
+    bool ok = i2c_bus_write(&display->dev, frame, len + 1) == (int)(len + 1);
+    *frame = saved;
+    return ok;
 }
 
 /**
- * @brief Envia dados para o display SSD1306
- *
- * Função interna para comunicação de baixo nível com o display.
+ * @brief Define a janela de colunas/páginas que recebe os próximos dados
  *
  * @param display Ponteiro para a estrutura do display
- * @param data Ponteiro para os dados a serem enviados
- * @param len Número de bytes a serem enviados
+ * @param col_start Primeira coluna da janela
+ * @param col_end Última coluna da janela
+ * @param page_start Primeira página da janela
+ * @param page_end Última página da janela
+ * @return true se os comandos foram aceitos pelo display
  */
-static void ssd1306_send_data(ssd1306_t *display, uint8_t *data, size_t len)
+static bool ssd1306_set_window(ssd1306_t *display, uint8_t col_start, uint8_t col_end,
+                               uint8_t page_start, uint8_t page_end)
 {
-    uint8_t *buf = malloc(len + 1);
-    buf[0] = 0x40; // Data mode
-    memcpy(buf + 1, data, len);
-    i2c_write_blocking(display->i2c_port, display->address, buf, len + 1, false);
-    free(buf);
+    const uint8_t cmds[] = {SSD1306_SET_COLUMN_ADDR, col_start, col_end,
+                            SSD1306_SET_PAGE_ADDR, page_start, page_end};
+    return ssd1306_send_cmds(display, cmds, sizeof(cmds));
 }
 
 // Initialize SSD1306 display
-bool ssd1306_init(ssd1306_t *display, i2c_inst_t *i2c_port, uint8_t address)
+bool ssd1306_init(ssd1306_t *display, uint8_t address)
 {
-    display->i2c_port = i2c_port;
-    display->address = address;
+    i2c_bus_init();
+    i2c_bus_device_init(&display->dev, address, SSD1306_I2C_MAX_HZ);
     display->width = SSD1306_WIDTH;
     display->height = SSD1306_HEIGHT;
+#if SSD1306_DOUBLE_BUFFER
+    display->frames[0][0] = SSD1306_CTRL_DATA;
+    display->frames[1][0] = SSD1306_CTRL_DATA;
+    display->buffer = &display->frames[0][1];
+    display->front = &display->frames[1][1];
+    memset(display->front, 0, SSD1306_BUFFER_SIZE);
+#else
+    display->data_ctrl = SSD1306_CTRL_DATA;
+#endif
 
     // Clear buffer
-    memset(display->buffer, 0, sizeof(display->buffer));
-
-    // Initialization sequence
-    ssd1306_send_cmd(display, SSD1306_DISPLAY_OFF);
-    ssd1306_send_cmd(display, SSD1306_SET_DISPLAY_CLOCK_DIV);
-    ssd1306_send_cmd(display, 0x80);
-    ssd1306_send_cmd(display, SSD1306_SET_MULTIPLEX);
-    ssd1306_send_cmd(display, SSD1306_HEIGHT - 1);
-    ssd1306_send_cmd(display, SSD1306_SET_DISPLAY_OFFSET);
-    ssd1306_send_cmd(display, 0x00);
-    ssd1306_send_cmd(display, SSD1306_SET_START_LINE | 0x00);
-    ssd1306_send_cmd(display, SSD1306_CHARGE_PUMP);
-    ssd1306_send_cmd(display, 0x14);
-    ssd1306_send_cmd(display, SSD1306_MEMORY_ADDR_MODE);
-    ssd1306_send_cmd(display, 0x00);
-    ssd1306_send_cmd(display, SSD1306_SEG_REMAP | 0x01);
-    ssd1306_send_cmd(display, SSD1306_COM_SCAN_DEC);
-    ssd1306_send_cmd(display, SSD1306_SET_COM_PINS);
-    ssd1306_send_cmd(display, 0x12);
-    ssd1306_send_cmd(display, SSD1306_SET_CONTRAST);
-    ssd1306_send_cmd(display, 0xCF);
-    ssd1306_send_cmd(display, SSD1306_SET_PRECHARGE);
-    ssd1306_send_cmd(display, 0xF1);
-    ssd1306_send_cmd(display, SSD1306_SET_VCOM_DETECT);
-    ssd1306_send_cmd(display, 0x40);
-    ssd1306_send_cmd(display, SSD1306_DISPLAY_ALL_ON_RESUME);
-    ssd1306_send_cmd(display, SSD1306_NORMAL_DISPLAY);
-    ssd1306_send_cmd(display, SSD1306_DISPLAY_ON);
+    memset(display->buffer, 0, SSD1306_BUFFER_SIZE);
 
-    return true;
+    // GDDRAM tem conteúdo indefinido após o power-up: o primeiro quadro é completo
+    display->shadow_valid = false;
+    display->bytes_sent = 0;
+    display->bytes_saved = 0;
+    display->total_bytes_saved = 0;
+
+    // Initialization sequence (enviada numa única transação)
+    static const uint8_t init_seq[] = {
+        SSD1306_DISPLAY_OFF,
+        SSD1306_SET_DISPLAY_CLOCK_DIV, 0x80,
+        SSD1306_SET_MULTIPLEX, SSD1306_HEIGHT - 1,
+        SSD1306_SET_DISPLAY_OFFSET, 0x00,
+        SSD1306_SET_START_LINE | 0x00,
+        SSD1306_CHARGE_PUMP, 0x14,
+        SSD1306_MEMORY_ADDR_MODE, 0x00,
+        SSD1306_SEG_REMAP | 0x01,
+        SSD1306_COM_SCAN_DEC,
+        SSD1306_SET_COM_PINS, 0x12,
+        SSD1306_SET_CONTRAST, 0xCF,
+        SSD1306_SET_PRECHARGE, 0xF1,
+        SSD1306_SET_VCOM_DETECT, 0x40,
+        SSD1306_DISPLAY_ALL_ON_RESUME,
+        SSD1306_NORMAL_DISPLAY,
+        SSD1306_DISPLAY_ON,
+    };
+
+    return ssd1306_send_cmds(display, init_seq, sizeof(init_seq));
 }
 
 // Clear the display buffer
 void ssd1306_clear(ssd1306_t *display)
 {
-    memset(display->buffer, 0, sizeof(display->buffer));
+    memset(display->buffer, 0, SSD1306_BUFFER_SIZE);
 }
 
-// Send buffer to display
+/**
+ * @brief Trecho retangular da GDDRAM que precisa ser enviado ao painel
+ */
+typedef struct
+{
+    uint8_t col_start;  ///< Primeira coluna da janela
+    uint8_t col_end;    ///< Última coluna da janela
+    uint8_t page_start; ///< Primeira página da janela
+    uint8_t page_end;   ///< Última página da janela
+    uint8_t *data;      ///< Início dos dados dentro de display->buffer
+    uint16_t len;       ///< Número de bytes de dados
+} ssd1306_span_t;
+
+/**
+ * @brief Compara o buffer com o conteúdo do painel e levanta os trechos alterados
+ *
+ * Também atualiza as estatísticas de bytes enviados/poupados. Os trechos
+ * apontam para display->buffer e devem ser confirmados com
+ * ssd1306_commit_spans() depois de enviados (ou copiados para envio).
+ *
+ * @param display Ponteiro para a estrutura do display
+ * @param spans Vetor com espaço para SSD1306_PAGES trechos
+ * @return Número de trechos a enviar
+ */
+static uint8_t ssd1306_collect_spans(ssd1306_t *display, ssd1306_span_t *spans)
+{
+    uint8_t count = 0;
+    uint16_t sent = 0;
+
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++)
+    {
+        uint8_t *row = &display->buffer[page * display->width];
+        uint8_t first = 0;
+        uint8_t last = display->width - 1;
+
+        // Estado do painel desconhecido: a página vai inteira. Mesmo assim um
+        // trecho por página, para que o envio assíncrono continue cedendo o
+        // barramento entre páginas
+        if (display->shadow_valid)
+        {
+            uint8_t *front_row = &SSD1306_FRONT(display)[page * display->width];
+
+            // Procura a primeira e a última coluna alteradas da página
+            while (first < display->width && row[first] == front_row[first])
+                first++;
+            if (first == display->width)
+                continue; // Página sem alterações
+
+            while (row[last] == front_row[last])
+                last--;
+        }
+
+        uint8_t len = last - first + 1;
+        spans[count++] = (ssd1306_span_t){first, last, page, page, &row[first], len};
+        sent += len;
+    }
+
+    display->bytes_sent = sent;
+    display->bytes_saved = SSD1306_BUFFER_SIZE - sent;
+    display->total_bytes_saved += display->bytes_saved;
+    return count;
+}
+
+/**
+ * @brief Registra que os trechos coletados passaram a ser o conteúdo do painel
+ *
+ * Com buffer simples, copia os trechos para a cópia sombra. Com buffer duplo,
+ * troca back e front buffer por ponteiro e leva os mesmos trechos para o novo
+ * back buffer, que assim continua igual ao quadro exibido (necessário para
+ * quem redesenha apenas partes da tela, como a camada ssd1306_ui).
+ *
+ * @param display Ponteiro para a estrutura do display
+ * @param spans Trechos retornados por ssd1306_collect_spans()
+ * @param count Número de trechos
+ */
+static void ssd1306_commit_spans(ssd1306_t *display, const ssd1306_span_t *spans, uint8_t count)
+{
+    uint8_t *drawn = display->buffer;
+#if SSD1306_DOUBLE_BUFFER
+    display->buffer = display->front;
+    display->front = drawn;
+    uint8_t *stale = display->buffer;
+#else
+    uint8_t *stale = display->shadow;
+#endif
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint16_t offset = spans[i].data - drawn;
+        memcpy(&stale[offset], &drawn[offset], spans[i].len);
+    }
+    display->shadow_valid = true;
+}
+
+// Send buffer to display (only the spans that differ from what the panel shows)
 void ssd1306_display(ssd1306_t *display)
 {
-    ssd1306_send_cmd(display, SSD1306_SET_COLUMN_ADDR);
-    ssd1306_send_cmd(display, 0);
-    ssd1306_send_cmd(display, display->width - 1);
-    ssd1306_send_cmd(display, SSD1306_SET_PAGE_ADDR);
-    ssd1306_send_cmd(display, 0);
-    ssd1306_send_cmd(display, SSD1306_PAGES - 1);
-
-    ssd1306_send_data(display, display->buffer, sizeof(display->buffer));
+    ssd1306_span_t spans[SSD1306_PAGES];
+
+    ssd1306_flush_wait(display);
+    uint8_t count = ssd1306_collect_spans(display, spans);
+    bool ok = true;
+    for (uint8_t i = 0; i < count && ok; i++)
+    {
+        ok = ssd1306_set_window(display, spans[i].col_start, spans[i].col_end,
+                                spans[i].page_start, spans[i].page_end) &&
+             ssd1306_send_data(display, spans[i].data, spans[i].len);
+    }
+    ssd1306_commit_spans(display, spans, count);
+    // Numa falha o conteúdo da GDDRAM deixa de ser conhecido: o próximo quadro vai inteiro
+    if (!ok)
+        display->shadow_valid = false;
+}
+
+/*
+ * Envio assíncrono pela fila do barramento (i2c_bus.h).
+ *
+ * O IC_DATA_CMD do RP2040 recebe o bit de STOP no bit 9 e escritas de 8 bits
+ * são replicadas no barramento, então o DMA precisa escrever palavras de 16
+ * bits. Cada trecho alterado é codificado como comandos de janela + dados, com
+ * STOP ao fim de cada transação, e vira uma transação de prioridade BULK na
+ * fila. Entre um trecho e outro o motor pode atender transações mais urgentes
+ * (botões, sensores), que esperam no máximo uma página em vez do quadro todo.
+ * Como o quadro é copiado para essas sequências no início, o buffer pode ser
+ * redesenhado logo em seguida.
+ */
+#define SSD1306_ASYNC_MAX_WORDS (SSD1306_PAGES * (8 + SSD1306_WIDTH)) ///< Pior caso: 8 trechos de página inteira
+
+static uint16_t async_words[SSD1306_ASYNC_MAX_WORDS]; ///< Sequências transmitidas pelo DMA
+static i2c_txn_t async_txns[SSD1306_PAGES];           ///< Uma transação por trecho
+static ssd1306_t *volatile async_display = NULL;      ///< Display com envio em andamento
+static ssd1306_flush_cb_t async_callback = NULL;      ///< Callback do envio em andamento
+static volatile uint8_t async_remaining = 0;          ///< Trechos ainda na fila
+static volatile bool async_failed = false;            ///< Algum trecho foi abortado
+
+/**
+ * @brief Fim de um trecho (IRQ do I2C); o último encerra o envio e notifica
+ *
+ * @param ok false se o trecho foi abortado (ex.: NACK)
+ */
+static void ssd1306_async_span_done(i2c_txn_t *txn, bool ok)
+{
+    (void)txn;
+    if (!ok)
+        async_failed = true;
+    if (--async_remaining > 0)
+        return;
+
+    ssd1306_t *display = async_display;
+    // Após um abort o conteúdo da GDDRAM deixa de ser conhecido
+    if (async_failed)
+        display->shadow_valid = false;
+
+    ssd1306_flush_cb_t cb = async_callback;
+    async_callback = NULL;
+    async_display = NULL;
+    if (cb)
+        cb(display, !async_failed);
+}
+
+/**
+ * @brief Codifica uma transação I2C (controle + bytes) em palavras de IC_DATA_CMD
+ *
+ * @return Próxima posição livre na sequência
+ */
+static uint16_t *ssd1306_encode_txn(uint16_t *out, uint8_t ctrl, const uint8_t *bytes, size_t len)
+{
+    *out++ = ctrl;
+    for (size_t i = 0; i < len; i++)
+        *out++ = bytes[i];
+    out[-1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    return out;
+}
+
+// Queue the changed spans as background bus transactions
+bool ssd1306_display_async(ssd1306_t *display, ssd1306_flush_cb_t callback)
+{
+    if (async_display)
+        return false; // Já existe um envio em andamento
+
+    ssd1306_span_t spans[SSD1306_PAGES];
+    uint8_t count = ssd1306_collect_spans(display, spans);
+    if (count == 0)
+    {
+        if (callback)
+            callback(display, true);
+        return true;
+    }
+
+    async_display = display;
+    async_callback = callback;
+    async_failed = false;
+    async_remaining = count;
+
+    uint16_t *out = async_words;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const uint8_t window[6] = {SSD1306_SET_COLUMN_ADDR, spans[i].col_start, spans[i].col_end,
+                                   SSD1306_SET_PAGE_ADDR, spans[i].page_start, spans[i].page_end};
+        uint16_t *start = out;
+        out = ssd1306_encode_txn(out, 0x00, window, sizeof(window));
+        out = ssd1306_encode_txn(out, SSD1306_CTRL_DATA, spans[i].data, spans[i].len);
+
+        async_txns[i] = (i2c_txn_t){
+            .dev = &display->dev,
+            .words = start,
+            .word_count = (uint16_t)(out - start),
+            .prio = I2C_BUS_PRIO_BULK,
+            .callback = ssd1306_async_span_done,
+        };
+    }
+    ssd1306_commit_spans(display, spans, count);
+
+    for (uint8_t i = 0; i < count; i++)
+        i2c_bus_submit(&async_txns[i]);
+    return true;
+}
+
+// Check whether a flush is still on the bus
+bool ssd1306_flush_busy(const ssd1306_t *display)
+{
+    return async_display == display;
+}
+
+// Block until the pending flush (if any) completes
+void ssd1306_flush_wait(ssd1306_t *display)
+{
+    while (ssd1306_flush_busy(display))
+    {
+        i2c_bus_service(); // um trecho com prazo vencido para a fila até a liberação
+        tight_loop_contents();
+    }
+}
+
+// Force a full refresh on the next ssd1306_display()
+void ssd1306_invalidate(ssd1306_t *display)
+{
+    display->shadow_valid = false;
 }
 
 // Set a pixel
@@ -225,24 +495,38 @@ void ssd1306_set_pixel(ssd1306_t *display, uint8_t x, uint8_t y, bool on)
     }
 }
 
-// Draw a character
+// Draw a character (whole font columns ORed into the page-organized buffer)
 void ssd1306_draw_char(ssd1306_t *display, uint8_t x, uint8_t y, char c)
 {
     if (c < 32 || c > 126)
         return; // Only printable ASCII
+    if (x >= display->width || y >= display->height)
+        return;
 
     const uint8_t *font_char = font5x8[c - 32];
+    uint8_t cols = display->width - x;
+    if (cols > 5)
+        cols = 5;
+
+    uint8_t page = y / 8;
+    uint8_t shift = y % 8;
+    uint8_t *dst = &display->buffer[page * display->width + x];
 
-    for (int i = 0; i < 5; i++)
+    if (shift == 0)
     {
-        uint8_t line = font_char[i];
-        for (int j = 0; j < 8; j++)
-        {
-            if (line & (1 << j))
-            {
-                ssd1306_set_pixel(display, x + i, y + j, true);
-            }
-        }
+        // Caminho rápido: glifo alinhado à página, um OR por coluna
+        for (uint8_t i = 0; i < cols; i++)
+            dst[i] |= font_char[i];
+        return;
+    }
+
+    // Glifo desalinhado: cada coluna se divide entre a página atual e a seguinte
+    uint8_t *next = (page + 1 < SSD1306_PAGES) ? dst + display->width : NULL;
+    for (uint8_t i = 0; i < cols; i++)
+    {
+        dst[i] |= (uint8_t)(font_char[i] << shift);
+        if (next)
+            next[i] |= font_char[i] >> (8 - shift);
     }
 }
 
@@ -257,14 +541,41 @@ void ssd1306_draw_string(ssd1306_t *display, uint8_t x, uint8_t y, const char *s
     }
 }
 
-// Fill rectangle
+// Fill rectangle (one bitmask per page, memset for fully covered pages)
 void ssd1306_fill_rect(ssd1306_t *display, uint8_t x, uint8_t y, uint8_t w, uint8_t h, bool on)
 {
-    for (uint8_t i = 0; i < w; i++)
+    if (x >= display->width || y >= display->height || w == 0 || h == 0)
+        return;
+
+    uint16_t x_end = x + w;
+    uint16_t y_end = y + h;
+    if (x_end > display->width)
+        x_end = display->width;
+    if (y_end > display->height)
+        y_end = display->height;
+    uint8_t span = x_end - x;
+
+    for (uint8_t page = y / 8; page * 8 < y_end; page++)
     {
-        for (uint8_t j = 0; j < h; j++)
+        // Linhas da página cobertas pelo retângulo
+        uint8_t top = (y > page * 8) ? y - page * 8 : 0;
+        uint8_t bottom = (y_end < page * 8 + 8) ? y_end - page * 8 : 8;
+        uint8_t mask = (uint8_t)((0xFF << top) & (0xFF >> (8 - bottom)));
+        uint8_t *dst = &display->buffer[page * display->width + x];
+
+        if (mask == 0xFF)
+        {
+            memset(dst, on ? 0xFF : 0x00, span);
+        }
+        else if (on)
         {
-            ssd1306_set_pixel(display, x + i, y + j, on);
+            for (uint8_t i = 0; i < span; i++)
+                dst[i] |= mask;
+        }
+        else
+        {
+            for (uint8_t i = 0; i < span; i++)
+                dst[i] &= (uint8_t)~mask;
         }
     }
-}
\ No newline at end of file
+}
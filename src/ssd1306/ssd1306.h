@@ -14,6 +14,7 @@
 
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "i2c_bus.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -21,9 +22,27 @@
 #define SSD1306_WIDTH  128  ///< Largura do display em pixels
 #define SSD1306_HEIGHT 64   ///< Altura do display em pixels
 #define SSD1306_PAGES  (SSD1306_HEIGHT / 8) ///< Número de páginas (cada página tem 8 linhas)
+#define SSD1306_BUFFER_SIZE (SSD1306_WIDTH * SSD1306_PAGES) ///< Tamanho de um framebuffer em bytes
+
+/**
+ * @brief Modo de buffer duplo (opcional, definir como 1 na compilação)
+ *
+ * Com 1, o display ganha um back buffer (desenho) e um front buffer (conteúdo
+ * já enviado ao painel) trocados por ponteiro em O(1) a cada quadro. O front
+ * buffer ocupa o lugar da cópia sombra usada pela atualização parcial.
+ */
+#ifndef SSD1306_DOUBLE_BUFFER
+#define SSD1306_DOUBLE_BUFFER 0
+#endif
+
+/// Máximo de bytes de comando enviados numa única transação por ssd1306_send_cmds()
+#define SSD1306_MAX_CMD_BATCH 32
 
 /// Endereço I2C padrão do display SSD1306
 #define SSD1306_I2C_ADDR 0x3C
+#ifndef SSD1306_I2C_MAX_HZ
+#define SSD1306_I2C_MAX_HZ I2C_BUS_FAST_PLUS_HZ ///< Clock usado nas transferências do display (FM+)
+#endif
 
 // Command definitions
 #define SSD1306_SET_CONTRAST 0x81          ///< Define o contraste do display
@@ -54,25 +73,63 @@
  * @brief Estrutura principal do display SSD1306
  * 
  * Esta estrutura contém todo o estado necessário para controlar o display,
- * incluindo a configuração de hardware e o buffer de frame.
+ * incluindo a configuração de hardware e o buffer de frame. O byte de controle
+ * 0x40 antecede cada framebuffer para que o frame siga para o I2C sem cópia
+ * nem alocação.
  */
 typedef struct {
-    i2c_inst_t *i2c_port;  ///< Ponteiro para a instância I2C (i2c0 ou i2c1)
-    uint8_t address;       ///< Endereço I2C do dispositivo
+    i2c_bus_device_t dev;  ///< Endereço e clock máximo no barramento compartilhado
     uint8_t width;         ///< Largura do display em pixels
     uint8_t height;        ///< Altura do display em pixels
-    uint8_t buffer[SSD1306_WIDTH * SSD1306_PAGES]; ///< Buffer de frame (128x64 pixels)
+#if SSD1306_DOUBLE_BUFFER
+    uint8_t *buffer;       ///< Back buffer: onde as funções de desenho escrevem
+    uint8_t *front;        ///< Front buffer: conteúdo presente na GDDRAM do painel
+    uint8_t frames[2][SSD1306_BUFFER_SIZE + 1]; ///< Framebuffers, cada um precedido do byte de controle 0x40
+#else
+    uint8_t data_ctrl;     ///< Byte de controle 0x40 (dados), deve ficar imediatamente antes de buffer[]
+    uint8_t buffer[SSD1306_BUFFER_SIZE]; ///< Buffer de frame (128x64 pixels)
+    uint8_t shadow[SSD1306_BUFFER_SIZE]; ///< Cópia do que já está na GDDRAM do painel
+#endif
+    bool shadow_valid;          ///< false força o envio do frame completo no próximo ssd1306_display()
+    uint16_t bytes_sent;        ///< Bytes de dados enviados no último ssd1306_display()
+    uint16_t bytes_saved;       ///< Bytes de dados poupados no último ssd1306_display()
+    uint32_t total_bytes_saved; ///< Total acumulado de bytes poupados desde a inicialização
 } ssd1306_t;
 
+/**
+ * @brief Callback chamado ao fim de um envio assíncrono
+ *
+ * Executado em contexto de interrupção (IRQ do I2C).
+ *
+ * @param display Display cujo envio terminou
+ * @param ok false se a transferência foi abortada pelo barramento
+ */
+typedef void (*ssd1306_flush_cb_t)(ssd1306_t *display, bool ok);
+
 /**
  * @brief Inicializa o display SSD1306
  * 
  * @param display Ponteiro para a estrutura do display
- * @param i2c_port Ponteiro para a instância I2C (i2c0 ou i2c1)
+ * O display é registrado no gerenciador do barramento (i2c_bus.h) com clock
+ * máximo SSD1306_I2C_MAX_HZ.
+ *
  * @param address Endereço I2C do display (geralmente 0x3C ou 0x3D)
  * @return true se a inicialização foi bem-sucedida, false caso contrário
  */
-bool ssd1306_init(ssd1306_t *display, i2c_inst_t *i2c_port, uint8_t address);
+bool ssd1306_init(ssd1306_t *display, uint8_t address);
+
+/**
+ * @brief Envia uma sequência de comandos numa única transação I2C
+ *
+ * Todos os bytes seguem após um único byte de controle 0x00, evitando o
+ * START/endereço/STOP de cada comando isolado.
+ *
+ * @param display Ponteiro para a estrutura do display
+ * @param cmds Comandos (e seus argumentos) a serem enviados
+ * @param len Número de bytes (1 a SSD1306_MAX_CMD_BATCH)
+ * @return true se todos os bytes foram aceitos pelo display
+ */
+bool ssd1306_send_cmds(ssd1306_t *display, const uint8_t *cmds, size_t len);
 
 /**
  * @brief Limpa o buffer do display (não atualiza o display físico)
@@ -83,11 +140,55 @@ void ssd1306_clear(ssd1306_t *display);
 
 /**
  * @brief Atualiza o display físico com o conteúdo do buffer
+ *
+ * Compara o buffer com a cópia sombra do painel e envia, para cada página,
+ * apenas a faixa de colunas que mudou. Os campos bytes_sent/bytes_saved
+ * registram o resultado do último quadro. No modo SSD1306_DOUBLE_BUFFER a
+ * comparação é entre back e front buffer, que são trocados ao final.
  * 
  * @param display Ponteiro para a estrutura do display inicializada
  */
 void ssd1306_display(ssd1306_t *display);
 
+/**
+ * @brief Inicia o envio do buffer ao display via DMA, sem bloquear
+ *
+ * Os trechos alterados são copiados para a sequência de transmissão antes do
+ * retorno, então o buffer pode ser redesenhado imediatamente. Cada trecho vira
+ * uma transação de prioridade I2C_BUS_PRIO_BULK na fila do barramento: as
+ * transações dos demais dispositivos passam à frente entre um trecho e outro.
+ * As funções síncronas deste driver aguardam o término do envio.
+ *
+ * @param display Ponteiro para a estrutura do display inicializada
+ * @param callback Função chamada ao término (pode ser NULL)
+ * @return false se já havia um envio em andamento
+ */
+bool ssd1306_display_async(ssd1306_t *display, ssd1306_flush_cb_t callback);
+
+/**
+ * @brief Indica se ainda há um envio assíncrono em andamento
+ *
+ * @param display Ponteiro para a estrutura do display inicializada
+ * @return true enquanto o quadro estiver sendo transmitido
+ */
+bool ssd1306_flush_busy(const ssd1306_t *display);
+
+/**
+ * @brief Aguarda o término do envio assíncrono em andamento (se houver)
+ *
+ * @param display Ponteiro para a estrutura do display inicializada
+ */
+void ssd1306_flush_wait(ssd1306_t *display);
+
+/**
+ * @brief Descarta a cópia sombra e força o envio completo no próximo quadro
+ *
+ * Útil quando o conteúdo da GDDRAM deixa de ser conhecido (ex.: reset do painel).
+ *
+ * @param display Ponteiro para a estrutura do display inicializada
+ */
+void ssd1306_invalidate(ssd1306_t *display);
+
 /**
  * @brief Define o estado de um pixel no buffer
  * 
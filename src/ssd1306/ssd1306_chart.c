@@ -0,0 +1,208 @@
+/**
+ * @file ssd1306_chart.c
+ * @brief Implementação do gráfico de série temporal
+ *
+ * Este arquivo contém a implementação das funções declaradas em ssd1306_chart.h
+ */
+
+#include "ssd1306_chart.h"
+
+/**
+ * @brief Recalcula a escala a partir do mínimo/máximo das amostras
+ *
+ * @return true se a escala mudou
+ */
+static bool chart_update_scale(ssd1306_chart_t *chart)
+{
+    int32_t lo = chart->data_min;
+    int32_t hi = chart->data_max;
+
+    // Abre a faixa em torno do centro quando ela é menor que min_span
+    if ((int64_t)hi - lo < chart->min_span)
+    {
+        int32_t mid = lo + (hi - lo) / 2;
+        lo = mid - chart->min_span / 2;
+        hi = lo + chart->min_span;
+    }
+
+    if (lo == chart->scale_lo && hi == chart->scale_hi)
+        return false;
+    chart->scale_lo = lo;
+    chart->scale_hi = hi;
+    return true;
+}
+
+/**
+ * @brief Percorre o histórico para achar mínimo e máximo
+ *
+ * Só é chamada quando a amostra descartada era um dos extremos.
+ */
+static void chart_rescan(ssd1306_chart_t *chart)
+{
+    int32_t lo = INT32_MAX, hi = INT32_MIN;
+    for (uint8_t i = 0; i < chart->count; i++)
+    {
+        int32_t v = chart->samples[(chart->head + i) % chart->w];
+        if (v < lo)
+            lo = v;
+        if (v > hi)
+            hi = v;
+    }
+    chart->data_min = lo;
+    chart->data_max = hi;
+}
+
+/**
+ * @brief Desenha a barra de uma coluna do gráfico
+ *
+ * @param display Display de destino
+ * @param chart Gráfico
+ * @param col Coluna relativa à área (0 = mais à esquerda)
+ * @param has_sample false deixa a coluna vazia
+ * @param sample Valor a representar
+ */
+static void chart_draw_column(ssd1306_t *display, const ssd1306_chart_t *chart, uint8_t col,
+                              bool has_sample, int32_t sample)
+{
+    uint16_t height = chart->pages * 8;
+    uint16_t level = 0;
+
+    if (has_sample)
+    {
+        // Altura da barra em pixels, ao menos 1 para o mínimo continuar visível
+        int64_t span = (int64_t)chart->scale_hi - chart->scale_lo;
+        int64_t offset = (int64_t)sample - chart->scale_lo;
+        level = 1 + (uint16_t)((offset * (height - 1)) / span);
+    }
+
+    uint16_t start = height - level; // Primeira linha acesa, contada do topo da área
+    uint8_t *dst = &display->buffer[chart->page * display->width + chart->x + col];
+    for (uint8_t p = 0; p < chart->pages; p++, dst += display->width)
+    {
+        uint16_t top = p * 8;
+        if (start <= top)
+            *dst = 0xFF;
+        else if (start >= top + 8)
+            *dst = 0x00;
+        else
+            *dst = (uint8_t)(0xFF << (start - top));
+    }
+}
+
+void ssd1306_chart_init(ssd1306_chart_t *chart, uint8_t x, uint8_t page, uint8_t w, uint8_t pages,
+                        int32_t min_span)
+{
+    if (w > SSD1306_CHART_MAX_POINTS)
+        w = SSD1306_CHART_MAX_POINTS;
+    if (x + w > SSD1306_WIDTH)
+        w = SSD1306_WIDTH - x;
+    if (page + pages > SSD1306_PAGES)
+        pages = SSD1306_PAGES - page;
+
+    chart->x = x;
+    chart->page = page;
+    chart->w = w;
+    chart->pages = pages;
+    chart->min_span = min_span > 0 ? min_span : 1;
+    chart->head = 0;
+    chart->count = 0;
+    chart->data_min = 0;
+    chart->data_max = 0;
+    chart->scale_lo = 0;
+    chart->scale_hi = chart->min_span;
+    chart->pending = 0;
+    chart->full_redraw = true;
+}
+
+void ssd1306_chart_push(ssd1306_chart_t *chart, int32_t sample)
+{
+    if (chart->w == 0)
+        return;
+
+    bool rescan = false;
+    if (chart->count == chart->w)
+    {
+        // Descarta a mais antiga; se era um extremo, mínimo/máximo precisam ser refeitos
+        int32_t evicted = chart->samples[chart->head];
+        rescan = evicted == chart->data_min || evicted == chart->data_max;
+        chart->samples[chart->head] = sample;
+        chart->head = (chart->head + 1) % chart->w;
+    }
+    else
+    {
+        chart->samples[(chart->head + chart->count) % chart->w] = sample;
+        chart->count++;
+    }
+
+    if (rescan)
+    {
+        chart_rescan(chart);
+    }
+    else if (chart->count == 1)
+    {
+        chart->data_min = sample;
+        chart->data_max = sample;
+    }
+    else
+    {
+        if (sample < chart->data_min)
+            chart->data_min = sample;
+        if (sample > chart->data_max)
+            chart->data_max = sample;
+    }
+
+    if (chart_update_scale(chart))
+        chart->full_redraw = true;
+    if (chart->pending < chart->w)
+        chart->pending++;
+}
+
+void ssd1306_chart_draw(ssd1306_t *display, ssd1306_chart_t *chart)
+{
+    uint8_t w = chart->w;
+    uint8_t shift = chart->pending;
+    chart->pending = 0;
+
+    if (w == 0 || chart->pages == 0)
+        return;
+
+    // Amostra mais recente fica na última coluna; colunas sem histórico ficam vazias
+    uint8_t empty = w - chart->count;
+    uint8_t first_col = 0;
+
+    if (chart->full_redraw || shift >= w)
+    {
+        chart->full_redraw = false;
+    }
+    else
+    {
+        if (shift == 0)
+            return;
+
+        // Rolagem incremental: desloca cada página e desenha só as colunas novas
+        for (uint8_t p = 0; p < chart->pages; p++)
+        {
+            uint8_t *row = &display->buffer[(chart->page + p) * display->width + chart->x];
+            memmove(row, row + shift, w - shift);
+        }
+        first_col = w - shift;
+    }
+
+    for (uint8_t col = first_col; col < w; col++)
+    {
+        if (col < empty)
+        {
+            chart_draw_column(display, chart, col, false, 0);
+        }
+        else
+        {
+            uint8_t idx = (chart->head + (col - empty)) % w;
+            chart_draw_column(display, chart, col, true, chart->samples[idx]);
+        }
+    }
+}
+
+void ssd1306_chart_invalidate(ssd1306_chart_t *chart)
+{
+    chart->full_redraw = true;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file ssd1306_chart.h
+ * @brief Gráfico de série temporal com rolagem para o driver SSD1306
+ *
+ * As amostras ficam num buffer circular de tamanho fixo e cada coluna do
+ * gráfico é uma barra vertical escrita diretamente nos bytes das páginas.
+ * Enquanto a escala (mínimo/máximo automáticos) não muda, uma nova amostra
+ * apenas desloca a área do gráfico uma coluna para a esquerda e desenha a
+ * coluna nova; o replote completo só acontece quando a escala muda.
+ */
+
+#ifndef SSD1306_CHART_H
+#define SSD1306_CHART_H
+
+#include "ssd1306.h"
+
+#define SSD1306_CHART_MAX_POINTS SSD1306_WIDTH ///< Capacidade do histórico (uma amostra por coluna)
+
+/**
+ * @brief Estado de um gráfico
+ *
+ * A área ocupa colunas [x, x + w) e páginas [page, page + pages).
+ */
+typedef struct {
+    uint8_t x;         ///< Primeira coluna da área do gráfico
+    uint8_t page;      ///< Primeira página da área do gráfico
+    uint8_t w;         ///< Largura em colunas (= amostras visíveis, até SSD1306_CHART_MAX_POINTS)
+    uint8_t pages;     ///< Altura em páginas (8 pixels cada)
+    int32_t min_span;  ///< Faixa mínima da escala, evita ampliar ruído em sinais estáveis
+    int32_t samples[SSD1306_CHART_MAX_POINTS]; ///< Buffer circular de amostras
+    uint8_t head;      ///< Índice da amostra mais antiga
+    uint8_t count;     ///< Número de amostras armazenadas (até w)
+    int32_t data_min;  ///< Menor amostra armazenada
+    int32_t data_max;  ///< Maior amostra armazenada
+    int32_t scale_lo;  ///< Valor correspondente à base do gráfico
+    int32_t scale_hi;  ///< Valor correspondente ao topo do gráfico
+    uint8_t pending;   ///< Amostras recebidas desde o último desenho
+    bool full_redraw;  ///< true se a escala mudou ou a área precisa ser replotada
+} ssd1306_chart_t;
+
+/**
+ * @brief Inicializa um gráfico vazio
+ *
+ * @param chart Gráfico a inicializar
+ * @param x Primeira coluna da área
+ * @param page Primeira página da área (y = page * 8)
+ * @param w Largura em colunas (limitada a SSD1306_CHART_MAX_POINTS e à borda do display)
+ * @param pages Altura em páginas
+ * @param min_span Faixa mínima da escala, na unidade das amostras
+ */
+void ssd1306_chart_init(ssd1306_chart_t *chart, uint8_t x, uint8_t page, uint8_t w, uint8_t pages,
+                        int32_t min_span);
+
+/**
+ * @brief Acrescenta uma amostra ao histórico (não desenha)
+ *
+ * Quando o histórico está cheio, a amostra mais antiga é descartada.
+ *
+ * @param chart Gráfico inicializado
+ * @param sample Nova amostra
+ */
+void ssd1306_chart_push(ssd1306_chart_t *chart, int32_t sample);
+
+/**
+ * @brief Atualiza a área do gráfico no buffer do display
+ *
+ * Desloca a área pelo número de amostras recebidas desde o último desenho e
+ * desenha só as colunas novas; replota tudo se a escala mudou.
+ *
+ * @param display Ponteiro para a estrutura do display inicializada
+ * @param chart Gráfico inicializado
+ */
+void ssd1306_chart_draw(ssd1306_t *display, ssd1306_chart_t *chart);
+
+/**
+ * @brief Força o replote completo no próximo ssd1306_chart_draw()
+ *
+ * Necessário quando a área do gráfico foi apagada (ex.: troca de painel).
+ *
+ * @param chart Gráfico inicializado
+ */
+void ssd1306_chart_invalidate(ssd1306_chart_t *chart);
+
+#endif // SSD1306_CHART_H
@@ -0,0 +1,45 @@
+/**
+ * @file ssd1306_ui.c
+ * @brief Implementação da camada de UI em modo retido
+ *
+ * Este arquivo contém a implementação das funções declaradas em ssd1306_ui.h
+ */
+
+#include "ssd1306_ui.h"
+
+// Draw the static template once and reset the fields
+void ssd1306_ui_panel_show(ssd1306_t *display, ssd1306_ui_panel_t *panel)
+{
+    ssd1306_clear(display);
+
+    for (uint8_t i = 0; i < panel->item_count; i++)
+    {
+        const ssd1306_ui_static_t *item = &panel->items[i];
+        if (item->kind == SSD1306_UI_RULE)
+            ssd1306_fill_rect(display, item->x, item->y, item->w, 1, true);
+        else
+            ssd1306_draw_string(display, item->x, item->y, item->text);
+    }
+
+    for (uint8_t i = 0; i < panel->field_count; i++)
+        panel->fields[i].text[0] = '\0';
+}
+
+// Redraw a field box only when its text changes
+bool ssd1306_ui_field_set(ssd1306_t *display, ssd1306_ui_field_t *field, const char *text)
+{
+    uint8_t max_chars = field->max_chars;
+    if (max_chars > SSD1306_UI_FIELD_MAX_CHARS)
+        max_chars = SSD1306_UI_FIELD_MAX_CHARS;
+
+    if (strncmp(field->text, text, max_chars) == 0)
+        return false;
+
+    strncpy(field->text, text, max_chars);
+    field->text[max_chars] = '\0';
+
+    ssd1306_fill_rect(display, field->x, field->y, max_chars * SSD1306_UI_CHAR_WIDTH,
+                      SSD1306_UI_CHAR_HEIGHT, false);
+    ssd1306_draw_string(display, field->x, field->y, field->text);
+    return true;
+}
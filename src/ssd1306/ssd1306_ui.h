@@ -0,0 +1,82 @@
+/**
+ * @file ssd1306_ui.h
+ * @brief Camada de UI em modo retido sobre o driver SSD1306
+ *
+ * Um painel é formado por um modelo estático (títulos, rótulos e linhas),
+ * desenhado uma única vez ao exibir o painel, e por campos de valor com
+ * tamanho fixo. Atualizar um campo só redesenha a sua caixa, e apenas quando
+ * o texto muda; a atualização parcial do ssd1306_display() envia só esses bytes.
+ */
+
+#ifndef SSD1306_UI_H
+#define SSD1306_UI_H
+
+#include "ssd1306.h"
+
+#define SSD1306_UI_FIELD_MAX_CHARS 16 ///< Capacidade máxima de texto de um campo
+#define SSD1306_UI_CHAR_WIDTH 6       ///< Largura de um caractere (5 pixels + 1 espaço)
+#define SSD1306_UI_CHAR_HEIGHT 8      ///< Altura de um caractere em pixels
+
+/**
+ * @brief Tipos de elementos estáticos de um painel
+ */
+typedef enum {
+    SSD1306_UI_TEXT, ///< Texto fixo
+    SSD1306_UI_RULE  ///< Linha horizontal de 1 pixel
+} ssd1306_ui_kind_t;
+
+/**
+ * @brief Elemento estático do modelo de um painel
+ */
+typedef struct {
+    ssd1306_ui_kind_t kind; ///< Tipo do elemento
+    uint8_t x;              ///< Posição horizontal
+    uint8_t y;              ///< Posição vertical
+    uint8_t w;              ///< Largura da linha (ignorado para texto)
+    const char *text;       ///< Texto (ignorado para linha)
+} ssd1306_ui_static_t;
+
+/**
+ * @brief Campo de valor com caixa de tamanho fixo
+ */
+typedef struct {
+    uint8_t x;         ///< Posição horizontal da caixa
+    uint8_t y;         ///< Posição vertical da caixa
+    uint8_t max_chars; ///< Largura da caixa em caracteres (até SSD1306_UI_FIELD_MAX_CHARS)
+    char text[SSD1306_UI_FIELD_MAX_CHARS + 1]; ///< Texto atualmente desenhado
+} ssd1306_ui_field_t;
+
+/**
+ * @brief Painel: modelo estático + campos de valor
+ */
+typedef struct {
+    const ssd1306_ui_static_t *items; ///< Elementos estáticos
+    uint8_t item_count;               ///< Número de elementos estáticos
+    ssd1306_ui_field_t *fields;       ///< Campos de valor
+    uint8_t field_count;              ///< Número de campos
+} ssd1306_ui_panel_t;
+
+/**
+ * @brief Limpa o buffer e desenha o modelo estático do painel
+ *
+ * Os campos são esvaziados e passam a ser redesenhados na próxima atribuição.
+ *
+ * @param display Ponteiro para a estrutura do display inicializada
+ * @param panel Painel a exibir
+ */
+void ssd1306_ui_panel_show(ssd1306_t *display, ssd1306_ui_panel_t *panel);
+
+/**
+ * @brief Atualiza o texto de um campo
+ *
+ * Só toca no buffer se o texto mudou: limpa a caixa do campo e desenha o novo
+ * texto, truncado em max_chars caracteres.
+ *
+ * @param display Ponteiro para a estrutura do display inicializada
+ * @param field Campo a atualizar
+ * @param text Novo texto
+ * @return true se o campo foi redesenhado
+ */
+bool ssd1306_ui_field_set(ssd1306_t *display, ssd1306_ui_field_t *field, const char *text);
+
+#endif // SSD1306_UI_H